@@ -0,0 +1,401 @@
+// benchmarks/bench_core.hpp — shared config, pinning, throughput and latency run loops
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "latency_histogram.hpp"
+#include "profile.hpp"
+#include "ring/affinity.hpp"
+#include "ring/backoff.hpp"
+#include "ring/stats.hpp"
+
+namespace bench {
+
+inline void pause_hint() { ring::cpu_relax(); }
+
+using SteadyClock = std::chrono::steady_clock;
+
+inline std::uint64_t parse_u64(const char* s, std::uint64_t def) {
+    if (!s) return def;
+    char* end = nullptr;
+    unsigned long long v = std::strtoull(s, &end, 10);
+    return (end && *end == '\0') ? static_cast<std::uint64_t>(v) : def;
+}
+
+struct BenchCfg {
+    std::uint64_t items_per_producer;
+    int           producers;
+    int           consumers;
+    std::uint64_t capacity;
+    int           batch;
+    std::uint64_t minutes;
+    std::vector<unsigned> cpus; // thread k runs on cpus[k % size]; empty = unpinned
+    bool          latency = false; // end-to-end latency mode (measure_latency)
+    std::uint64_t rate    = 0;     // latency mode: ops/s per producer, 0 = as fast as possible
+    bool          profile = false; // throughput run + TSC samples and hardware counters (profile.hpp)
+};
+
+inline void pin_to_core(const BenchCfg& cfg, unsigned thread_index) {
+    if (!cfg.cpus.empty()) ring::pin_current_thread(cfg.cpus[thread_index % cfg.cpus.size()]);
+}
+
+// Bytes-sized trivially copyable item; the first 8 bytes carry the stamp.
+template <std::size_t Bytes>
+struct Payload {
+    static_assert(Bytes >= 8, "payload must hold the 8-byte timestamp");
+    std::uint64_t stamp;
+    std::byte     fill[Bytes - 8];
+};
+
+template <>
+struct Payload<8> {
+    std::uint64_t stamp;
+};
+
+struct RunResult {
+    double           secs = 0.0;
+    std::uint64_t    ops  = 0;
+    LatencyHistogram latency;                // measure_latency: enqueue->dequeue, ns
+    std::vector<std::uint32_t> probe;        // measure_throughput: sampled try_dequeue times (ns; TSC ticks with cfg.profile)
+    std::optional<ring::RingStatsSnapshot> stats; // measure_throughput on queues built with RingStats
+
+    double mops() const noexcept { return secs > 0.0 ? static_cast<double>(ops) / secs / 1e6 : 0.0; }
+};
+
+// Both runs build their queue here. Queues with per-producer lanes
+// (ring::FanInRing) are built from the producer count (capacity is then
+// per producer) and written through producer(p); every other queue is one
+// shared ring.
+template <class Queue>
+std::unique_ptr<Queue> make_queue(const BenchCfg& cfg) {
+    if constexpr (requires { Queue::per_producer_lanes; }) {
+        return std::make_unique<Queue>(static_cast<std::size_t>(cfg.producers), static_cast<std::size_t>(cfg.capacity));
+    } else {
+        return std::make_unique<Queue>(static_cast<std::size_t>(cfg.capacity));
+    }
+}
+
+template <class Queue>
+decltype(auto) producer_side(Queue& q, int p) {
+    if constexpr (requires { Queue::per_producer_lanes; }) return q.producer(static_cast<std::size_t>(p));
+    else return (q);
+}
+
+// Item carrying sequence number / stamp v: the integer itself, or a
+// Payload with v in its stamp.
+template <class Item>
+Item make_item(std::uint64_t v) noexcept {
+    if constexpr (std::is_integral_v<Item>) {
+        return static_cast<Item>(v);
+    } else {
+        Item it{};
+        it.stamp = v;
+        return it;
+    }
+}
+
+// -------- Throughput run --------
+// Producers push their items through try_enqueue_many with an adaptive
+// batch (doubles when the ring pushes back, decays by one otherwise);
+// consumers drain with dequeue_many. Every 1024th empty poll times one
+// try_dequeue into a 4096-entry reservoir (RunResult::probe), read with
+// tsc_begin() / tsc_end() in profile mode. With minutes > 0 producers run
+// until the stopper clears go and consumers stop once all producers are
+// done and the ring has stayed empty for a while. counters, if given,
+// must be opened before the call so the threads inherit them; they are
+// started just before go and stopped after the joins.
+template <class Queue, class Item>
+RunResult measure_throughput(const BenchCfg& cfg, PerfCounters* counters = nullptr) {
+    const std::uint64_t ITEMS_PER_PRODUCER = cfg.items_per_producer;
+    const int           NUM_PRODUCERS      = cfg.producers;
+    const int           NUM_CONSUMERS      = cfg.consumers;
+    const int           BATCH              = std::max(cfg.batch, 1);
+    const std::uint64_t MINUTES            = cfg.minutes;
+
+    const std::unique_ptr<Queue> queue = make_queue<Queue>(cfg);
+    Queue& q = *queue;
+
+    std::atomic<bool> go{false};
+    std::atomic<int>  producers_done{0};
+
+    const std::uint64_t TOTAL_ITEMS = ITEMS_PER_PRODUCER * static_cast<std::uint64_t>(NUM_PRODUCERS);
+    std::atomic<std::uint64_t> consumed{0};
+
+    std::atomic<std::uint64_t> lat_samples_count{0};
+    constexpr std::size_t LAT_RESERVOIR = 4096;
+    std::vector<std::uint32_t> lat_ns(LAT_RESERVOIR);
+    if (cfg.profile) (void)tsc_info(); // calibrate before the clock starts
+
+    // -------- Producers --------
+    std::vector<std::thread> producers;
+    producers.reserve(static_cast<std::size_t>(NUM_PRODUCERS));
+    for (int p = 0; p < NUM_PRODUCERS; ++p) {
+        producers.emplace_back([&, p] {
+            pin_to_core(cfg, static_cast<unsigned>(p));
+            auto& tx = producer_side(q, p);
+            while (!go.load(std::memory_order_acquire)) {}
+
+            const std::uint64_t base = static_cast<std::uint64_t>(p) * ITEMS_PER_PRODUCER;
+            std::vector<Item> buf; buf.reserve(static_cast<std::size_t>(BATCH));
+            std::size_t placed = 0;
+            int adaptive_batch = BATCH;
+            const int MIN_B = 8, MAX_B = 256;
+
+            auto flush = [&]() {
+                int spins = 0;
+                while (placed < buf.size()) {
+                    placed += tx.try_enqueue_many(buf.data() + placed, buf.size() - placed);
+                    if (placed < buf.size()) {
+                        if (++spins < 200) pause_hint();
+                        else { std::this_thread::yield(); spins = 0; }
+                    }
+                }
+                buf.clear();
+                placed = 0;
+            };
+
+            auto push = [&]() {
+                const std::size_t did = tx.try_enqueue_many(buf.data(), buf.size());
+                if (did < buf.size())            adaptive_batch = std::min(adaptive_batch * 2, MAX_B); // grow fast
+                else if (adaptive_batch > MIN_B) adaptive_batch -= 1;                                  // decay slow
+                placed = did;
+                if (placed < buf.size()) flush(); else buf.clear();
+            };
+
+            if (MINUTES == 0) {
+                for (std::uint64_t i = 0; i < ITEMS_PER_PRODUCER; ++i) {
+                    buf.push_back(make_item<Item>(base + i));
+                    if (static_cast<int>(buf.size()) >= adaptive_batch) push();
+                }
+                if (!buf.empty()) push();
+            } else {
+                // stress mode: keep producing until 'go' becomes false
+                std::uint64_t i = 0;
+                while (go.load(std::memory_order_acquire)) {
+                    buf.push_back(make_item<Item>(base + (i++)));
+                    if (static_cast<int>(buf.size()) >= adaptive_batch) push();
+                }
+                if (!buf.empty()) (void)tx.enqueue_many(buf.data(), buf.size());
+            }
+            producers_done.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    // -------- Consumers --------
+    std::vector<std::thread> consumers;
+    consumers.reserve(static_cast<std::size_t>(NUM_CONSUMERS));
+    for (int c = 0; c < NUM_CONSUMERS; ++c) {
+        consumers.emplace_back([&, c] {
+            pin_to_core(cfg, static_cast<unsigned>(NUM_PRODUCERS + c));
+            while (!go.load(std::memory_order_acquire)) {}
+
+            std::vector<Item> outbuf(static_cast<std::size_t>(BATCH));
+            std::uint64_t sample_token = 0;
+            int empty_streak = 0;                   // consecutive empty polls
+            const int EMPTY_STREAK_LIMIT = 2000;
+
+            for (;;) {
+                const std::size_t got = q.dequeue_many(outbuf.data(), static_cast<std::size_t>(BATCH));
+                if (got) {
+                    empty_streak = 0;
+                    const auto prev = consumed.fetch_add(got, std::memory_order_relaxed) + got;
+                    if (MINUTES == 0 && prev >= TOTAL_ITEMS) break;
+                    continue;
+                }
+
+                // latency sample (attempt single-item occasionally)
+                if ((++sample_token & 0x3FFu) == 0u) {
+                    Item x{};
+                    bool ok;
+                    std::uint64_t ns;
+                    if (cfg.profile) {
+                        const std::uint64_t c0 = tsc_begin();
+                        ok = q.try_dequeue(x);
+                        ns = tsc_end() - c0;
+                    } else {
+                        const auto t0 = SteadyClock::now();
+                        ok = q.try_dequeue(x);
+                        const auto t1 = SteadyClock::now();
+                        ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+                    }
+                    if (ok) {
+                        empty_streak = 0;
+                        const std::uint64_t idx = lat_samples_count.fetch_add(1, std::memory_order_relaxed);
+                        if (idx < LAT_RESERVOIR) lat_ns[static_cast<std::size_t>(idx)] = static_cast<std::uint32_t>(ns);
+
+                        const auto prev = consumed.fetch_add(1, std::memory_order_relaxed) + 1;
+                        if (MINUTES == 0 && prev >= TOTAL_ITEMS) break;
+                        continue;
+                    }
+                }
+
+                if (MINUTES == 0) {
+                    if (consumed.load(std::memory_order_relaxed) >= TOTAL_ITEMS) break;
+                } else {
+                    // Stress-mode termination: all producers done and the
+                    // queue seen empty for a while.
+                    if (producers_done.load(std::memory_order_acquire) == NUM_PRODUCERS) {
+                        if (++empty_streak >= EMPTY_STREAK_LIMIT) break;
+                    } else {
+                        empty_streak = 0;
+                    }
+                }
+                pause_hint();
+            }
+        });
+    }
+
+    // -------- Start & timing --------
+    if (counters) counters->start();
+    const auto t0 = SteadyClock::now();
+    go.store(true, std::memory_order_release);
+
+    std::thread stopper;
+    if (MINUTES > 0) {
+        stopper = std::thread([&]() {
+            std::this_thread::sleep_for(std::chrono::minutes(MINUTES));
+            go.store(false, std::memory_order_release);
+        });
+    }
+    for (auto& th : producers) th.join();
+    for (auto& th : consumers) th.join();
+    if (stopper.joinable()) stopper.join();
+    const auto t1 = SteadyClock::now();
+    if (counters) counters->stop();
+
+    RunResult r;
+    r.secs = std::chrono::duration<double>(t1 - t0).count();
+    r.ops  = (MINUTES == 0) ? TOTAL_ITEMS : consumed.load(std::memory_order_relaxed);
+    lat_ns.resize(static_cast<std::size_t>(std::min<std::uint64_t>(lat_samples_count.load(std::memory_order_relaxed), LAT_RESERVOIR)));
+    r.probe = std::move(lat_ns);
+    if constexpr (requires { Queue::stats_type::enabled; }) {
+        if constexpr (Queue::stats_type::enabled) r.stats = q.stats();
+    }
+    return r;
+}
+
+// -------- End-to-end latency run --------
+// Producers stamp each item with a steady_clock timestamp (ns since start);
+// consumers record dequeue time minus stamp into per-thread histograms that
+// are merged at the end, so the numbers include queueing delay. With a
+// fixed rate the stamp is the item's *scheduled* send time: a producer
+// that falls behind (full ring, preemption) sends late items back to back
+// but still charges them from their schedule, which corrects for
+// coordinated omission. Open-loop runs read the clock once per batch.
+template <class Queue, class Item>
+RunResult measure_latency(const BenchCfg& cfg) {
+    const std::uint64_t TOTAL_ITEMS = cfg.items_per_producer * static_cast<std::uint64_t>(cfg.producers);
+    const std::size_t   BATCH       = static_cast<std::size_t>(std::max(cfg.batch, 1));
+
+    const std::unique_ptr<Queue> queue = make_queue<Queue>(cfg);
+    Queue& q = *queue;
+    std::atomic<bool> go{false};
+    std::atomic<int>  producers_done{0};
+    std::atomic<std::uint64_t> consumed{0};
+    std::vector<LatencyHistogram> hist(static_cast<std::size_t>(cfg.consumers));
+
+    const auto t_base = SteadyClock::now();
+    auto now_ns = [&]() -> std::uint64_t {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now() - t_base).count());
+    };
+
+    auto put = [&](auto& tx, const Item* data, std::size_t n) {
+        std::size_t placed = 0;
+        int spins = 0;
+        while (placed < n) {
+            placed += tx.try_enqueue_many(data + placed, n - placed);
+            if (placed < n) {
+                if (++spins < 200) pause_hint();
+                else { std::this_thread::yield(); spins = 0; }
+            }
+        }
+    };
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < cfg.producers; ++p) {
+        producers.emplace_back([&, p] {
+            pin_to_core(cfg, static_cast<unsigned>(p));
+            auto& tx = producer_side(q, p);
+            while (!go.load(std::memory_order_acquire)) {}
+
+            std::vector<Item> buf(BATCH, Item{});
+            const bool finite = cfg.minutes == 0;
+            if (cfg.rate == 0) {
+                for (std::uint64_t i = 0; (finite ? i < cfg.items_per_producer : go.load(std::memory_order_relaxed)); ) {
+                    const std::size_t n = finite ? static_cast<std::size_t>(std::min<std::uint64_t>(BATCH, cfg.items_per_producer - i)) : BATCH;
+                    const std::uint64_t ts = now_ns();
+                    for (std::size_t k = 0; k < n; ++k) buf[k].stamp = ts;
+                    put(tx, buf.data(), n);
+                    i += n;
+                }
+            } else {
+                const double period_ns = 1e9 / static_cast<double>(cfg.rate);
+                const std::uint64_t start = now_ns();
+                for (std::uint64_t i = 0; (finite ? i < cfg.items_per_producer : go.load(std::memory_order_relaxed)); ++i) {
+                    buf[0].stamp = start + static_cast<std::uint64_t>(static_cast<double>(i) * period_ns);
+                    while (now_ns() < buf[0].stamp) pause_hint();
+                    put(tx, buf.data(), 1);
+                }
+            }
+            producers_done.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < cfg.consumers; ++c) {
+        consumers.emplace_back([&, c] {
+            pin_to_core(cfg, static_cast<unsigned>(cfg.producers + c));
+            while (!go.load(std::memory_order_acquire)) {}
+
+            LatencyHistogram& h = hist[static_cast<std::size_t>(c)];
+            std::vector<Item> out(BATCH, Item{});
+            int spins = 0;
+            for (;;) {
+                const std::size_t got = q.dequeue_many(out.data(), BATCH);
+                if (got) {
+                    const std::uint64_t t = now_ns();
+                    for (std::size_t i = 0; i < got; ++i) h.record(t > out[i].stamp ? t - out[i].stamp : 0);
+                    consumed.fetch_add(got, std::memory_order_relaxed);
+                    spins = 0;
+                    continue;
+                }
+                if (producers_done.load(std::memory_order_acquire) == cfg.producers && q.size() == 0) break;
+                if (cfg.minutes == 0 && consumed.load(std::memory_order_relaxed) >= TOTAL_ITEMS) break;
+                if (++spins < 200) pause_hint();
+                else { std::this_thread::yield(); spins = 0; }
+            }
+        });
+    }
+
+    const auto t0 = SteadyClock::now();
+    go.store(true, std::memory_order_release);
+    std::thread stopper;
+    if (cfg.minutes > 0) {
+        stopper = std::thread([&]() {
+            std::this_thread::sleep_for(std::chrono::minutes(cfg.minutes));
+            go.store(false, std::memory_order_release);
+        });
+    }
+    for (auto& th : producers) th.join();
+    for (auto& th : consumers) th.join();
+    if (stopper.joinable()) stopper.join();
+
+    RunResult r;
+    r.secs = std::chrono::duration<double>(SteadyClock::now() - t0).count();
+    r.ops  = consumed.load(std::memory_order_relaxed);
+    for (const auto& h : hist) r.latency.merge(h);
+    return r;
+}
+
+} // namespace bench
@@ -0,0 +1,277 @@
+// benchmarks/bench_matrix.cpp — parameter sweep over bench_core runs, CSV/JSON output
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_core.hpp"
+#include "ring/affinity.hpp"
+#include "ring/fan_in.hpp"
+#include "ring/linked_ring.hpp"
+#include "ring/ring_mpmc.hpp"
+#include "ring/ring_spsc.hpp"
+
+// Usage: bench_matrix [--option value]...
+//   --producers  1,2,4    --consumers 1..8   (lists, or a..b = powers of two from a to b)
+//   --capacity   1024,16384   --batch 1,32   --payload 8,64 (bytes: 8|16|32|64|128|256)
+//   --queue      mpmc,spsc,linked,fanin (linked: capacity = segment size,
+//                fanin: capacity = per producer lane)   --layout padded,packed,split
+//   --items      items per producer per run (default 1000000)
+//   --reps       measured runs per cell (default 5)   --warmup discarded runs (default 1)
+//   --mode       throughput|latency (default throughput)
+//   --rate       latency mode: ops/s per producer, 0 = as fast as possible (default 0)
+//   --pin        os|spread|compact|none (default os)
+//   --format     csv|json (default csv)   --out file (default stdout)
+//
+// Throughput cells are bench::measure_throughput runs, the bench_throughput
+// loop. Latency cells are bench::measure_latency runs, so throughput and
+// enqueue->dequeue latency come from the same runs; only they report
+// latency percentiles. SPSC cells other than 1P/1C and fan-in cells with
+// more than one consumer are skipped. Progress goes to stderr.
+
+namespace {
+
+struct Cell {
+    std::string   queue;
+    std::string   layout;
+    int           producers;
+    int           consumers;
+    std::uint64_t capacity;
+    int           batch;
+    std::uint64_t payload;
+};
+
+struct CellResult {
+    Cell   cell;
+    int    reps = 0;
+    double mops_mean = 0, mops_stddev = 0, mops_min = 0, mops_max = 0;
+    bench::LatencyHistogram latency; // merged over the measured reps
+};
+
+std::vector<std::uint64_t> parse_range(const std::string& s) {
+    std::vector<std::uint64_t> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        const auto dots = item.find("..");
+        if (dots == std::string::npos) {
+            out.push_back(std::strtoull(item.c_str(), nullptr, 10));
+            continue;
+        }
+        const std::uint64_t lo = std::strtoull(item.substr(0, dots).c_str(), nullptr, 10);
+        const std::uint64_t hi = std::strtoull(item.substr(dots + 2).c_str(), nullptr, 10);
+        for (std::uint64_t v = std::max<std::uint64_t>(lo, 1); v <= hi; v *= 2) out.push_back(v);
+    }
+    return out;
+}
+
+std::vector<std::string> parse_list(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+template <class T, class L> using MPMC = ring::RingMPMC<T, L>;
+template <class T, class L> using SPSC = ring::RingSPSC<T, L>;
+template <class T, class L> using Linked = ring::LinkedRingMPMC<T, L>;
+template <class T, class L> using FanIn  = ring::FanInRing<T, L>;
+
+using Runner = bench::RunResult (*)(const bench::BenchCfg&);
+
+template <class Queue, class Item>
+bench::RunResult throughput_run(const bench::BenchCfg& cfg) { return bench::measure_throughput<Queue, Item>(cfg); }
+
+template <class Queue, class Item>
+Runner runner(bool latency) {
+    return latency ? &bench::measure_latency<Queue, Item> : &throughput_run<Queue, Item>;
+}
+
+template <template <class, class> class Ring, class Layout>
+Runner pick_payload(std::uint64_t bytes, bool latency) {
+    switch (bytes) {
+        case 8:   return runner<Ring<bench::Payload<8>,   Layout>, bench::Payload<8>>(latency);
+        case 16:  return runner<Ring<bench::Payload<16>,  Layout>, bench::Payload<16>>(latency);
+        case 32:  return runner<Ring<bench::Payload<32>,  Layout>, bench::Payload<32>>(latency);
+        case 64:  return runner<Ring<bench::Payload<64>,  Layout>, bench::Payload<64>>(latency);
+        case 128: return runner<Ring<bench::Payload<128>, Layout>, bench::Payload<128>>(latency);
+        case 256: return runner<Ring<bench::Payload<256>, Layout>, bench::Payload<256>>(latency);
+        default:  return nullptr;
+    }
+}
+
+template <template <class, class> class Ring>
+Runner pick_layout(const std::string& layout, std::uint64_t bytes, bool latency) {
+    if (layout == ring::PaddedLayout::name) return pick_payload<Ring, ring::PaddedLayout>(bytes, latency);
+    if (layout == ring::PackedLayout::name) return pick_payload<Ring, ring::PackedLayout>(bytes, latency);
+    if (layout == ring::SplitLayout::name)  return pick_payload<Ring, ring::SplitLayout>(bytes, latency);
+    return nullptr;
+}
+
+Runner pick(const Cell& c, bool latency) {
+    if (c.queue == "mpmc") return pick_layout<MPMC>(c.layout, c.payload, latency);
+    if (c.queue == "spsc") return pick_layout<SPSC>(c.layout, c.payload, latency);
+    if (c.queue == "linked") return pick_layout<Linked>(c.layout, c.payload, latency);
+    if (c.queue == "fanin") return pick_layout<FanIn>(c.layout, c.payload, latency);
+    return nullptr;
+}
+
+// Latency columns / fields only for latency runs.
+void write_csv(std::ostream& os, const std::vector<CellResult>& rs, bool latency) {
+    os << "queue,layout,producers,consumers,capacity,batch,payload_bytes,reps,"
+          "mops_mean,mops_stddev,mops_min,mops_max"
+       << (latency ? ",p50_ns,p99_ns,p999_ns,p9999_ns,max_ns" : "") << '\n';
+    os << std::fixed << std::setprecision(3);
+    for (const auto& r : rs) {
+        const Cell& c = r.cell;
+        os << c.queue << ',' << c.layout << ',' << c.producers << ',' << c.consumers << ',' << c.capacity << ','
+           << c.batch << ',' << c.payload << ',' << r.reps << ','
+           << r.mops_mean << ',' << r.mops_stddev << ',' << r.mops_min << ',' << r.mops_max;
+        if (latency) {
+            os << ',' << r.latency.percentile(50) << ',' << r.latency.percentile(99) << ',' << r.latency.percentile(99.9) << ','
+               << r.latency.percentile(99.99) << ',' << r.latency.max();
+        }
+        os << '\n';
+    }
+}
+
+void write_json(std::ostream& os, const std::vector<CellResult>& rs, bool latency) {
+    os << "[\n" << std::fixed << std::setprecision(3);
+    for (std::size_t i = 0; i < rs.size(); ++i) {
+        const CellResult& r = rs[i];
+        const Cell& c = r.cell;
+        os << "  {\"queue\": \"" << c.queue << "\", \"layout\": \"" << c.layout << "\", \"producers\": " << c.producers
+           << ", \"consumers\": " << c.consumers << ", \"capacity\": " << c.capacity << ", \"batch\": " << c.batch
+           << ", \"payload_bytes\": " << c.payload << ", \"reps\": " << r.reps
+           << ", \"mops\": {\"mean\": " << r.mops_mean << ", \"stddev\": " << r.mops_stddev
+           << ", \"min\": " << r.mops_min << ", \"max\": " << r.mops_max << "}";
+        if (latency) {
+            os << ", \"latency_ns\": {\"p50\": " << r.latency.percentile(50) << ", \"p99\": " << r.latency.percentile(99)
+               << ", \"p99.9\": " << r.latency.percentile(99.9) << ", \"p99.99\": " << r.latency.percentile(99.99)
+               << ", \"max\": " << r.latency.max() << "}";
+        }
+        os << "}" << (i + 1 < rs.size() ? "," : "") << "\n";
+    }
+    os << "]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string producers = "1,2,4", consumers = "1,2,4", capacity = "16384", batch = "32", payload = "8";
+    std::string queues = "mpmc", layouts = "padded", pin = "os", format = "csv", mode = "throughput", out_path;
+    std::uint64_t items = 1'000'000, reps = 5, warmup = 1, rate = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string key = argv[i];
+        if (i + 1 >= argc) { std::cerr << "missing value for " << key << "\n"; return 2; }
+        const std::string val = argv[++i];
+        if      (key == "--producers") producers = val;
+        else if (key == "--consumers") consumers = val;
+        else if (key == "--capacity")  capacity  = val;
+        else if (key == "--batch")     batch     = val;
+        else if (key == "--payload")   payload   = val;
+        else if (key == "--queue")     queues    = val;
+        else if (key == "--layout")    layouts   = val;
+        else if (key == "--items")     items     = bench::parse_u64(val.c_str(), items);
+        else if (key == "--reps")      reps      = std::max<std::uint64_t>(bench::parse_u64(val.c_str(), reps), 1);
+        else if (key == "--warmup")    warmup    = bench::parse_u64(val.c_str(), warmup);
+        else if (key == "--mode")      mode      = val;
+        else if (key == "--rate")      rate      = bench::parse_u64(val.c_str(), rate);
+        else if (key == "--pin")       pin       = val;
+        else if (key == "--format")    format    = val;
+        else if (key == "--out")       out_path  = val;
+        else { std::cerr << "unknown option " << key << "\n"; return 2; }
+    }
+    if (format != "csv" && format != "json") {
+        std::cerr << "unknown format '" << format << "' (expected csv|json)\n";
+        return 2;
+    }
+    if (mode != "throughput" && mode != "latency") {
+        std::cerr << "unknown mode '" << mode << "' (expected throughput|latency)\n";
+        return 2;
+    }
+
+    bench::BenchCfg base{};
+    base.items_per_producer = items;
+    base.minutes            = 0;
+    base.latency            = (mode == "latency");
+    base.rate               = rate;
+    const ring::Topology topo = ring::query_topology();
+    if      (pin == "os")      base.cpus = topo.order(ring::Placement::Os);
+    else if (pin == "spread")  base.cpus = topo.order(ring::Placement::Spread);
+    else if (pin == "compact") base.cpus = topo.order(ring::Placement::Compact);
+    else if (pin != "none") {
+        std::cerr << "unknown pin mode '" << pin << "' (expected os|spread|compact|none)\n";
+        return 2;
+    }
+
+    std::vector<Cell> cells;
+    for (const auto& q : parse_list(queues))
+    for (const auto& l : parse_list(layouts))
+    for (auto p : parse_range(producers))
+    for (auto c : parse_range(consumers))
+    for (auto cap : parse_range(capacity))
+    for (auto b : parse_range(batch))
+    for (auto pl : parse_range(payload)) {
+        if (q == "spsc" && (p != 1 || c != 1)) continue;
+        if (q == "fanin" && c != 1) continue;
+        cells.push_back({ q, l, static_cast<int>(p), static_cast<int>(c), cap, static_cast<int>(b), pl });
+    }
+
+    std::vector<CellResult> results;
+    for (std::size_t k = 0; k < cells.size(); ++k) {
+        const Cell& c = cells[k];
+        const Runner run = pick(c, base.latency);
+        if (!run) {
+            std::cerr << "skipping " << c.queue << '/' << c.layout << '/' << c.payload
+                      << "B: unknown queue, layout or payload size\n";
+            continue;
+        }
+        bench::BenchCfg cfg = base;
+        cfg.producers = c.producers;
+        cfg.consumers = c.consumers;
+        cfg.capacity  = c.capacity;
+        cfg.batch     = c.batch;
+
+        std::cerr << "[" << (k + 1) << "/" << cells.size() << "] " << c.queue << ' ' << c.layout << ' '
+                  << c.producers << "P/" << c.consumers << "C cap=" << c.capacity << " batch=" << c.batch
+                  << " payload=" << c.payload << "B\n";
+        for (std::uint64_t w = 0; w < warmup; ++w) (void)run(cfg);
+
+        CellResult r;
+        r.cell = c;
+        std::vector<double> mops;
+        for (std::uint64_t i = 0; i < reps; ++i) {
+            const bench::RunResult one = run(cfg);
+            mops.push_back(one.mops());
+            r.latency.merge(one.latency);
+        }
+        double sum = 0, sq = 0;
+        for (double m : mops) sum += m;
+        r.reps      = static_cast<int>(mops.size());
+        r.mops_mean = sum / static_cast<double>(mops.size());
+        for (double m : mops) sq += (m - r.mops_mean) * (m - r.mops_mean);
+        r.mops_stddev = mops.size() > 1 ? std::sqrt(sq / static_cast<double>(mops.size() - 1)) : 0.0;
+        r.mops_min    = *std::min_element(mops.begin(), mops.end());
+        r.mops_max    = *std::max_element(mops.begin(), mops.end());
+        results.push_back(std::move(r));
+    }
+
+    std::ofstream file;
+    if (!out_path.empty()) {
+        file.open(out_path);
+        if (!file) { std::cerr << "cannot open " << out_path << "\n"; return 1; }
+    }
+    std::ostream& os = out_path.empty() ? std::cout : file;
+    if (format == "csv") write_csv(os, results, base.latency); else write_json(os, results, base.latency);
+    return 0;
+}
@@ -0,0 +1,139 @@
+// benchmarks/bench_pool.cpp — pointer passing through a RingMPMC: std::make_unique vs ring::Pool
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bench_core.hpp"
+#include "ring/pool.hpp"
+#include "ring/ring_mpmc.hpp"
+
+// Args: [producers] [consumers] [items_per_producer] [reps]
+//   Producers hand consumers 512-byte messages by pointer through one
+//   RingMPMC<Message*> (capacity 1024), allocated three ways:
+//     make_unique  make_unique_for_overwrite in the producer, delete in the consumer
+//     pool         ring::Pool<Message> acquire / release
+//     pool-cache   the same through per-thread Pool::Cache (batch 32)
+//   Reports the best of reps runs (default 3) as messages/s, and heap
+//   allocations per message counted by the operator new below.
+
+// Counts every heap allocation in the process, threads included.
+static std::atomic<std::uint64_t> g_allocs{0};
+
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+struct Message {
+    std::uint64_t seq;
+    std::uint64_t words[63];
+};
+
+enum class Source { MakeUnique, Pool, PoolCache };
+
+struct Run {
+    double        secs   = 0;
+    std::uint64_t allocs = 0;
+};
+
+static Run run_once(Source src, int producers, int consumers, std::uint64_t items) {
+    const std::uint64_t total = items * static_cast<std::uint64_t>(producers);
+    constexpr std::size_t kCap = 1024, kBatch = 32;
+    ring::RingMPMC<Message*> q(kCap);
+    // Enough objects for a full ring plus what every cache can hold.
+    ring::Pool<Message> pool(kCap + static_cast<std::size_t>(producers + consumers) * 2 * kBatch + producers);
+    std::atomic<std::uint64_t> consumed{0}, sink{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> ts;
+    for (int p = 0; p < producers; ++p) {
+        ts.emplace_back([&] {
+            ring::Pool<Message>::Cache cache(pool, kBatch);
+            while (!go.load(std::memory_order_acquire)) bench::pause_hint();
+            for (std::uint64_t i = 0; i < items; ++i) {
+                Message* m = src == Source::MakeUnique ? std::make_unique_for_overwrite<Message>().release()
+                           : src == Source::Pool       ? pool.acquire()
+                                                       : cache.acquire();
+                m->seq = i;
+                m->words[62] = i;
+                q.enqueue(m);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        ts.emplace_back([&] {
+            ring::Pool<Message>::Cache cache(pool, kBatch);
+            Message* batch[kBatch];
+            std::uint64_t local = 0;
+            while (!go.load(std::memory_order_acquire)) bench::pause_hint();
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                const std::size_t n = q.dequeue_many(batch, kBatch);
+                if (n == 0) { bench::pause_hint(); continue; }
+                for (std::size_t k = 0; k < n; ++k) {
+                    Message* m = batch[k];
+                    local += m->seq + m->words[62];
+                    if (src == Source::MakeUnique) delete m;
+                    else if (src == Source::Pool)  pool.release(m);
+                    else                           cache.release(m);
+                }
+                consumed.fetch_add(n, std::memory_order_relaxed);
+            }
+            sink.fetch_add(local, std::memory_order_relaxed);
+        });
+    }
+
+    const std::uint64_t a0 = g_allocs.load();
+    const auto t0 = bench::SteadyClock::now();
+    go.store(true, std::memory_order_release);
+    for (int p = 0; p < producers; ++p) ts[static_cast<std::size_t>(p)].join();
+    while (consumed.load() < total) bench::pause_hint();
+    const auto t1 = bench::SteadyClock::now();
+    const std::uint64_t a1 = g_allocs.load();
+    for (std::size_t t = static_cast<std::size_t>(producers); t < ts.size(); ++t) ts[t].join();
+
+    if (sink.load() != total * (items - 1)) std::cerr << "checksum mismatch\n";
+    return { std::chrono::duration<double>(t1 - t0).count(), a1 - a0 };
+}
+
+int main(int argc, char** argv) {
+    const int           producers = static_cast<int>(std::max<std::uint64_t>(bench::parse_u64(argc > 1 ? argv[1] : nullptr, 2), 1));
+    const int           consumers = static_cast<int>(std::max<std::uint64_t>(bench::parse_u64(argc > 2 ? argv[2] : nullptr, 2), 1));
+    const std::uint64_t items     = std::max<std::uint64_t>(bench::parse_u64(argc > 3 ? argv[3] : nullptr, 1000000), 1);
+    const std::uint64_t reps      = std::max<std::uint64_t>(bench::parse_u64(argc > 4 ? argv[4] : nullptr, 3), 1);
+
+    std::cout << "Pointer-passing benchmark: " << producers << "P / " << consumers << "C, "
+              << items << " x " << sizeof(Message) << "-byte messages per producer, best of " << reps << "\n"
+              << "  " << std::left << std::setw(12) << "source" << std::right
+              << std::setw(12) << "secs" << std::setw(12) << "Mmsg/s" << std::setw(14) << "allocs/msg" << "\n";
+
+    const std::pair<Source, const char*> sources[] = {
+        { Source::MakeUnique, "make_unique" }, { Source::Pool, "pool" }, { Source::PoolCache, "pool-cache" },
+    };
+    const double msgs = static_cast<double>(items) * producers;
+    for (const auto& [src, name] : sources) {
+        Run best;
+        best.secs = 1e300;
+        for (std::uint64_t r = 0; r < reps; ++r) {
+            const Run run = run_once(src, producers, consumers, items);
+            if (run.secs < best.secs) best = run;
+        }
+        std::cout << "  " << std::left << std::setw(12) << name << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(4) << best.secs
+                  << std::setw(12) << std::setprecision(2) << msgs / best.secs / 1e6
+                  << std::setw(14) << std::setprecision(3) << static_cast<double>(best.allocs) / msgs << "\n";
+    }
+    return 0;
+}
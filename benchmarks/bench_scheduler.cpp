@@ -0,0 +1,158 @@
+// benchmarks/bench_scheduler.cpp — work-stealing Scheduler vs one shared RingMPMC task queue
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_core.hpp"
+#include "ring/ring_mpmc.hpp"
+#include "ring/scheduler.hpp"
+
+// Args: [max_workers] [fib_n] [fanout_tasks] [reps]
+//   Runs both pools at 1, 2, 4, ... max_workers workers (default: hardware threads) on
+//   fork/join: parallel fib(fib_n), one task per call (default 25)
+//   fan-out:   one root task spawns fanout_tasks small leaf tasks and joins them (default 200000)
+// and reports the best of reps runs (default 3) as tasks/s.
+
+// Baseline: every worker pushes to and pops from one shared ring, so all
+// task traffic goes through the same head_/tail_ CAS pair. Same Task and
+// TaskGroup machinery as ring::Scheduler.
+class SharedRingPool {
+public:
+    SharedRingPool(unsigned workers, std::size_t capacity) : q_(capacity) {
+        for (unsigned i = 0; i < workers; ++i) threads_.emplace_back([this] { worker_loop(); });
+    }
+
+    ~SharedRingPool() {
+        stop_.store(true, std::memory_order_release);
+        for (auto& t : threads_) t.join();
+    }
+
+    template <class F>
+    void spawn(ring::TaskGroup& g, F&& f) {
+        g.add();
+        ring::Task* t = ring::detail::make_task([&g, fn = std::forward<F>(f)]() mutable { fn(); g.finish(); });
+        if (!q_.try_enqueue(t)) t->invoke(t); // ring full: run inline rather than block a worker
+    }
+
+    void wait(ring::TaskGroup& g) noexcept {
+        int spins = 0;
+        while (!g.done()) {
+            ring::Task* t = nullptr;
+            if (q_.try_dequeue(t)) { t->invoke(t); spins = 0; continue; }
+            if (++spins < 64) bench::pause_hint();
+            else { std::this_thread::yield(); spins = 0; }
+        }
+    }
+
+private:
+    void worker_loop() noexcept {
+        int spins = 0;
+        for (;;) {
+            ring::Task* t = nullptr;
+            if (q_.try_dequeue(t)) { t->invoke(t); spins = 0; continue; }
+            if (stop_.load(std::memory_order_acquire)) break;
+            if (++spins < 64) { bench::pause_hint(); continue; }
+            spins = 0;
+            if (q_.dequeue_for(t, std::chrono::milliseconds(1))) t->invoke(t);
+        }
+    }
+
+    ring::RingMPMC<ring::Task*> q_;
+    std::atomic<bool> stop_{false};
+    std::vector<std::thread> threads_;
+};
+
+template <class Pool>
+static std::uint64_t fib(Pool& pool, int n, std::atomic<std::uint64_t>& tasks) {
+    tasks.fetch_add(1, std::memory_order_relaxed);
+    if (n < 2) return static_cast<std::uint64_t>(n);
+    std::uint64_t a = 0;
+    ring::TaskGroup g;
+    pool.spawn(g, [&] { a = fib(pool, n - 1, tasks); });
+    const std::uint64_t b = fib(pool, n - 2, tasks);
+    pool.wait(g);
+    return a + b;
+}
+
+static std::uint64_t leaf_work(std::uint64_t x) {
+    for (int i = 0; i < 64; ++i) x = x * 6364136223846793005ull + 1442695040888963407ull;
+    return x;
+}
+
+template <class Pool>
+static double run_fib(unsigned workers, int n, std::uint64_t& tasks_out) {
+    Pool pool(workers, 1u << 16);
+    std::atomic<std::uint64_t> tasks{0};
+    std::uint64_t result = 0;
+    ring::TaskGroup root;
+    const auto t0 = bench::SteadyClock::now();
+    pool.spawn(root, [&] { result = fib(pool, n, tasks); });
+    pool.wait(root);
+    const double secs = std::chrono::duration<double>(bench::SteadyClock::now() - t0).count();
+    if (result == 0 && n > 0) std::cerr << "fib failed\n";
+    tasks_out = tasks.load();
+    return secs;
+}
+
+template <class Pool>
+static double run_fanout(unsigned workers, std::uint64_t leaves, std::uint64_t& tasks_out) {
+    Pool pool(workers, 1u << 16);
+    std::atomic<std::uint64_t> sink{0};
+    ring::TaskGroup root;
+    const auto t0 = bench::SteadyClock::now();
+    pool.spawn(root, [&] {
+        ring::TaskGroup g;
+        for (std::uint64_t i = 0; i < leaves; ++i) {
+            pool.spawn(g, [&sink, i] { sink.fetch_add(leaf_work(i) & 1, std::memory_order_relaxed); });
+        }
+        pool.wait(g);
+    });
+    pool.wait(root);
+    const double secs = std::chrono::duration<double>(bench::SteadyClock::now() - t0).count();
+    tasks_out = leaves + 1;
+    return secs;
+}
+
+template <class Run>
+static void report(const char* workload, const char* pool, unsigned workers, std::uint64_t reps, Run&& run) {
+    double best = 1e300;
+    std::uint64_t tasks = 0;
+    for (std::uint64_t r = 0; r < reps; ++r) best = std::min(best, run(tasks));
+    std::cout << "  " << std::left << std::setw(10) << workload << std::setw(14) << pool << std::right
+              << std::setw(8) << workers << std::setw(12) << tasks
+              << std::setw(12) << std::fixed << std::setprecision(4) << best
+              << std::setw(14) << std::setprecision(2) << (best > 0 ? static_cast<double>(tasks) / best / 1e6 : 0.0) << "\n";
+}
+
+int main(int argc, char** argv) {
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw == 0) hw = 1;
+    const unsigned      max_workers = static_cast<unsigned>(bench::parse_u64(argc > 1 ? argv[1] : nullptr, hw));
+    const int           fib_n       = static_cast<int>(bench::parse_u64(argc > 2 ? argv[2] : nullptr, 25));
+    const std::uint64_t leaves      = bench::parse_u64(argc > 3 ? argv[3] : nullptr, 200000);
+    const std::uint64_t reps        = std::max<std::uint64_t>(bench::parse_u64(argc > 4 ? argv[4] : nullptr, 3), 1);
+
+    std::cout << "Scheduler benchmark: fib(" << fib_n << "), fan-out " << leaves << " leaves, best of " << reps << "\n"
+              << "  " << std::left << std::setw(10) << "workload" << std::setw(14) << "pool" << std::right
+              << std::setw(8) << "workers" << std::setw(12) << "tasks" << std::setw(12) << "secs"
+              << std::setw(14) << "Mtasks/s" << "\n";
+
+    std::vector<unsigned> counts;
+    for (unsigned w = 1; w < max_workers; w *= 2) counts.push_back(w);
+    counts.push_back(std::max(max_workers, 1u));
+
+    for (unsigned w : counts) {
+        report("fork/join", "work-stealing", w, reps, [&](std::uint64_t& t) { return run_fib<ring::Scheduler>(w, fib_n, t); });
+        report("fork/join", "shared-ring", w, reps, [&](std::uint64_t& t) { return run_fib<SharedRingPool>(w, fib_n, t); });
+        report("fan-out", "work-stealing", w, reps, [&](std::uint64_t& t) { return run_fanout<ring::Scheduler>(w, leaves, t); });
+        report("fan-out", "shared-ring", w, reps, [&](std::uint64_t& t) { return run_fanout<SharedRingPool>(w, leaves, t); });
+    }
+    return 0;
+}
@@ -1,235 +1,74 @@
 // benchmarks/bench_throughput.cpp — MSVC19-friendly, stress-mode exit fix
 
 #include <algorithm>
-#include <atomic>
-#include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <optional>
 #include <string>
-#include <thread>
 #include <vector>
 
+#include "bench_core.hpp"
+#include "profile.hpp"
+#include "ring/affinity.hpp"
+#include "ring/fan_in.hpp"
+#include "ring/linked_ring.hpp"
 #include "ring/ring_mpmc.hpp"
-
-#if defined(_WIN32)
-  // Prevent windows.h from defining min/max macros that break std::min/std::max
-  #ifndef NOMINMAX
-  #define NOMINMAX
-  #endif
-  #include <windows.h>
-  #include <immintrin.h>
-  static inline void pause_hint() { _mm_pause(); }
-  static inline void pin_to_core(DWORD core_index) {
-      DWORD_PTR mask = 1ull << (core_index % 64);
-      SetThreadAffinityMask(GetCurrentThread(), mask);
-  }
-#else
-  static inline void pause_hint() {}
-  static inline void pin_to_core(unsigned) {}
-#endif
-
-using SteadyClock = std::chrono::steady_clock;
-
-static std::uint64_t parse_u64(const char* s, std::uint64_t def) {
-    if (!s) return def;
-    char* end = nullptr;
-    unsigned long long v = std::strtoull(s, &end, 10);
-    return (end && *end == '\0') ? static_cast<std::uint64_t>(v) : def;
+#include "ring/ring_spsc.hpp"
+#include "ring/simd.hpp"
+
+using bench::BenchCfg;
+using bench::parse_u64;
+
+// Queues built with RingStats: claim contention per successful dequeue
+// batch (one scan pass each when no CAS is lost).
+static void print_contention(const ring::RingStatsSnapshot& s) {
+    std::uint64_t batches = 0;
+    for (std::uint64_t b : s.dequeue_batches) batches += b;
+    const double per = batches ? 1.0 / static_cast<double>(batches) : 0.0;
+    std::cout << "  dequeue batches:  " << batches << " (avg " << static_cast<double>(s.dequeued) * per << " items)\n"
+              << "  per batch: scans " << static_cast<double>(s.scans) * per
+              << ", tickets loaded " << static_cast<double>(s.scanned) * per
+              << ", cas retries " << static_cast<double>(s.cas_retries) * per << " (both sides)\n";
 }
 
-int main(int argc, char** argv) {
-    // Args: [items_per_producer] [num_producers] [num_consumers] [queue_capacity] [batch] [minutes]
-    const std::uint64_t ITEMS_PER_PRODUCER = parse_u64(argc > 1 ? argv[1] : nullptr, 1'000'000ULL);
-    const int           NUM_PRODUCERS      = static_cast<int>(parse_u64(argc > 2 ? argv[2] : nullptr, 2));
-    const int           NUM_CONSUMERS      = static_cast<int>(parse_u64(argc > 3 ? argv[3] : nullptr, 2));
-    const std::uint64_t CAPACITY           = parse_u64(argc > 4 ? argv[4] : nullptr, 1ULL << 14);
-    int                 BATCH              = static_cast<int>(parse_u64(argc > 5 ? argv[5] : nullptr, 32));
-    const std::uint64_t MINUTES            = parse_u64(argc > 6 ? argv[6] : nullptr, 0);
-
-    std::cout << "Benchmark config:\n"
-              << "  items_per_producer = " << ITEMS_PER_PRODUCER << "\n"
-              << "  producers          = " << NUM_PRODUCERS << "\n"
-              << "  consumers          = " << NUM_CONSUMERS << "\n"
-              << "  queue_capacity     = " << CAPACITY << "\n"
-              << "  batch              = " << BATCH << "\n"
-              << "  minutes (0=finite) = " << MINUTES << "\n";
-
-    ring::RingMPMC<std::uint32_t> q(static_cast<std::size_t>(CAPACITY));
-
-    std::atomic<bool> go{false};
-    std::atomic<int>  producers_done{0};     // <-- NEW: producer completion counter
-
-    const std::uint64_t TOTAL_ITEMS = ITEMS_PER_PRODUCER * static_cast<std::uint64_t>(NUM_PRODUCERS);
-    std::atomic<std::uint64_t> consumed{0};
-
-    // Latency reservoir (ns) for p50/p95/p99
-    std::atomic<uint64_t> lat_samples_count{0};
-    constexpr size_t LAT_RESERVOIR = 4096;
-    static std::vector<uint32_t> lat_ns; lat_ns.resize(LAT_RESERVOIR);
-
-    // -------- Producers --------
-    std::vector<std::thread> producers;
-    producers.reserve(NUM_PRODUCERS);
-    for (int p = 0; p < NUM_PRODUCERS; ++p) {
-        producers.emplace_back([&, p] {
-            pin_to_core(static_cast<DWORD>(p));
-            while (!go.load(std::memory_order_acquire)) {}
-
-            const std::uint64_t base = static_cast<std::uint64_t>(p) * ITEMS_PER_PRODUCER;
-            std::vector<std::uint32_t> buf; buf.reserve(static_cast<size_t>(BATCH));
-            std::size_t placed = 0;
-            int adaptive_batch = BATCH;                   // adaptive producer batch
-            const int MIN_B = 8, MAX_B = 256;
-
-            auto flush = [&]() {
-                while (placed < buf.size()) {
-                    const std::size_t want = buf.size() - placed;
-                    const std::size_t did  = q.enqueue_many(buf.data() + placed, want);
-                    placed += did;
-                    if (placed < buf.size()) pause_hint();
-                }
-                buf.clear();
-                placed = 0;
-            };
-
-            auto adapt = [&](std::size_t requested, std::size_t did) {
-                if (did < requested)       adaptive_batch = std::min(adaptive_batch * 2, MAX_B); // grow fast
-                else if (adaptive_batch > MIN_B) adaptive_batch -= 1;                             // decay slow
-            };
-
-            if (MINUTES == 0) {
-                for (std::uint64_t i = 0; i < ITEMS_PER_PRODUCER; ++i) {
-                    buf.push_back(static_cast<std::uint32_t>(base + i));
-                    if (static_cast<int>(buf.size()) == adaptive_batch) {
-                        std::size_t did = q.enqueue_many(buf.data(), buf.size());
-                        adapt(buf.size(), did);
-                        if (did < buf.size()) { placed = did; flush(); } else { buf.clear(); }
-                    }
-                }
-                if (!buf.empty()) {
-                    std::size_t did = q.enqueue_many(buf.data(), buf.size());
-                    adapt(buf.size(), did);
-                    placed = did;
-                    if (placed < buf.size()) flush(); else buf.clear();
-                }
-            } else {
-                // stress mode: keep producing until 'go' becomes false
-                std::uint64_t i = 0;
-                while (go.load(std::memory_order_acquire)) {
-                    buf.push_back(static_cast<std::uint32_t>(base + (i++)));
-                    if (static_cast<int>(buf.size()) == adaptive_batch) {
-                        std::size_t did = q.enqueue_many(buf.data(), buf.size());
-                        adapt(buf.size(), did);
-                        placed = did;
-                        if (placed < buf.size()) flush(); else buf.clear();
-                    }
-                }
-                if (!buf.empty()) {
-                    (void)q.enqueue_many(buf.data(), buf.size());
-                }
-            }
-
-            // mark this producer done
-            producers_done.fetch_add(1, std::memory_order_release);
-        });
-    }
-
-    // -------- Consumers --------
-    std::vector<std::thread> consumers;
-    consumers.reserve(NUM_CONSUMERS);
-    for (int c = 0; c < NUM_CONSUMERS; ++c) {
-        consumers.emplace_back([&, c] {
-            pin_to_core(static_cast<DWORD>(NUM_PRODUCERS + c));
-            while (!go.load(std::memory_order_acquire)) {}
-
-            std::vector<std::uint32_t> outbuf; outbuf.resize(static_cast<size_t>(BATCH));
-            uint64_t sample_token = 0;
-            int empty_streak = 0;                   // <-- NEW: consecutive empty polls
-            const int EMPTY_STREAK_LIMIT = 2000;    //     (tune if needed)
-
-            for (;;) {
-                const std::size_t got = q.dequeue_many(outbuf.data(), static_cast<std::size_t>(BATCH));
-                if (got) {
-                    empty_streak = 0;
-                    auto prev = consumed.fetch_add(got, std::memory_order_relaxed) + got;
-                    if (MINUTES == 0 && prev >= TOTAL_ITEMS) break;
-                    continue;
-                }
-
-                // latency sample (attempt single-item occasionally)
-                if ((++sample_token & 0x3FFu) == 0u) {
-                    std::uint32_t x{};
-                    auto t0 = SteadyClock::now();
-                    bool ok = q.try_dequeue(x);
-                    auto t1 = SteadyClock::now();
-                    if (ok) {
-                        empty_streak = 0;
-                        uint64_t ns = static_cast<uint64_t>(
-                            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
-                        uint64_t idx = lat_samples_count.fetch_add(1, std::memory_order_relaxed);
-                        if (idx < LAT_RESERVOIR) lat_ns[static_cast<size_t>(idx)] = static_cast<uint32_t>(ns);
-
-                        auto prev = consumed.fetch_add(1, std::memory_order_relaxed) + 1;
-                        if (MINUTES == 0 && prev >= TOTAL_ITEMS) break;
-                        continue;
-                    }
-                }
-
-                // Finite-run termination
-                if (MINUTES == 0) {
-                    if (consumed.load(std::memory_order_relaxed) >= TOTAL_ITEMS) break;
-                } else {
-                    // Stress-mode termination: if all producers are done and we’ve seen
-                    // the queue empty for a while, we can stop.
-                    if (producers_done.load(std::memory_order_acquire) == NUM_PRODUCERS) {
-                        if (++empty_streak >= EMPTY_STREAK_LIMIT) break;
-                    } else {
-                        empty_streak = 0;
-                    }
-                }
-
-                pause_hint();
-            }
-        });
-    }
-
-    // -------- Start & timing --------
-    auto t0 = SteadyClock::now();
-    go.store(true, std::memory_order_release);
-
-    std::thread stopper;
-    if (MINUTES > 0) {
-        stopper = std::thread([&]() {
-            std::this_thread::sleep_for(std::chrono::minutes(MINUTES));
-            go.store(false, std::memory_order_release);
-        });
+// Profile mode: counts over every thread of the run, per consumed item.
+static void print_profile(const bench::PerfCounters& pc, double ops) {
+    using PC = bench::PerfCounters;
+    const bench::TscInfo& tsc = bench::tsc_info();
+    std::cout << "Profile (user space, all threads):\n"
+              << "  tsc: " << tsc.ticks_per_ns << " GHz" << (tsc.invariant ? ", invariant" : ", NOT invariant") << "\n";
+    for (int e = 0; e < PC::kEvents; ++e) {
+        const auto ev = static_cast<PC::Event>(e);
+        std::cout << "  " << std::left << std::setw(18) << (std::string(PC::name(ev)) + "/op:") << std::right;
+        if (pc.available(ev)) std::cout << static_cast<double>(pc.value(ev)) / ops << "\n";
+        else                  std::cout << "unavailable\n";
     }
+    if (pc.available(PC::Cycles) && pc.available(PC::Instructions) && pc.value(PC::Cycles))
+        std::cout << "  IPC:              " << static_cast<double>(pc.value(PC::Instructions)) / static_cast<double>(pc.value(PC::Cycles)) << "\n";
+    if (!pc.error().empty()) std::cout << "  (" << pc.error() << ")\n";
+}
 
-    for (auto& th : producers) th.join();
-    for (auto& th : consumers)  th.join();
-    if (stopper.joinable()) stopper.join();
-    auto t1 = SteadyClock::now();
-
-    // -------- Results --------
-    const size_t nlat = static_cast<size_t>(
-        std::min<uint64_t>(lat_samples_count.load(std::memory_order_relaxed), LAT_RESERVOIR));
+// -------- Throughput / profile mode (measure_throughput in bench_core.hpp) --------
+template <class Queue>
+static int run_bench(const BenchCfg& cfg) {
+    // Opened before the threads exist so they inherit the counters.
+    std::optional<bench::PerfCounters> counters;
+    if (cfg.profile) counters.emplace();
 
-    const double secs = std::chrono::duration<double>(t1 - t0).count();
-    const double ops  = (MINUTES == 0)
-                        ? static_cast<double>(TOTAL_ITEMS)
-                        : static_cast<double>(consumed.load(std::memory_order_relaxed));
-    const double ops_per_s = (secs > 0.0) ? (ops / secs) : 0.0;
+    const bench::RunResult r = bench::measure_throughput<Queue, std::uint32_t>(cfg, counters ? &*counters : nullptr);
+    const double ops = static_cast<double>(r.ops);
 
     std::cout << std::fixed << std::setprecision(2);
     std::cout << "Results:\n"
-              << "  elapsed (s): " << secs << "\n"
+              << "  elapsed (s): " << r.secs << "\n"
               << "  total ops :  " << ops << "\n"
-              << "  throughput:  " << (ops_per_s / 1e6) << " Mops/s\n";
+              << "  throughput:  " << r.mops() << " Mops/s\n";
 
+    const std::size_t nlat = r.probe.size();
     if (nlat >= 8) {
-        std::vector<uint32_t> v(lat_ns.begin(), lat_ns.begin() + nlat);
+        std::vector<uint32_t> v = r.probe;
         auto pct = [&](double p) -> uint32_t {
             const double idxd = std::clamp((p / 100.0) * (nlat - 1.0), 0.0, static_cast<double>(nlat - 1));
             const size_t k = static_cast<size_t>(idxd);
@@ -237,8 +76,136 @@ int main(int argc, char** argv) {
             return v[k];
         };
         const auto p50 = pct(50), p95 = pct(95), p99 = pct(99);
-        std::cout << "  latency p50/p95/p99 (ns): " << p50 << " / " << p95 << " / " << p99 << "\n";
+        if (cfg.profile)
+            std::cout << "  try_dequeue p50/p95/p99 (tsc): " << p50 << " / " << p95 << " / " << p99 << " ticks = "
+                      << bench::tsc_to_ns(p50) << " / " << bench::tsc_to_ns(p95) << " / " << bench::tsc_to_ns(p99) << " ns\n";
+        else
+            std::cout << "  latency p50/p95/p99 (ns): " << p50 << " / " << p95 << " / " << p99 << "\n";
     }
+    if (r.stats) print_contention(*r.stats);
+    if (counters) print_profile(*counters, ops);
+
+    return 0;
+}
+
+// -------- End-to-end latency mode (measure_latency in bench_core.hpp) --------
+template <class Queue>
+static int run_latency(const BenchCfg& cfg) {
+    const bench::RunResult r = bench::measure_latency<Queue, bench::Payload<8>>(cfg);
+    const bench::LatencyHistogram& all = r.latency;
 
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Results:\n"
+              << "  elapsed (s): " << r.secs << "\n"
+              << "  total ops :  " << static_cast<double>(r.ops) << "\n"
+              << "  throughput:  " << r.mops() << " Mops/s\n"
+              << "  enqueue->dequeue latency (ns, " << all.count() << " samples"
+              << (cfg.rate ? ", fixed rate, CO-corrected" : ", open loop") << "):\n"
+              << "    p50 / p99 / p99.9 / p99.99 / max: "
+              << all.percentile(50) << " / " << all.percentile(99) << " / " << all.percentile(99.9) << " / "
+              << all.percentile(99.99) << " / " << all.max() << "\n"
+              << "    mean: " << all.mean() << "\n";
     return 0;
 }
+
+template <class Layout>
+static void print_slot_bytes(std::uint64_t capacity) {
+    using Q = ring::RingMPMC<std::uint32_t, Layout>;
+    const std::uint64_t cap = ring::next_pow2(static_cast<std::size_t>(capacity));
+    std::cout << "  " << std::left << std::setw(8) << Layout::name << std::right
+              << std::setw(6) << Q::bytes_per_slot() << " B/slot  "
+              << std::setw(10) << (Q::bytes_per_slot() * cap) / 1024 << " KiB\n";
+}
+
+template <class T, class L> using MPMC = ring::RingMPMC<T, L>;
+template <class T, class L> using SPSC = ring::RingSPSC<T, L>;
+template <class T, class L> using Linked = ring::LinkedRingMPMC<T, L>;
+template <class T, class L> using FanIn  = ring::FanInRing<T, L>;
+template <class T, class L> using MPMCStats = ring::RingMPMC<T, L, ring::DefaultBackoff, ring::RingStats<>>;
+
+template <template <class, class> class Ring, class Layout>
+static int run_mode(const BenchCfg& cfg) {
+    if (cfg.latency) return run_latency<Ring<bench::Payload<8>, Layout>>(cfg); // payload = timestamp
+    return run_bench<Ring<std::uint32_t, Layout>>(cfg);
+}
+
+template <template <class, class> class Ring>
+static int run_layout(const BenchCfg& cfg, const std::string& layout) {
+    if (layout == ring::PaddedLayout::name) return run_mode<Ring, ring::PaddedLayout>(cfg);
+    if (layout == ring::PackedLayout::name) return run_mode<Ring, ring::PackedLayout>(cfg);
+    if (layout == ring::SplitLayout::name)  return run_mode<Ring, ring::SplitLayout>(cfg);
+
+    std::cerr << "unknown layout '" << layout << "' (expected padded|packed|split)\n";
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    // Args: [items_per_producer] [num_producers] [num_consumers] [queue_capacity] [batch] [minutes] [layout] [queue] [pin] [mode] [rate]
+    //   mode: throughput|latency|profile (latency: enqueue->dequeue histograms, see run_latency;
+    //         profile: the throughput run timed with rdtscp and read through hardware counters,
+    //         cycles / instructions / LLC and c2c misses per op — pair with queue mpmc-stats
+    //         for CAS retries; RING_PERF_C2C overrides the c2c raw event, see profile.hpp)
+    //   rate: latency mode only, ops/s per producer; 0 = as fast as possible
+    BenchCfg cfg;
+    cfg.items_per_producer = parse_u64(argc > 1 ? argv[1] : nullptr, 1'000'000ULL);
+    cfg.producers          = static_cast<int>(parse_u64(argc > 2 ? argv[2] : nullptr, 2));
+    cfg.consumers          = static_cast<int>(parse_u64(argc > 3 ? argv[3] : nullptr, 2));
+    cfg.capacity           = parse_u64(argc > 4 ? argv[4] : nullptr, 1ULL << 14);
+    cfg.batch              = static_cast<int>(parse_u64(argc > 5 ? argv[5] : nullptr, 32));
+    cfg.minutes            = parse_u64(argc > 6 ? argv[6] : nullptr, 0);
+    const std::string layout = (argc > 7) ? argv[7] : ring::PaddedLayout::name;
+    const std::string queue  = (argc > 8) ? argv[8] : "mpmc";
+    const std::string pin    = (argc > 9) ? argv[9] : "os"; // os|spread|compact|none
+    const std::string mode   = (argc > 10) ? argv[10] : "throughput";
+    cfg.rate               = parse_u64(argc > 11 ? argv[11] : nullptr, 0);
+
+    if (mode != "throughput" && mode != "latency" && mode != "profile") {
+        std::cerr << "unknown mode '" << mode << "' (expected throughput|latency|profile)\n";
+        return 2;
+    }
+    cfg.latency = (mode == "latency");
+    cfg.profile = (mode == "profile");
+
+    const ring::Topology topo = ring::query_topology();
+    if      (pin == "os")      cfg.cpus = topo.order(ring::Placement::Os);
+    else if (pin == "spread")  cfg.cpus = topo.order(ring::Placement::Spread);
+    else if (pin == "compact") cfg.cpus = topo.order(ring::Placement::Compact);
+    else if (pin != "none") {
+        std::cerr << "unknown pin mode '" << pin << "' (expected os|spread|compact|none)\n";
+        return 2;
+    }
+
+    if (queue == "spsc") { cfg.producers = 1; cfg.consumers = 1; } // SPSC: one thread per side
+    if (queue == "fanin") cfg.consumers = 1;                        // fan-in: one aggregator
+
+    std::cout << "Benchmark config:\n"
+              << "  items_per_producer = " << cfg.items_per_producer << "\n"
+              << "  producers          = " << cfg.producers << "\n"
+              << "  consumers          = " << cfg.consumers << "\n"
+              << "  queue_capacity     = " << cfg.capacity << "\n"
+              << "  batch              = " << cfg.batch << "\n"
+              << "  minutes (0=finite) = " << cfg.minutes << "\n"
+              << "  layout             = " << layout << "\n"
+              << "  queue              = " << queue << "\n"
+              << "  pin                = " << pin << "\n"
+              << "  mode               = " << mode;
+    if (cfg.latency) std::cout << " (rate " << (cfg.rate ? std::to_string(cfg.rate) + " ops/s/producer" : "unlimited") << ")";
+    std::cout << "\n"
+              << "  topology           = " << topo.num_cpus() << " cpus, " << topo.num_cores() << " cores, "
+              << topo.num_l3_domains() << " L3, " << topo.num_packages() << " sockets\n"
+              << "  simd (split batch) = " << ring::simd::isa() << "\n";
+
+    std::cout << "Slot layouts (uint32_t payload):\n";
+    print_slot_bytes<ring::PaddedLayout>(cfg.capacity);
+    print_slot_bytes<ring::PackedLayout>(cfg.capacity);
+    print_slot_bytes<ring::SplitLayout>(cfg.capacity);
+
+    if (queue == "mpmc") return run_layout<MPMC>(cfg, layout);
+    if (queue == "spsc") return run_layout<SPSC>(cfg, layout);
+    if (queue == "mpmc-stats") return run_layout<MPMCStats>(cfg, layout); // + contention report
+    if (queue == "linked") return run_layout<Linked>(cfg, layout); // capacity = segment size
+    if (queue == "fanin") return run_layout<FanIn>(cfg, layout);   // capacity = per producer lane
+
+    std::cerr << "unknown queue '" << queue << "' (expected mpmc|mpmc-stats|spsc|linked|fanin)\n";
+    return 2;
+}
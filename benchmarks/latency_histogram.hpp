@@ -0,0 +1,94 @@
+// benchmarks/latency_histogram.hpp — HDR-style log-linear latency histogram
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+#endif
+
+namespace bench {
+
+// Log-linear histogram over uint64 values (nanoseconds in the benches).
+// Values below 2*S are counted exactly; above that every power of two is
+// split into S linear sub-buckets, so any recorded value is reported within
+// 1/S (~0.8% for S = 128) of its true value. Fixed memory (~58 KiB), O(1)
+// record, no allocation after construction: one per thread, merge() at the end.
+class LatencyHistogram {
+public:
+    static constexpr unsigned      kSubBits = 7;
+    static constexpr std::uint64_t kSub     = 1ull << kSubBits;
+    static constexpr std::size_t   kBuckets = (64 - kSubBits + 1) * kSub;
+
+    LatencyHistogram() : counts_(kBuckets, 0) {}
+
+    void record(std::uint64_t v) noexcept {
+        ++counts_[index_of(v)];
+        ++total_;
+        if (v > max_) max_ = v;
+        if (v < min_) min_ = v;
+        sum_ += v;
+    }
+
+    void merge(const LatencyHistogram& o) noexcept {
+        for (std::size_t i = 0; i < kBuckets; ++i) counts_[i] += o.counts_[i];
+        total_ += o.total_;
+        sum_   += o.sum_;
+        max_ = std::max(max_, o.max_);
+        min_ = std::min(min_, o.min_);
+    }
+
+    std::uint64_t count() const noexcept { return total_; }
+    std::uint64_t max()   const noexcept { return total_ ? max_ : 0; }
+    std::uint64_t min()   const noexcept { return total_ ? min_ : 0; }
+    double        mean()  const noexcept { return total_ ? static_cast<double>(sum_) / static_cast<double>(total_) : 0.0; }
+
+    // Smallest recorded value v such that p% of samples are <= v, reported
+    // as the top of its bucket (like HdrHistogram's highest-equivalent value).
+    std::uint64_t percentile(double p) const noexcept {
+        if (total_ == 0) return 0;
+        const double want = std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(total_);
+        std::uint64_t target = static_cast<std::uint64_t>(want);
+        if (static_cast<double>(target) < want || target == 0) ++target;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += counts_[i];
+            if (seen >= target) return std::min(highest_of(i), max_);
+        }
+        return max_;
+    }
+
+private:
+    static unsigned msb(std::uint64_t v) noexcept {
+#if defined(_MSC_VER)
+        unsigned long r = 0;
+        _BitScanReverse64(&r, v);
+        return static_cast<unsigned>(r);
+#else
+        return 63u - static_cast<unsigned>(__builtin_clzll(v));
+#endif
+    }
+
+    static std::size_t index_of(std::uint64_t v) noexcept {
+        if (v < 2 * kSub) return static_cast<std::size_t>(v);
+        const unsigned shift = msb(v) - kSubBits;
+        return static_cast<std::size_t>((shift + 1) * kSub + ((v >> shift) - kSub));
+    }
+
+    static std::uint64_t highest_of(std::size_t i) noexcept {
+        if (i < 2 * kSub) return i;
+        const unsigned shift = static_cast<unsigned>(i / kSub) - 1;
+        const std::uint64_t sub = i % kSub + kSub;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t total_ = 0;
+    std::uint64_t sum_   = 0;
+    std::uint64_t max_   = 0;
+    std::uint64_t min_   = ~0ull;
+};
+
+} // namespace bench
@@ -0,0 +1,251 @@
+// benchmarks/profile.hpp — TSC timestamps and hardware counters for profile mode
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+  #include <cpuid.h>
+  #include <x86intrin.h>
+#endif
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+  #define NOMINMAX
+  #endif
+  #include <windows.h>
+#elif defined(__linux__)
+  #include <cerrno>
+  #include <cstring>
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+  #define BENCH_TSC_X86 1
+#endif
+
+namespace bench {
+
+// -------- Timestamp counter --------
+// tsc_now() is a bare rdtsc (cntvct_el0 on AArch64): a few ns, but not
+// ordered against the instructions around it, so only for spans much
+// longer than itself. tsc_begin() / tsc_end() fence both sides
+// (lfence; rdtsc; lfence ... rdtscp; lfence) so the op being timed can
+// neither start before the window nor finish after it. Ticks become ns
+// through a one-time calibration against steady_clock; other targets
+// fall back to steady_clock ns (1 tick = 1 ns).
+inline std::uint64_t tsc_now() noexcept {
+#if defined(BENCH_TSC_X86)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t v;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+inline std::uint64_t tsc_begin() noexcept {
+#if defined(BENCH_TSC_X86)
+    _mm_lfence();
+    const std::uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+#elif defined(__aarch64__)
+    __asm__ __volatile__("isb" ::: "memory");
+    return tsc_now();
+#else
+    return tsc_now();
+#endif
+}
+
+inline std::uint64_t tsc_end() noexcept {
+#if defined(BENCH_TSC_X86)
+    unsigned aux = 0;
+    const std::uint64_t t = __rdtscp(&aux);
+    _mm_lfence();
+    return t;
+#elif defined(__aarch64__)
+    __asm__ __volatile__("isb" ::: "memory");
+    return tsc_now();
+#else
+    return tsc_now();
+#endif
+}
+
+struct TscInfo {
+    double ticks_per_ns = 1.0;
+    bool   invariant    = false; // constant rate across P-states / C-states (x86 CPUID flag)
+};
+
+inline TscInfo calibrate_tsc() noexcept {
+    TscInfo info;
+#if defined(BENCH_TSC_X86)
+  #if defined(_MSC_VER)
+    int r[4] = {};
+    __cpuid(r, static_cast<int>(0x80000000u));
+    if (static_cast<unsigned>(r[0]) >= 0x80000007u) { __cpuid(r, static_cast<int>(0x80000007u)); info.invariant = (r[3] >> 8) & 1; }
+  #else
+    unsigned a = 0, b = 0, c = 0, d = 0;
+    if (__get_cpuid(0x80000007u, &a, &b, &c, &d)) info.invariant = (d >> 8) & 1;
+  #endif
+#elif defined(__aarch64__)
+    info.invariant = true; // the generic timer runs at a fixed frequency
+#endif
+#if defined(BENCH_TSC_X86) || defined(__aarch64__)
+    // 20 ms busy window against steady_clock (sleeping would let the core clock down).
+    const auto c0 = std::chrono::steady_clock::now();
+    const std::uint64_t t0 = tsc_begin();
+    auto c1 = c0;
+    while (c1 - c0 < std::chrono::milliseconds(20)) c1 = std::chrono::steady_clock::now();
+    const std::uint64_t t1 = tsc_end();
+    const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(c1 - c0).count());
+    if (ns > 0 && t1 > t0) info.ticks_per_ns = static_cast<double>(t1 - t0) / ns;
+#endif
+    return info;
+}
+
+inline const TscInfo& tsc_info() noexcept {
+    static const TscInfo info = calibrate_tsc();
+    return info;
+}
+
+inline double tsc_to_ns(std::uint64_t ticks) noexcept { return static_cast<double>(ticks) / tsc_info().ticks_per_ns; }
+
+// -------- Hardware counters --------
+// start() / stop() bracket a run; the counts cover the calling thread and
+// every thread it creates after start(), in user space. On Linux each
+// event is its own perf_event_open counter with inherit set, and a joined
+// thread's counts fold into its parent, so call stop() after the joins.
+// Multiplexed counters are scaled by time enabled / time running. An event
+// the kernel or CPU refuses (perf_event_paranoid, a VM without a PMU)
+// reads as unavailable instead of failing the run.
+//
+// c2c counts loads served from a line another core held modified (HITM):
+// what false sharing and contended CAS both cost. Read it next to the CAS
+// retries of the mpmc-stats queue: lines bouncing with few retries point
+// at false sharing, bouncing that tracks retries at contention. There is
+// no generic perf event for it; on Intel the default is raw 0x04d2
+// (MEM_LOAD_L3_HIT_RETIRED.XSNP_HITM, .XSNP_FWD on newer cores), other
+// CPUs take RING_PERF_C2C=<raw config, hex> from the vendor's event list.
+//
+// Windows: cycles come from QueryProcessCycleTime (all threads of the
+// process); the PMU events need ETW / a kernel driver and read as
+// unavailable.
+class PerfCounters {
+public:
+    enum Event { Cycles, Instructions, LlcMisses, C2C, kEvents };
+
+    static const char* name(Event e) noexcept {
+        static const char* const names[kEvents] = { "cycles", "instructions", "llc-misses", "c2c-hitm" };
+        return names[e];
+    }
+
+    PerfCounters() {
+#if defined(__linux__)
+        fd_[Cycles]       = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fd_[Instructions] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fd_[LlcMisses]    = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        if (const std::uint64_t raw = c2c_config()) fd_[C2C] = open(PERF_TYPE_RAW, raw);
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fd_) if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    void start() noexcept {
+#if defined(__linux__)
+        for (int fd : fd_) {
+            if (fd < 0) continue;
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#elif defined(_WIN32)
+        ULONG64 c = 0;
+        if (::QueryProcessCycleTime(::GetCurrentProcess(), &c)) { start_cycles_ = c; ok_[Cycles] = true; }
+#endif
+    }
+
+    void stop() noexcept {
+#if defined(__linux__)
+        for (int e = 0; e < kEvents; ++e) {
+            if (fd_[e] < 0) continue;
+            ::ioctl(fd_[e], PERF_EVENT_IOC_DISABLE, 0);
+            std::uint64_t r[3] = {}; // value, time enabled, time running
+            if (::read(fd_[e], r, sizeof(r)) != static_cast<ssize_t>(sizeof(r)) || r[2] == 0) continue;
+            value_[e] = (r[2] < r[1]) ? static_cast<std::uint64_t>(static_cast<double>(r[0]) * static_cast<double>(r[1]) / static_cast<double>(r[2])) : r[0];
+            ok_[e] = true;
+        }
+#elif defined(_WIN32)
+        ULONG64 c = 0;
+        if (ok_[Cycles] && ::QueryProcessCycleTime(::GetCurrentProcess(), &c)) value_[Cycles] = c - start_cycles_;
+        else ok_[Cycles] = false;
+#endif
+    }
+
+    bool          available(Event e) const noexcept { return ok_[e]; }
+    std::uint64_t value(Event e) const noexcept { return value_[e]; }
+
+    // Why counters are missing, for the report ("" once any opened).
+    const std::string& error() const noexcept { return error_; }
+
+private:
+#if defined(__linux__)
+    int open(std::uint32_t type, std::uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = type;
+        attr.config         = config;
+        attr.disabled       = 1;
+        attr.inherit        = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        const long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd < 0) {
+            if (error_.empty()) {
+                const int err = errno;
+                error_ = std::string("perf_event_open: ") + std::strerror(err);
+                if (err == EACCES || err == EPERM) error_ += "; lower /proc/sys/kernel/perf_event_paranoid";
+                else if (err == ENOENT || err == EOPNOTSUPP) error_ += "; no such PMU event here (VM?)";
+            }
+            return -1;
+        }
+        return static_cast<int>(fd);
+    }
+
+    static std::uint64_t c2c_config() noexcept {
+        if (const char* env = std::getenv("RING_PERF_C2C")) return std::strtoull(env, nullptr, 16);
+  #if defined(BENCH_TSC_X86)
+        unsigned a = 0, b = 0, c = 0, d = 0;
+        if (__get_cpuid(0, &a, &b, &c, &d) && b == 0x756e6547u && d == 0x49656e69u && c == 0x6c65746eu) return 0x04d2; // GenuineIntel
+  #endif
+        return 0;
+    }
+
+    int fd_[kEvents] = { -1, -1, -1, -1 };
+    std::string error_;
+#else
+    std::uint64_t start_cycles_ = 0;
+    std::string error_ = "PMU events need ETW or a kernel driver on this platform";
+#endif
+    std::uint64_t value_[kEvents] = {};
+    bool          ok_[kEvents]    = {};
+};
+
+} // namespace bench
@@ -1,9 +1,11 @@
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <iostream>
 #include <thread>
 #include <vector>
+#include "../include/ring/byte_ring.hpp"
 #include "../include/ring/ring_mpmc.hpp"
 
 int main() {
@@ -35,6 +37,27 @@ int main() {
 
     prod.join();
     cons.join();
+
+    // Same hand-off through a byte ring: each batch is a length-prefixed
+    // record in the ring itself, no heap allocation per message.
+    ring::ByteRingSPSC<> bytes(4096);
+    std::thread bprod([&]{
+        for (int i = 0; i < 10; ++i) {
+            int batch[8];
+            const std::size_t n = 1 + static_cast<std::size_t>(i % 8);
+            std::fill_n(batch, n, i);
+            bytes.write(batch, n * sizeof(int));
+        }
+    });
+    std::thread bcons([&]{
+        int drained = 0;
+        for (int i = 0; i < 10; ++i) {
+            bytes.read([&](const ring::ByteRecord& r) { drained += static_cast<int>(r.size / sizeof(int)); });
+        }
+        std::cout << "Drained items (byte ring): " << drained << "\n";
+    });
+    bprod.join();
+    bcons.join();
     std::cout << "CPU demo skeleton done\n";
     return 0;
 }
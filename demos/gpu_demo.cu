@@ -1,3 +1,325 @@
+// demos/gpu_demo.cu — CPU producer -> GPU consumer through a pinned-host ticket ring,
+// against staged cudaMemcpyAsync per batch
+
 #include <cuda_runtime.h>
-__global__ void noop() {}
-int main() { noop<<<1,1>>>(); cudaDeviceSynchronize(); return 0; }
+#include <cuda/atomic>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "latency_histogram.hpp"
+#include "ring/backoff.hpp"
+#include "ring/utils.hpp"
+
+// Args: [batches] [floats_per_batch] [capacity]
+//   Streams batches (default 20000) of floats_per_batch floats (default 4096)
+//   from one CPU thread to the GPU two ways and reports batches/s, GB/s and
+//   the publish -> consumed round trip of single batches (p50 / p99, us):
+//     ring    GpuHandoffRing of capacity slots (default 64) in mapped pinned
+//             memory, drained by one persistent kernel
+//     staged  per batch: fill a pinned staging buffer, cudaMemcpyAsync to the
+//             device, launch a kernel on it (two buffers in flight)
+
+#define CUDA_CHECK(x)                                                                           \
+    do {                                                                                        \
+        const cudaError_t err_ = (x);                                                           \
+        if (err_ != cudaSuccess) {                                                              \
+            std::fprintf(stderr, "%s:%d: %s: %s\n", __FILE__, __LINE__, #x, cudaGetErrorString(err_)); \
+            std::exit(1);                                                                       \
+        }                                                                                       \
+    } while (0)
+
+constexpr unsigned      kThreads = 256;         // consumer block size
+constexpr std::uint32_t kStop    = 0xFFFFFFFFu; // batch length that ends the persistent kernel
+
+// -------- Handoff ring --------
+// Slot tickets as in ring.hpp: slot i is free at seq == i, holds a batch at
+// i + 1 and is handed back at seq == i + capacity. Tickets, batch lengths
+// and payloads all live in mapped pinned host memory. The CPU producer and
+// the GPU consumer touch seq[] only with system-scope atomics
+// (std::atomic_ref here, cuda::atomic_ref<thread_scope_system> in the
+// kernel); payload stores / loads are ordered by the release / acquire on
+// the ticket. Single producer, single consumer (one thread block), so no
+// read-modify-write ever crosses the bus, only loads and stores.
+class GpuHandoffRing {
+public:
+    GpuHandoffRing(std::size_t capacity, std::size_t floats_per_batch)
+        : capacity_(ring::next_pow2(capacity)), mask_(capacity_ - 1), floats_(floats_per_batch)
+    {
+        CUDA_CHECK(cudaHostAlloc(reinterpret_cast<void**>(&seq_), capacity_ * sizeof(std::uint64_t), cudaHostAllocMapped));
+        CUDA_CHECK(cudaHostAlloc(reinterpret_cast<void**>(&len_), capacity_ * sizeof(std::uint32_t), cudaHostAllocMapped));
+        CUDA_CHECK(cudaHostAlloc(reinterpret_cast<void**>(&payload_), capacity_ * floats_ * sizeof(float), cudaHostAllocMapped));
+        for (std::size_t i = 0; i < capacity_; ++i) seq_[i] = i;
+        CUDA_CHECK(cudaHostGetDevicePointer(reinterpret_cast<void**>(&d_seq_), seq_, 0));
+        CUDA_CHECK(cudaHostGetDevicePointer(reinterpret_cast<void**>(&d_len_), len_, 0));
+        CUDA_CHECK(cudaHostGetDevicePointer(reinterpret_cast<void**>(&d_payload_), payload_, 0));
+    }
+
+    ~GpuHandoffRing() {
+        cudaFreeHost(payload_);
+        cudaFreeHost(len_);
+        cudaFreeHost(seq_);
+    }
+
+    GpuHandoffRing(const GpuHandoffRing&) = delete;
+    GpuHandoffRing& operator=(const GpuHandoffRing&) = delete;
+
+    std::size_t capacity() const noexcept { return capacity_; }
+
+    // Producer: copies n floats into the next slot and publishes it under
+    // *ticket; false when the GPU still holds that slot.
+    bool try_publish(const float* src, std::uint32_t n, std::uint64_t* ticket = nullptr) noexcept {
+        const std::uint64_t t = tail_;
+        const std::size_t s = static_cast<std::size_t>(t) & mask_;
+        if (std::atomic_ref<std::uint64_t>(seq_[s]).load(ring::ACQUIRE) != t) return false;
+        if (n != kStop) std::memcpy(payload_ + s * floats_, src, n * sizeof(float));
+        len_[s] = n;
+        std::atomic_ref<std::uint64_t>(seq_[s]).store(t + 1, ring::RELEASE);
+        tail_ = t + 1;
+        if (ticket) *ticket = t;
+        return true;
+    }
+
+    std::uint64_t publish(const float* src, std::uint32_t n) noexcept {
+        std::uint64_t t = 0;
+        while (!try_publish(src, n, &t)) ring::cpu_relax();
+        return t;
+    }
+
+    // Ends the persistent kernel once it has drained everything before.
+    void stop() noexcept { publish(nullptr, kStop); }
+
+    // The GPU has handed ticket's slot back.
+    bool consumed(std::uint64_t ticket) const noexcept {
+        return std::atomic_ref<std::uint64_t>(seq_[static_cast<std::size_t>(ticket) & mask_]).load(ring::ACQUIRE)
+               == ticket + capacity_;
+    }
+
+    std::uint64_t*       device_seq() const noexcept { return d_seq_; }
+    const std::uint32_t* device_len() const noexcept { return d_len_; }
+    const float*         device_payload() const noexcept { return d_payload_; }
+
+private:
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    const std::size_t floats_;
+    std::uint64_t* seq_     = nullptr;
+    std::uint32_t* len_     = nullptr;
+    float*         payload_ = nullptr;
+    std::uint64_t*       d_seq_     = nullptr;
+    const std::uint32_t* d_len_     = nullptr;
+    const float*         d_payload_ = nullptr;
+    std::uint64_t tail_ = 0; // producer-owned
+};
+
+// -------- Kernels --------
+
+// Block-wide sum of one value per thread (blockDim.x == kThreads).
+__device__ float block_sum(float v) {
+    __shared__ float red[kThreads];
+    red[threadIdx.x] = v;
+    __syncthreads();
+    for (unsigned w = kThreads / 2; w > 0; w >>= 1) {
+        if (threadIdx.x < w) red[threadIdx.x] += red[threadIdx.x + w];
+        __syncthreads();
+    }
+    const float r = red[0];
+    __syncthreads();
+    return r;
+}
+
+// One block drains the ring until the stop batch: thread 0 waits for the
+// ticket (acquire, system scope), the barrier extends that ordering to the
+// whole block, every thread reads its share of the batch straight from
+// host memory, and after a second barrier thread 0 hands the slot back
+// (release, system scope). The per-batch sums add up in *total.
+__global__ void ring_consumer(std::uint64_t* seq, const std::uint32_t* len, const float* payload,
+                              std::size_t capacity, std::size_t floats, double* total) {
+    __shared__ std::uint32_t n_sh;
+    double acc = 0;
+    for (std::uint64_t i = 0;; ++i) {
+        const std::size_t s = static_cast<std::size_t>(i) & (capacity - 1);
+        cuda::atomic_ref<std::uint64_t, cuda::thread_scope_system> ticket(seq[s]);
+        if (threadIdx.x == 0) {
+            while (ticket.load(cuda::std::memory_order_acquire) != i + 1) __nanosleep(64);
+            n_sh = len[s];
+        }
+        __syncthreads();
+        const std::uint32_t n = n_sh;
+        if (n == kStop) {
+            if (threadIdx.x == 0) { *total = acc; ticket.store(i + capacity, cuda::std::memory_order_release); }
+            return;
+        }
+        float v = 0;
+        const float* p = payload + s * floats;
+        for (std::uint32_t k = threadIdx.x; k < n; k += kThreads) v += p[k];
+        v = block_sum(v); // ends in a barrier: every read of the slot is done
+        if (threadIdx.x == 0) {
+            acc += v;
+            ticket.store(i + capacity, cuda::std::memory_order_release);
+        }
+    }
+}
+
+// Staged baseline: the same reduction over one batch already in device memory.
+__global__ void staged_consumer(const float* batch, std::uint32_t n, double* total) {
+    float v = 0;
+    for (std::uint32_t k = threadIdx.x; k < n; k += kThreads) v += batch[k];
+    v = block_sum(v);
+    if (threadIdx.x == 0) *total += v;
+}
+
+// -------- Benchmark --------
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    double secs  = 0;
+    double total = 0;
+    bench::LatencyHistogram rtt; // ns
+};
+
+// Batch b holds the value b % 7 (small integers: float sums stay exact).
+static void fill(std::vector<float>& buf, std::uint64_t b) {
+    std::fill(buf.begin(), buf.end(), static_cast<float>(b % 7));
+}
+
+static double expected_total(std::uint64_t batches, std::size_t floats) {
+    double t = 0;
+    for (std::uint64_t b = 0; b < batches; ++b) t += static_cast<double>(b % 7) * static_cast<double>(floats);
+    return t;
+}
+
+static double* alloc_total() {
+    double* d = nullptr;
+    CUDA_CHECK(cudaMalloc(&d, sizeof(double)));
+    CUDA_CHECK(cudaMemset(d, 0, sizeof(double)));
+    return d;
+}
+
+static double read_total(double* d) {
+    double t = 0;
+    CUDA_CHECK(cudaMemcpy(&t, d, sizeof(double), cudaMemcpyDeviceToHost));
+    CUDA_CHECK(cudaFree(d));
+    return t;
+}
+
+// latency = true publishes one batch at a time and waits for its hand-back.
+static Result run_ring(std::uint64_t batches, std::size_t floats, std::size_t capacity, bool latency) {
+    GpuHandoffRing q(capacity, floats);
+    cudaStream_t stream;
+    CUDA_CHECK(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+    double* d_total = alloc_total();
+    ring_consumer<<<1, kThreads, 0, stream>>>(q.device_seq(), q.device_len(), q.device_payload(), q.capacity(), floats, d_total);
+    CUDA_CHECK(cudaGetLastError());
+
+    Result r;
+    std::vector<float> buf(floats);
+    const auto t0 = Clock::now();
+    for (std::uint64_t b = 0; b < batches; ++b) {
+        fill(buf, b);
+        const auto p0 = Clock::now();
+        const std::uint64_t ticket = q.publish(buf.data(), static_cast<std::uint32_t>(floats));
+        if (latency) {
+            while (!q.consumed(ticket)) ring::cpu_relax();
+            r.rtt.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - p0).count()));
+        }
+    }
+    q.stop();
+    CUDA_CHECK(cudaStreamSynchronize(stream));
+    r.secs = std::chrono::duration<double>(Clock::now() - t0).count();
+    r.total = read_total(d_total);
+    CUDA_CHECK(cudaStreamDestroy(stream));
+    return r;
+}
+
+static Result run_staged(std::uint64_t batches, std::size_t floats, bool latency) {
+    const std::size_t bytes = floats * sizeof(float);
+    cudaStream_t stream;
+    CUDA_CHECK(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+    float* staging[2];
+    float* device[2];
+    cudaEvent_t copied[2];
+    for (int k = 0; k < 2; ++k) {
+        CUDA_CHECK(cudaHostAlloc(reinterpret_cast<void**>(&staging[k]), bytes, cudaHostAllocDefault));
+        CUDA_CHECK(cudaMalloc(&device[k], bytes));
+        CUDA_CHECK(cudaEventCreateWithFlags(&copied[k], cudaEventDisableTiming));
+        CUDA_CHECK(cudaEventRecord(copied[k], stream));
+    }
+    double* d_total = alloc_total();
+
+    Result r;
+    std::vector<float> buf(floats);
+    const auto t0 = Clock::now();
+    for (std::uint64_t b = 0; b < batches; ++b) {
+        const int k = static_cast<int>(b & 1);
+        fill(buf, b);
+        const auto p0 = Clock::now();
+        CUDA_CHECK(cudaEventSynchronize(copied[k])); // staging[k] free again
+        std::memcpy(staging[k], buf.data(), bytes);
+        CUDA_CHECK(cudaMemcpyAsync(device[k], staging[k], bytes, cudaMemcpyHostToDevice, stream));
+        CUDA_CHECK(cudaEventRecord(copied[k], stream));
+        staged_consumer<<<1, kThreads, 0, stream>>>(device[k], static_cast<std::uint32_t>(floats), d_total);
+        if (latency) {
+            CUDA_CHECK(cudaStreamSynchronize(stream));
+            r.rtt.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - p0).count()));
+        }
+    }
+    CUDA_CHECK(cudaStreamSynchronize(stream));
+    r.secs = std::chrono::duration<double>(Clock::now() - t0).count();
+    r.total = read_total(d_total);
+    for (int k = 0; k < 2; ++k) {
+        CUDA_CHECK(cudaEventDestroy(copied[k]));
+        CUDA_CHECK(cudaFree(device[k]));
+        CUDA_CHECK(cudaFreeHost(staging[k]));
+    }
+    CUDA_CHECK(cudaStreamDestroy(stream));
+    return r;
+}
+
+static std::uint64_t arg(int argc, char** argv, int i, std::uint64_t def) {
+    if (argc <= i) return def;
+    char* end = nullptr;
+    const unsigned long long v = std::strtoull(argv[i], &end, 10);
+    return (end && *end == '\0' && v > 0) ? static_cast<std::uint64_t>(v) : def;
+}
+
+int main(int argc, char** argv) {
+    const std::uint64_t batches  = arg(argc, argv, 1, 20000);
+    const std::size_t   floats   = static_cast<std::size_t>(arg(argc, argv, 2, 4096));
+    const std::size_t   capacity = static_cast<std::size_t>(arg(argc, argv, 3, 64));
+    const std::uint64_t rtt_batches = batches < 2000 ? batches : 2000;
+
+    CUDA_CHECK(cudaSetDeviceFlags(cudaDeviceMapHost)); // before the context exists
+    cudaDeviceProp prop{};
+    CUDA_CHECK(cudaGetDeviceProperties(&prop, 0));
+    if (!prop.canMapHostMemory) { std::cerr << prop.name << ": no mapped host memory\n"; return 1; }
+
+    std::cout << "GPU handoff: " << prop.name << ", " << batches << " batches x " << floats
+              << " floats, ring capacity " << ring::next_pow2(capacity) << "\n"
+              << "  " << std::left << std::setw(8) << "path" << std::right << std::setw(12) << "batches/s"
+              << std::setw(10) << "GB/s" << std::setw(12) << "rtt p50 us" << std::setw(12) << "rtt p99 us" << "\n";
+
+    const double want = expected_total(batches, floats), want_rtt = expected_total(rtt_batches, floats);
+    const auto report = [&](const char* name, const Result& tput, const Result& lat) {
+        if (tput.total != want || lat.total != want_rtt) std::cerr << name << ": checksum mismatch\n";
+        const double gbs = static_cast<double>(batches) * static_cast<double>(floats * sizeof(float)) / tput.secs / 1e9;
+        std::cout << "  " << std::left << std::setw(8) << name << std::right << std::fixed
+                  << std::setw(12) << std::setprecision(0) << static_cast<double>(batches) / tput.secs
+                  << std::setw(10) << std::setprecision(2) << gbs
+                  << std::setw(12) << std::setprecision(1) << static_cast<double>(lat.rtt.percentile(50)) / 1e3
+                  << std::setw(12) << static_cast<double>(lat.rtt.percentile(99)) / 1e3 << "\n";
+    };
+
+    report("ring", run_ring(batches, floats, capacity, false), run_ring(rtt_batches, floats, capacity, true));
+    report("staged", run_staged(batches, floats, false), run_staged(rtt_batches, floats, true));
+    return 0;
+}
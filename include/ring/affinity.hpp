@@ -0,0 +1,303 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+  #define NOMINMAX
+  #endif
+  #include <windows.h>
+#elif defined(__APPLE__)
+  #include <mach/mach.h>
+  #include <mach/thread_policy.h>
+  #include <sys/sysctl.h>
+#elif defined(__linux__)
+  #include <fstream>
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+namespace ring {
+
+// Thread placement and CPU topology.
+//
+// CPUs are numbered 0..N-1 across the whole machine. On Windows that is the
+// concatenation of all processor groups (so >64 logical CPUs stay distinct),
+// on Linux the kernel's CPU ids. macOS exposes no per-CPU topology or hard
+// pinning: the topology is derived from hw.physicalcpu/hw.logicalcpu and
+// pinning sets a thread affinity tag, which the scheduler treats as a hint.
+
+struct CpuInfo {
+    unsigned cpu;     // logical CPU id
+    unsigned core;    // physical core index (SMT siblings share it)
+    unsigned package; // socket
+    unsigned l3;      // L3 (last-level cache) domain index
+};
+
+enum class Placement {
+    Os,      // logical CPU order as the OS numbers them
+    Spread,  // one CPU per physical core first, SMT siblings last
+    Compact, // fill both SMT siblings of a core before the next core
+};
+
+struct Topology {
+    std::vector<CpuInfo> cpus; // sorted by cpu id
+
+    std::size_t num_cpus() const noexcept { return cpus.size(); }
+    std::size_t num_cores() const { return count_distinct(&CpuInfo::core); }
+    std::size_t num_packages() const { return count_distinct(&CpuInfo::package); }
+    std::size_t num_l3_domains() const { return count_distinct(&CpuInfo::l3); }
+
+    // SMT siblings of cpu, including cpu itself.
+    std::vector<unsigned> siblings_of(unsigned cpu) const {
+        return select(&CpuInfo::core, find(cpu).core);
+    }
+
+    std::vector<unsigned> l3_domain(unsigned l3) const { return select(&CpuInfo::l3, l3); }
+
+    // CPU order for handing out to threads 0, 1, 2, ...
+    std::vector<unsigned> order(Placement p) const {
+        std::vector<CpuInfo> v = cpus;
+        if (p == Placement::Spread) {
+            // rank of each cpu among its core's siblings, then by L3 domain and core
+            std::map<unsigned, unsigned> seen;
+            std::vector<std::pair<unsigned, CpuInfo>> ranked;
+            for (const CpuInfo& c : v) ranked.emplace_back(seen[c.core]++, c);
+            std::stable_sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+                if (a.first != b.first) return a.first < b.first;
+                if (a.second.l3 != b.second.l3) return a.second.l3 < b.second.l3;
+                return a.second.core < b.second.core;
+            });
+            for (std::size_t i = 0; i < v.size(); ++i) v[i] = ranked[i].second;
+        } else if (p == Placement::Compact) {
+            std::stable_sort(v.begin(), v.end(), [](const CpuInfo& a, const CpuInfo& b) {
+                if (a.l3 != b.l3) return a.l3 < b.l3;
+                return a.core < b.core;
+            });
+        }
+        std::vector<unsigned> out;
+        for (const CpuInfo& c : v) out.push_back(c.cpu);
+        return out;
+    }
+
+    const CpuInfo& find(unsigned cpu) const {
+        for (const CpuInfo& c : cpus) if (c.cpu == cpu) return c;
+        return cpus.front();
+    }
+
+private:
+    std::size_t count_distinct(unsigned CpuInfo::* field) const {
+        std::vector<unsigned> ids;
+        for (const CpuInfo& c : cpus) ids.push_back(c.*field);
+        std::sort(ids.begin(), ids.end());
+        return static_cast<std::size_t>(std::unique(ids.begin(), ids.end()) - ids.begin());
+    }
+
+    std::vector<unsigned> select(unsigned CpuInfo::* field, unsigned value) const {
+        std::vector<unsigned> out;
+        for (const CpuInfo& c : cpus) if (c.*field == value) out.push_back(c.cpu);
+        return out;
+    }
+};
+
+namespace detail {
+
+// Renumbers arbitrary ids (e.g. sysfs core ids, first-cpu-of-cache) to 0..k-1.
+inline void compact_ids(std::vector<CpuInfo>& cpus, unsigned CpuInfo::* field) {
+    std::map<unsigned, unsigned> remap;
+    for (const CpuInfo& c : cpus) remap.emplace(c.*field, 0u);
+    unsigned next = 0;
+    for (auto& kv : remap) kv.second = next++;
+    for (CpuInfo& c : cpus) c.*field = remap[c.*field];
+}
+
+inline Topology flat_topology(unsigned logical, unsigned smt) {
+    if (logical == 0) logical = 1;
+    if (smt == 0) smt = 1;
+    Topology t;
+    for (unsigned i = 0; i < logical; ++i) t.cpus.push_back({ i, i / smt, 0, 0 });
+    return t;
+}
+
+#if defined(__linux__)
+// Parses the kernel's cpulist format ("0-3,8,10-11").
+inline std::vector<unsigned> parse_cpulist(const std::string& s) {
+    std::vector<unsigned> out;
+    std::size_t i = 0;
+    while (i < s.size()) {
+        std::size_t j = i;
+        while (j < s.size() && s[j] != ',') ++j;
+        const std::string part = s.substr(i, j - i);
+        const std::size_t dash = part.find('-');
+        try {
+            if (dash == std::string::npos) {
+                if (!part.empty() && part[0] != '\n') out.push_back(static_cast<unsigned>(std::stoul(part)));
+            } else {
+                const unsigned lo = static_cast<unsigned>(std::stoul(part.substr(0, dash)));
+                const unsigned hi = static_cast<unsigned>(std::stoul(part.substr(dash + 1)));
+                for (unsigned c = lo; c <= hi; ++c) out.push_back(c);
+            }
+        } catch (...) {
+            return out;
+        }
+        i = j + 1;
+    }
+    return out;
+}
+
+inline bool read_line(const std::string& path, std::string& out) {
+    std::ifstream f(path);
+    return static_cast<bool>(std::getline(f, out));
+}
+
+inline bool read_uint(const std::string& path, unsigned& out) {
+    std::string s;
+    if (!read_line(path, s)) return false;
+    try { out = static_cast<unsigned>(std::stoul(s)); } catch (...) { return false; }
+    return true;
+}
+#endif
+
+} // namespace detail
+
+inline Topology query_topology() {
+#if defined(__linux__)
+    const std::string root = "/sys/devices/system/cpu/";
+    std::string online;
+    if (!detail::read_line(root + "online", online)) {
+        return detail::flat_topology(std::thread::hardware_concurrency(), 1);
+    }
+
+    Topology t;
+    for (unsigned cpu : detail::parse_cpulist(online)) {
+        const std::string dir = root + "cpu" + std::to_string(cpu) + "/";
+        unsigned core = cpu, package = 0;
+        detail::read_uint(dir + "topology/core_id", core);
+        detail::read_uint(dir + "topology/physical_package_id", package);
+
+        unsigned l3 = 0; // identified by the lowest CPU sharing it
+        for (int idx = 0; idx < 8; ++idx) {
+            const std::string cache = dir + "cache/index" + std::to_string(idx) + "/";
+            unsigned level = 0;
+            if (!detail::read_uint(cache + "level", level)) break;
+            std::string shared;
+            if (level == 3 && detail::read_line(cache + "shared_cpu_list", shared)) {
+                const std::vector<unsigned> l = detail::parse_cpulist(shared);
+                if (!l.empty()) l3 = *std::min_element(l.begin(), l.end());
+            }
+        }
+        // core_id is only unique within a package
+        t.cpus.push_back({ cpu, package * 65536u + core, package, l3 });
+    }
+    if (t.cpus.empty()) return detail::flat_topology(std::thread::hardware_concurrency(), 1);
+    detail::compact_ids(t.cpus, &CpuInfo::core);
+    detail::compact_ids(t.cpus, &CpuInfo::package);
+    detail::compact_ids(t.cpus, &CpuInfo::l3);
+    return t;
+#elif defined(_WIN32)
+    // Global CPU id = sum of active processors in lower groups + bit index.
+    const WORD groups = GetActiveProcessorGroupCount();
+    std::vector<unsigned> group_base(groups + 1, 0);
+    for (WORD g = 0; g < groups; ++g) group_base[g + 1] = group_base[g] + GetActiveProcessorCount(g);
+
+    DWORD len = 0;
+    GetLogicalProcessorInformationEx(RelationAll, nullptr, &len);
+    std::vector<std::uint8_t> buf(len);
+    auto* info = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buf.data());
+    if (len == 0 || !GetLogicalProcessorInformationEx(RelationAll, info, &len)) {
+        return detail::flat_topology(std::thread::hardware_concurrency(), 1);
+    }
+
+    Topology t;
+    t.cpus.resize(group_base[groups]);
+    for (unsigned i = 0; i < t.cpus.size(); ++i) t.cpus[i] = { i, i, 0, 0 };
+
+    auto for_each_cpu = [&](const GROUP_AFFINITY& ga, auto&& fn) {
+        if (ga.Group >= groups) return;
+        for (unsigned bit = 0; bit < 64; ++bit) {
+            if (ga.Mask & (KAFFINITY(1) << bit)) {
+                const unsigned cpu = group_base[ga.Group] + bit;
+                if (cpu < t.cpus.size()) fn(t.cpus[cpu]);
+            }
+        }
+    };
+
+    unsigned core = 0, package = 0, l3 = 0;
+    for (DWORD off = 0; off < len;) {
+        auto* e = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buf.data() + off);
+        if (e->Relationship == RelationProcessorCore) {
+            for (WORD g = 0; g < e->Processor.GroupCount; ++g)
+                for_each_cpu(e->Processor.GroupMask[g], [&](CpuInfo& c) { c.core = core; });
+            ++core;
+        } else if (e->Relationship == RelationProcessorPackage) {
+            for (WORD g = 0; g < e->Processor.GroupCount; ++g)
+                for_each_cpu(e->Processor.GroupMask[g], [&](CpuInfo& c) { c.package = package; });
+            ++package;
+        } else if (e->Relationship == RelationCache && e->Cache.Level == 3) {
+            for_each_cpu(e->Cache.GroupMask, [&](CpuInfo& c) { c.l3 = l3; });
+            ++l3;
+        }
+        off += e->Size;
+    }
+    return t;
+#elif defined(__APPLE__)
+    int logical = 0, physical = 0;
+    std::size_t sz = sizeof(int);
+    sysctlbyname("hw.logicalcpu", &logical, &sz, nullptr, 0);
+    sz = sizeof(int);
+    sysctlbyname("hw.physicalcpu", &physical, &sz, nullptr, 0);
+    const unsigned smt = (physical > 0 && logical >= physical) ? static_cast<unsigned>(logical / physical) : 1;
+    return detail::flat_topology(static_cast<unsigned>(logical), smt);
+#else
+    return detail::flat_topology(std::thread::hardware_concurrency(), 1);
+#endif
+}
+
+// Pins the calling thread to one logical CPU; returns false if the OS
+// refused (or, on macOS, could not even apply the affinity hint).
+inline bool pin_current_thread(unsigned cpu) noexcept {
+#if defined(__linux__)
+    const std::size_t ncpu = cpu + 1;
+    cpu_set_t* set = CPU_ALLOC(ncpu);
+    if (!set) return false;
+    const std::size_t bytes = CPU_ALLOC_SIZE(ncpu);
+    CPU_ZERO_S(bytes, set);
+    CPU_SET_S(cpu, bytes, set);
+    const int rc = pthread_setaffinity_np(pthread_self(), bytes, set);
+    CPU_FREE(set);
+    return rc == 0;
+#elif defined(_WIN32)
+    const WORD groups = GetActiveProcessorGroupCount();
+    unsigned base = 0;
+    for (WORD g = 0; g < groups; ++g) {
+        const unsigned n = GetActiveProcessorCount(g);
+        if (cpu < base + n) {
+            GROUP_AFFINITY ga{};
+            ga.Group = g;
+            ga.Mask  = KAFFINITY(1) << (cpu - base);
+            return SetThreadGroupAffinity(GetCurrentThread(), &ga, nullptr) != 0;
+        }
+        base += n;
+    }
+    return false;
+#elif defined(__APPLE__)
+    thread_affinity_policy_data_t policy = { static_cast<integer_t>(cpu + 1) }; // tag 0 = none
+    const mach_port_t self = mach_thread_self();
+    const kern_return_t rc = thread_policy_set(self, THREAD_AFFINITY_POLICY,
+                                               reinterpret_cast<thread_policy_t>(&policy),
+                                               THREAD_AFFINITY_POLICY_COUNT);
+    mach_port_deallocate(mach_task_self(), self);
+    return rc == KERN_SUCCESS;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+} // namespace ring
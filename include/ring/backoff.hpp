@@ -0,0 +1,118 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include "park.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+  #include <intrin.h>
+#endif
+
+namespace ring {
+
+// CPU spin-wait hint: releases pipeline resources to the SMT sibling and
+// slows the loop down without giving up the core.
+inline void cpu_relax() noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    __isb(_ARM64_BARRIER_SY);
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("isb" ::: "memory"); // 'yield' is a nop on most cores
+#elif defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+#elif defined(__powerpc__) || defined(__ppc__)
+    __asm__ __volatile__("or 27,27,27" ::: "memory");
+#elif defined(__riscv)
+    __asm__ __volatile__(".insn i 0x0F, 0, x0, x0, 0x010"); // pause (Zihintpause)
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// -------- Backoff policies --------
+// Template parameter of RingMPMC / RingSPSC, used by every loop that waits
+// for the other side (enqueue_many, enqueue_until, dequeue_until). A fresh
+// policy object is made per wait; after each failed attempt the loop calls
+//   wait(word, seen)  -- word is the atomic it is waiting on, seen its last value
+// Only parking policies look at the arguments. wait() may return what it did
+// as a BackoffAction (for stats.hpp); a void wait() counts as a spin.
+
+enum class BackoffAction { Spin, Yield, Park };
+
+// Pause every iteration; never leaves the core.
+struct SpinBackoff {
+    static constexpr const char* name = "spin";
+    BackoffAction wait(const std::atomic<std::uint64_t>&, std::uint64_t) noexcept {
+        cpu_relax();
+        return BackoffAction::Spin;
+    }
+};
+
+// 1, 2, 4, ... MaxPauses pause instructions per failed attempt.
+template <std::uint32_t MaxPauses = 64>
+struct ExponentialBackoff {
+    static constexpr const char* name = "exp-pause";
+    std::uint32_t pauses = 1;
+
+    BackoffAction wait(const std::atomic<std::uint64_t>&, std::uint64_t) noexcept {
+        for (std::uint32_t i = 0; i < pauses; ++i) cpu_relax();
+        if (pauses < MaxPauses) pauses <<= 1;
+        return BackoffAction::Spin;
+    }
+};
+
+// SpinLimit pauses, then a yield (the rings' original behaviour).
+template <int SpinLimit = 200>
+struct SpinYieldBackoff {
+    static constexpr const char* name = "spin-yield";
+    int spins = 0;
+
+    BackoffAction wait(const std::atomic<std::uint64_t>&, std::uint64_t) noexcept {
+        if (++spins < SpinLimit) { cpu_relax(); return BackoffAction::Spin; }
+        std::this_thread::yield();
+        spins = 0;
+        return BackoffAction::Yield;
+    }
+};
+
+// SpinLimit pauses, then parks on the waited-on word (futex/WaitOnAddress)
+// with a timeout that doubles from 16us up to MaxParkUs. Timed so it needs
+// no waker: a change nobody signals costs at most one park.
+template <int SpinLimit = 200, std::uint32_t MaxParkUs = 1000>
+struct SpinParkBackoff {
+    static constexpr const char* name = "spin-park";
+    int spins = 0;
+    std::uint32_t park_us = 16;
+
+    BackoffAction wait(const std::atomic<std::uint64_t>& word, std::uint64_t seen) noexcept {
+        if (++spins < SpinLimit) { cpu_relax(); return BackoffAction::Spin; }
+        park_wait(word, seen, std::chrono::microseconds(park_us));
+        if (park_us < MaxParkUs) park_us = (park_us * 2 < MaxParkUs) ? park_us * 2 : MaxParkUs;
+        return BackoffAction::Park;
+    }
+};
+
+using DefaultBackoff = SpinYieldBackoff<>;
+
+// Runs one wait step of any policy and reports what it did.
+template <class Backoff>
+inline BackoffAction backoff_wait(Backoff& b, const std::atomic<std::uint64_t>& word, std::uint64_t seen) noexcept {
+    if constexpr (std::is_void_v<decltype(b.wait(word, seen))>) {
+        b.wait(word, seen);
+        return BackoffAction::Spin;
+    } else {
+        return b.wait(word, seen);
+    }
+}
+
+} // namespace ring
+
+// Kept for existing callers.
+#define RING_PAUSE() ::ring::cpu_relax()
@@ -0,0 +1,316 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "backoff.hpp"
+#include "memory.hpp"
+#include "overflow.hpp"
+#include "park.hpp"
+#include "stats.hpp"
+#include "utils.hpp"
+
+namespace ring {
+
+// Single-writer / multi-reader broadcast ring (disruptor style): every
+// reader sees every item, in order.
+//
+// The writer owns one sequence (published_); each of the `readers` readers,
+// fixed at construction and addressed by index 0..readers-1, owns a
+// cache-padded cursor holding the next sequence it will read. The writer
+// may run at most capacity items ahead of the slowest cursor (it caches
+// that minimum and only rescans the cursors when the cache says full);
+// readers may consume everything up to published_ in one batch and move
+// their cursor once per batch. Slots need no tickets: published_ orders
+// the payload writes, the cursors order the reuse.
+//
+// Readers get const access to shared items (copy out with try_read /
+// read_many, or in place with poll); the writer destroys an item when it
+// reuses the slot, and the ring destroys whatever is still resident.
+//
+// Overflow (overflow.hpp) decides what publish / publish_many do when the
+// slowest reader is a full ring behind. Under OverwriteOldest the writer
+// never looks at the cursors: every slot gets a generation word (sequence
+// + 1 of its item, seqlock style), readers copy an item out and re-check
+// the generation, and a reader that was lapped skips ahead to the oldest
+// item still in the ring, adding what it missed to lost(r) and to the
+// dropped counter. That mode needs a trivially copyable T.
+template <class T, class Backoff = DefaultBackoff, class Stats = NoStats, class Overflow = BlockOnFull>
+class BroadcastRing {
+    using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+    using Gen     = std::atomic<std::uint64_t>;
+
+    static constexpr bool kOverwrite = Overflow::action == OverflowAction::OverwriteOldest;
+    static constexpr std::uint64_t kWriting = ~std::uint64_t{0}; // generation while a slot is rewritten
+
+    static_assert(!kOverwrite || std::is_trivially_copyable_v<T>,
+                  "BroadcastRing<T, ..., OverwriteOldest>: T must be trivially copyable");
+
+    struct alignas(64) Cursor {
+        std::atomic<std::uint64_t> seq{0};
+        std::atomic<std::uint64_t> lost{0}; // OverwriteOldest: items skipped after a lap
+    };
+
+public:
+    using value_type    = T;
+    using backoff_type  = Backoff;
+    using stats_type    = Stats;
+    using overflow_type = Overflow;
+
+    // alloc decides where slot storage lives (heap by default; see numa.hpp).
+    BroadcastRing(std::size_t capacity, std::size_t readers, const SlotAllocator& alloc = {})
+        : capacity_(next_pow2(capacity)),
+          mask_(capacity_ - 1),
+          readers_(readers ? readers : throw std::invalid_argument("BroadcastRing: needs at least one reader")),
+          alloc_(alloc),
+          cursors_(new Cursor[readers]),
+          gens_(kOverwrite ? new Gen[capacity_]() : nullptr),
+          slots_(static_cast<Storage*>(alloc_.allocate(alloc_, capacity_ * sizeof(Storage), alignof(Storage))))
+    {}
+
+    ~BroadcastRing() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            const std::uint64_t end = published_.load(RELAXED);
+            for (std::uint64_t s = end > capacity_ ? end - capacity_ : 0; s < end; ++s) at(s)->~T();
+        }
+        alloc_.deallocate(alloc_, slots_, capacity_ * sizeof(Storage), alignof(Storage));
+    }
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    std::size_t capacity() const noexcept { return capacity_; }
+    std::size_t readers() const noexcept { return readers_; }
+
+    // -------- Writer (one thread) --------
+
+    bool try_publish(const T& v) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        if (free_slots(1) == 0) { stats_.full(); return false; }
+        put(next_, v);
+        publish_to(next_ + 1, 1);
+        return true;
+    }
+
+    bool try_publish(T&& v) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (free_slots(1) == 0) { stats_.full(); return false; }
+        put(next_, std::move(v));
+        publish_to(next_ + 1, 1);
+        return true;
+    }
+
+    // Returns how many of data[0..n) were published (0 if the slowest
+    // reader is a full ring behind); one release store for the batch.
+    std::size_t try_publish_many(const T* data, std::size_t n) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        const std::size_t k = free_slots(n);
+        if (k < n) stats_.full();
+        for (std::size_t i = 0; i < k; ++i) put(next_ + i, data[i]);
+        if (k) publish_to(next_ + k, k);
+        return k;
+    }
+
+    // BlockOnFull parks while the slowest reader gates the writer; the other
+    // policies never wait. Returns false when FailOnFull / DropNewest turned
+    // the item away.
+    bool publish(const T& v) { return publish_one(v); }
+    bool publish(T&& v) { return publish_one(std::move(v)); }
+
+    // BlockOnFull waits (per Backoff) until all of data[0..n) is published;
+    // FailOnFull / DropNewest publish what fits; OverwriteOldest publishes
+    // everything. Returns the number published.
+    std::size_t publish_many(const T* data, std::size_t n) {
+        std::size_t done = 0;
+        if constexpr (Overflow::action == OverflowAction::Block) {
+            Backoff backoff;
+            while (done < n) {
+                done += try_publish_many(data + done, n - done);
+                if (done < n) {
+                    const std::atomic<std::uint64_t>& gate = slowest_cursor();
+                    stats_.backoff(backoff_wait(backoff, gate, gate.load(RELAXED)));
+                }
+            }
+        } else {
+            done = try_publish_many(data, n);
+            if constexpr (Overflow::action == OverflowAction::DropNewest) {
+                if (done < n) stats_.dropped(n - done);
+            }
+        }
+        return done;
+    }
+
+    // Items published so far (the writer's sequence).
+    std::uint64_t published() const noexcept { return published_.load(ACQUIRE); }
+
+    // -------- Readers (one thread per reader index) --------
+
+    bool try_read(std::size_t r, T& out) {
+        return poll(r, [&](const T& v) { out = v; }, 1) == 1;
+    }
+
+    void read(std::size_t r, T& out) { not_empty_.await([&] { return try_read(r, out); }); }
+
+    // Copies up to n available items into out; returns how many.
+    std::size_t read_many(std::size_t r, T* out, std::size_t n) {
+        std::size_t k = 0;
+        poll(r, [&](const T& v) { out[k++] = v; }, n);
+        return k;
+    }
+
+    // Batch read: calls fn(const T&) for every item this reader has not seen
+    // yet, up to max and up to the published sequence at entry, then moves
+    // the cursor past all of them at once. Returns the count. Items are read
+    // in place, except under OverwriteOldest where fn gets a validated copy.
+    template <class Fn>
+    std::size_t poll(std::size_t r, Fn&& fn, std::size_t max = static_cast<std::size_t>(-1)) {
+        std::atomic<std::uint64_t>& c = cursors_[r].seq;
+        std::uint64_t s = c.load(RELAXED);
+        std::size_t k = 0;
+        if constexpr (kOverwrite) {
+            const std::uint64_t start = s;
+            std::uint64_t end = published_.load(ACQUIRE);
+            while (k < max && s != end) {
+                if (end - s > capacity_) { s = skip(r, s, end - capacity_); continue; }
+                Storage copy;
+                if (!load_item(s, copy)) { // lapped while reading: re-read where the writer is
+                    end = published_.load(ACQUIRE);
+                    s = skip(r, s, (end - s > capacity_) ? end - capacity_ : s + 1);
+                    continue;
+                }
+                fn(*std::launder(reinterpret_cast<const T*>(&copy)));
+                ++s; ++k;
+            }
+            if (s != start) c.store(s, RELEASE);
+        } else {
+            const std::uint64_t avail = published_.load(ACQUIRE) - s;
+            k = avail < max ? static_cast<std::size_t>(avail) : max;
+            for (std::size_t i = 0; i < k; ++i) fn(static_cast<const T&>(*at(s + i)));
+            if (k) {
+                c.store(s + k, RELEASE); // our reads of the items happen-before the slots' reuse
+                not_full_.notify();
+            }
+        }
+        if (k) stats_.dequeued(k);
+        return k;
+    }
+
+    // Items reader r has yet to read (under OverwriteOldest at most
+    // capacity of them are still in the ring).
+    std::size_t backlog(std::size_t r) const noexcept {
+        return static_cast<std::size_t>(published_.load(ACQUIRE) - cursors_[r].seq.load(RELAXED));
+    }
+
+    // OverwriteOldest: items reader r never saw because the writer lapped it.
+    std::uint64_t lost(std::size_t r) const noexcept { return cursors_[r].lost.load(RELAXED); }
+
+    // Counters since construction / reset_stats(); all zero with NoStats.
+    RingStatsSnapshot stats() const noexcept { return stats_.snapshot(); }
+    void reset_stats() noexcept { stats_.reset(); }
+
+private:
+    T* at(std::uint64_t s) const noexcept {
+        return std::launder(reinterpret_cast<T*>(&slots_[static_cast<std::size_t>(s) & mask_]));
+    }
+
+    template <class U>
+    bool publish_one(U&& v) {
+        if constexpr (Overflow::action == OverflowAction::Block) {
+            not_full_.await([&] { return try_publish(std::forward<U>(v)); });
+            return true;
+        } else {
+            if (try_publish(std::forward<U>(v))) return true;
+            if constexpr (Overflow::action == OverflowAction::DropNewest) stats_.dropped(1);
+            return false;
+        }
+    }
+
+    // Writer: up to n free slots from next_, rescanning the cursors only
+    // when the cached minimum says there are fewer than n.
+    std::size_t free_slots(std::size_t n) noexcept {
+        if constexpr (kOverwrite) return n;
+        std::uint64_t free = gate_cache_ + capacity_ - next_;
+        if (free < n) {
+            std::uint64_t min = cursors_[0].seq.load(ACQUIRE);
+            for (std::size_t i = 1; i < readers_; ++i) {
+                const std::uint64_t c = cursors_[i].seq.load(ACQUIRE);
+                if (c < min) min = c;
+            }
+            gate_cache_ = min;
+            free = gate_cache_ + capacity_ - next_;
+        }
+        return static_cast<std::size_t>(free < n ? free : n);
+    }
+
+    // Writer: the cursor last seen slowest (a reasonable word to back off on).
+    const std::atomic<std::uint64_t>& slowest_cursor() const noexcept {
+        std::size_t slow = 0;
+        for (std::size_t i = 1; i < readers_; ++i) {
+            if (cursors_[i].seq.load(RELAXED) < cursors_[slow].seq.load(RELAXED)) slow = i;
+        }
+        return cursors_[slow].seq;
+    }
+
+    template <class U>
+    void put(std::uint64_t s, U&& v) {
+        T* p = at(s);
+        if constexpr (kOverwrite) {
+            Gen& g = gens_[static_cast<std::size_t>(s) & mask_];
+            g.store(kWriting, RELAXED);
+            std::atomic_thread_fence(std::memory_order_release); // a reader that sees our bytes sees kWriting
+            *p = std::forward<U>(v);
+            g.store(s + 1, RELEASE);
+        } else {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                if (s >= capacity_) p->~T(); // every reader is past s - capacity
+            }
+            new (p) T(std::forward<U>(v));
+        }
+    }
+
+    // OverwriteOldest reader: copies item s out of its slot; false if the
+    // writer rewrote the slot before or during the copy.
+    bool load_item(std::uint64_t s, Storage& out) const noexcept {
+        const Gen& g = gens_[static_cast<std::size_t>(s) & mask_];
+        if (g.load(ACQUIRE) != s + 1) return false;
+        std::memcpy(&out, &slots_[static_cast<std::size_t>(s) & mask_], sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return g.load(RELAXED) == s + 1;
+    }
+
+    std::uint64_t skip(std::size_t r, std::uint64_t from, std::uint64_t to) noexcept {
+        cursors_[r].lost.fetch_add(to - from, RELAXED); // reader-owned
+        stats_.dropped(static_cast<std::size_t>(to - from));
+        return to;
+    }
+
+    void publish_to(std::uint64_t end, std::size_t n) noexcept {
+        next_ = end;
+        published_.store(end, RELEASE);
+        not_empty_.notify();
+        stats_.enqueued(n);
+    }
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    const std::size_t readers_;
+    const SlotAllocator alloc_;
+    std::unique_ptr<Cursor[]> cursors_;
+    std::unique_ptr<Gen[]> gens_; // OverwriteOldest only
+    Storage* const slots_;        // allocated last: nothing after it can throw and leak it
+
+    alignas(64) std::atomic<std::uint64_t> published_{0};
+    CachePad _pad1_;
+    alignas(64) std::uint64_t next_ = 0;       // writer-owned copy of published_
+    std::uint64_t             gate_cache_ = 0; // writer-owned: min cursor last seen
+    CachePad _pad2_;
+
+    alignas(64) EventCount not_empty_; // readers park here
+    alignas(64) EventCount not_full_;  // writer parks here
+
+    [[no_unique_address]] Stats stats_;
+};
+
+} // namespace ring
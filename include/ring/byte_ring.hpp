@@ -0,0 +1,424 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "backoff.hpp"
+#include "memory.hpp"
+#include "park.hpp"
+#include "utils.hpp"
+
+namespace ring {
+
+// -------- Variable-length records --------
+// Byte rings keep messages of any length back to back in one buffer, each
+// behind an 8-byte header, instead of one fixed-size T per slot: no
+// per-message heap allocation (the std::vector payload of cpu_demo.cpp)
+// and no padding to the worst case, so small messages pack several to a
+// cache line. Positions are monotonic byte counts like the slot tickets;
+// a record that would straddle the end of the buffer is moved to its start
+// behind a padding record that readers skip.
+//
+// Header word (bits): 0..31 payload length, 32 padding, 33 consumed (MPMC).
+// A record spans align_up(8 + length, 8) bytes, so payloads are 8-byte
+// aligned; records are at most max_message() = capacity / 2 - 8 bytes.
+
+// A producer's claim: write up to size bytes at data, then commit().
+struct ByteReservation {
+    std::byte*    data  = nullptr;
+    std::size_t   size  = 0;
+    std::uint64_t pos   = 0; // record header position
+    std::uint64_t begin = 0; // first reserved byte (pos, or the padding before it)
+
+    explicit operator bool() const noexcept { return data != nullptr; }
+};
+
+// A consumer's claim: the payload, read in place until release().
+struct ByteRecord {
+    const std::byte* data = nullptr;
+    std::size_t      size = 0;
+    std::uint64_t    pos  = 0;
+
+    explicit operator bool() const noexcept { return data != nullptr; }
+    std::span<const std::byte> bytes() const noexcept { return { data, size }; }
+
+    // The message written by try_emplace<M>.
+    template <class M>
+    const M& as() const noexcept { return *std::launder(reinterpret_cast<const M*>(data)); }
+};
+
+namespace detail {
+
+// Buffer (from a SlotAllocator) and header arithmetic shared by both rings.
+class ByteBuffer {
+public:
+    static constexpr std::size_t   kHeader   = sizeof(std::uint64_t);
+    static constexpr std::size_t   kAlign    = 8;
+    static constexpr std::uint64_t kLength   = 0xFFFF'FFFFull;
+    static constexpr std::uint64_t kPadding  = std::uint64_t{1} << 32;
+    static constexpr std::uint64_t kConsumed = std::uint64_t{1} << 33;
+
+    ByteBuffer(std::size_t capacity, const SlotAllocator& alloc)
+        : alloc_(alloc),
+          capacity_(next_pow2(capacity < 64 ? 64 : capacity)),
+          mask_(capacity_ - 1),
+          base_(static_cast<std::byte*>(alloc_.allocate(alloc_, capacity_, 64)))
+    {}
+
+    ~ByteBuffer() { alloc_.deallocate(alloc_, base_, capacity_, 64); }
+
+    ByteBuffer(const ByteBuffer&) = delete;
+    ByteBuffer& operator=(const ByteBuffer&) = delete;
+
+    std::size_t capacity() const noexcept { return capacity_; }
+
+    std::size_t max_message() const noexcept {
+        const std::size_t m = capacity_ / 2 - kHeader;
+        return m < kLength ? m : static_cast<std::size_t>(kLength);
+    }
+
+    static constexpr std::size_t span_of(std::size_t len) noexcept { return (kHeader + len + kAlign - 1) & ~(kAlign - 1); }
+    static constexpr std::size_t length(std::uint64_t word) noexcept { return static_cast<std::size_t>(word & kLength); }
+
+    // Padding needed at pos before a record of span bytes: the rest of the
+    // buffer if the record would straddle its end, else 0.
+    std::size_t padding_before(std::uint64_t pos, std::size_t span) const noexcept {
+        const std::size_t off = static_cast<std::size_t>(pos) & mask_;
+        return (off + span > capacity_) ? capacity_ - off : 0;
+    }
+
+    std::atomic_ref<std::uint64_t> header(std::uint64_t pos) noexcept {
+        return std::atomic_ref<std::uint64_t>(*reinterpret_cast<std::uint64_t*>(base_ + (static_cast<std::size_t>(pos) & mask_)));
+    }
+
+    std::byte* payload(std::uint64_t pos) noexcept { return base_ + (static_cast<std::size_t>(pos) & mask_) + kHeader; }
+
+    void write_padding(std::uint64_t pos, std::size_t pad) noexcept { header(pos).store((pad - kHeader) | kPadding, RELAXED); }
+
+private:
+    const SlotAllocator alloc_;
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::byte* base_;
+};
+
+} // namespace detail
+
+// Single-producer / single-consumer byte ring. capacity_bytes is rounded up
+// to a power of two (at least 64). The consumer hands records back in
+// order, so head_ alone tells the producer how much room there is.
+template <class Backoff = DefaultBackoff>
+class ByteRingSPSC {
+    using Buf = detail::ByteBuffer;
+
+public:
+    explicit ByteRingSPSC(std::size_t capacity_bytes, const SlotAllocator& alloc = {})
+        : buf_(capacity_bytes, alloc), head_(0), tail_(0) {}
+
+    ByteRingSPSC(const ByteRingSPSC&) = delete;
+    ByteRingSPSC& operator=(const ByteRingSPSC&) = delete;
+
+    std::size_t capacity() const noexcept { return buf_.capacity(); }
+    std::size_t max_message() const noexcept { return buf_.max_message(); }
+
+    // Bytes in use (records, headers and padding).
+    std::size_t size_bytes() const noexcept { return static_cast<std::size_t>(tail_.load(ACQUIRE) - head_.load(ACQUIRE)); }
+    bool empty() const noexcept { return size_bytes() == 0; }
+
+    // -------- Producer (one thread) --------
+
+    // Room for a bytes-long message, or an empty reservation when full or
+    // bytes > max_message(). Nothing is visible to the consumer until
+    // commit(); an uncommitted reservation may simply be abandoned.
+    ByteReservation reserve(std::size_t bytes) noexcept {
+        if (bytes > buf_.max_message()) return {};
+        const std::uint64_t t = tail_.load(RELAXED);
+        const std::size_t span = Buf::span_of(bytes), pad = buf_.padding_before(t, span);
+        if (t + pad + span > head_cache_ + buf_.capacity()) {
+            head_cache_ = head_.load(ACQUIRE);
+            if (t + pad + span > head_cache_ + buf_.capacity()) return {};
+        }
+        if (pad) buf_.write_padding(t, pad); // published along with the record
+        return { buf_.payload(t + pad), bytes, t + pad, t };
+    }
+
+    void commit(const ByteReservation& r) noexcept {
+        buf_.header(r.pos).store(r.size, RELAXED);
+        tail_.store(r.pos + Buf::span_of(r.size), RELEASE);
+        not_empty_.notify();
+    }
+
+    bool try_write(const void* data, std::size_t bytes) noexcept {
+        const ByteReservation r = reserve(bytes);
+        if (!r) return false;
+        if (bytes) std::memcpy(r.data, data, bytes); // data may be null for an empty record
+        commit(r);
+        return true;
+    }
+
+    // Blocking; false only when bytes > max_message().
+    bool write(const void* data, std::size_t bytes) noexcept {
+        if (bytes > buf_.max_message()) return false;
+        not_full_.await([&] { return try_write(data, bytes); });
+        return true;
+    }
+
+    // Constructs an M in a record of sizeof(M) bytes (read back with as<M>()).
+    template <class M, class... Args>
+    bool try_emplace(Args&&... args) noexcept {
+        static_assert(std::is_trivially_copyable_v<M> && alignof(M) <= Buf::kAlign,
+                      "ByteRing messages are trivially copyable, at most 8-byte aligned");
+        const ByteReservation r = reserve(sizeof(M));
+        if (!r) return false;
+        new (r.data) M{std::forward<Args>(args)...};
+        commit(r);
+        return true;
+    }
+
+    // -------- Consumer (one thread) --------
+
+    // The oldest record, read in place, or an empty record; release() it
+    // before the next peek().
+    ByteRecord peek() noexcept {
+        std::uint64_t h = head_.load(RELAXED);
+        for (;;) {
+            if (h == tail_cache_) {
+                tail_cache_ = tail_.load(ACQUIRE);
+                if (h == tail_cache_) return {};
+            }
+            const std::uint64_t w = buf_.header(h).load(RELAXED);
+            if (!(w & Buf::kPadding)) return { buf_.payload(h), Buf::length(w), h };
+            h += Buf::span_of(Buf::length(w));
+            head_.store(h, RELEASE); // hand the padding back right away
+        }
+    }
+
+    void release(const ByteRecord& r) noexcept {
+        head_.store(r.pos + Buf::span_of(r.size), RELEASE);
+        not_full_.notify();
+    }
+
+    // Calls f(const ByteRecord&) for up to max records, then hands all of
+    // them back with one head_ store; returns the count.
+    template <class F>
+    std::size_t consume(F&& f, std::size_t max = std::numeric_limits<std::size_t>::max()) {
+        std::uint64_t h = head_.load(RELAXED);
+        std::size_t n = 0;
+        while (n < max) {
+            if (h == tail_cache_) {
+                tail_cache_ = tail_.load(ACQUIRE);
+                if (h == tail_cache_) break;
+            }
+            const std::uint64_t w = buf_.header(h).load(RELAXED);
+            if (!(w & Buf::kPadding)) {
+                f(ByteRecord{ buf_.payload(h), Buf::length(w), h });
+                ++n;
+            }
+            h += Buf::span_of(Buf::length(w));
+        }
+        if (h != head_.load(RELAXED)) { head_.store(h, RELEASE); not_full_.notify(); }
+        return n;
+    }
+
+    template <class F>
+    bool try_read(F&& f) {
+        const ByteRecord r = peek();
+        if (!r) return false;
+        f(r);
+        release(r);
+        return true;
+    }
+
+    // Blocking: parks until the producer commits.
+    template <class F>
+    void read(F&& f) { not_empty_.await([&] { return try_read(f); }); }
+
+private:
+    Buf buf_;
+
+    alignas(64) std::atomic<std::uint64_t> head_;
+    std::uint64_t tail_cache_ = 0; // consumer-owned
+    CachePad _pad1_;
+    alignas(64) std::atomic<std::uint64_t> tail_;
+    std::uint64_t head_cache_ = 0; // producer-owned
+    CachePad _pad2_;
+
+    alignas(64) EventCount not_empty_;
+    alignas(64) EventCount not_full_;
+};
+
+// Multi-producer / multi-consumer byte ring. Three monotonic cursors:
+//   tail_      producers reserve [tail_, tail_ + bytes) by CAS
+//   committed_ records below it are complete; producers commit in
+//              reservation order (a producer waits, per Backoff, for the
+//              ones ahead of it), so readers never look at a header that
+//              is still being written
+//   head_      consumers claim the record at head_ by CAS
+// and released_, up to which consumers have handed bytes back. Claimed
+// records may be released in any order: release() sets the consumed bit
+// and whoever finds the run at released_ consumed moves released_ past it.
+//
+// A consumer or sweeper holding a stale position may read a header that
+// is being rewritten; its CAS then fails on the moved cursor and the
+// value is dropped (the usual seqlock-style tolerated race).
+template <class Backoff = DefaultBackoff>
+class ByteRingMPMC {
+    using Buf = detail::ByteBuffer;
+
+public:
+    explicit ByteRingMPMC(std::size_t capacity_bytes, const SlotAllocator& alloc = {})
+        : buf_(capacity_bytes, alloc), tail_(0), committed_(0), head_(0), released_(0) {}
+
+    ByteRingMPMC(const ByteRingMPMC&) = delete;
+    ByteRingMPMC& operator=(const ByteRingMPMC&) = delete;
+
+    std::size_t capacity() const noexcept { return buf_.capacity(); }
+    std::size_t max_message() const noexcept { return buf_.max_message(); }
+
+    // Bytes not yet handed back; approximate while either side is active.
+    std::size_t size_bytes() const noexcept {
+        const std::uint64_t r = released_.load(ACQUIRE), t = tail_.load(ACQUIRE);
+        return t > r ? static_cast<std::size_t>(t - r) : 0;
+    }
+    bool empty() const noexcept { return committed_.load(ACQUIRE) == head_.load(ACQUIRE); }
+
+    // -------- Producers (any number) --------
+
+    // As ByteRingSPSC::reserve, except that a reservation must be
+    // committed: later producers' commits wait for it.
+    ByteReservation reserve(std::size_t bytes) noexcept {
+        if (bytes > buf_.max_message()) return {};
+        const std::size_t span = Buf::span_of(bytes);
+        std::uint64_t t = tail_.load(RELAXED);
+        for (;;) {
+            const std::size_t pad = buf_.padding_before(t, span);
+            if (t + pad + span > released_.load(ACQUIRE) + buf_.capacity()) {
+                const std::uint64_t now = tail_.load(RELAXED);
+                if (now == t) return {}; // full
+                t = now;
+                continue;
+            }
+            if (tail_.compare_exchange_weak(t, t + pad + span, ACQ_REL, RELAXED)) {
+                if (pad) buf_.write_padding(t, pad);
+                return { buf_.payload(t + pad), bytes, t + pad, t };
+            }
+        }
+    }
+
+    void commit(const ByteReservation& r) noexcept {
+        buf_.header(r.pos).store(r.size, RELAXED);
+        Backoff backoff;
+        for (std::uint64_t c = committed_.load(ACQUIRE); c != r.begin; c = committed_.load(ACQUIRE)) {
+            backoff_wait(backoff, committed_, c);
+        }
+        committed_.store(r.pos + Buf::span_of(r.size), RELEASE);
+        not_empty_.notify();
+    }
+
+    bool try_write(const void* data, std::size_t bytes) noexcept {
+        const ByteReservation r = reserve(bytes);
+        if (!r) return false;
+        if (bytes) std::memcpy(r.data, data, bytes); // data may be null for an empty record
+        commit(r);
+        return true;
+    }
+
+    bool write(const void* data, std::size_t bytes) noexcept {
+        if (bytes > buf_.max_message()) return false;
+        not_full_.await([&] { return try_write(data, bytes); });
+        return true;
+    }
+
+    template <class M, class... Args>
+    bool try_emplace(Args&&... args) noexcept {
+        static_assert(std::is_trivially_copyable_v<M> && alignof(M) <= Buf::kAlign,
+                      "ByteRing messages are trivially copyable, at most 8-byte aligned");
+        const ByteReservation r = reserve(sizeof(M));
+        if (!r) return false;
+        new (r.data) M{std::forward<Args>(args)...};
+        commit(r);
+        return true;
+    }
+
+    // -------- Consumers (any number) --------
+
+    // Claims the oldest unclaimed record for in-place reads, or returns an
+    // empty record. Other consumers go on past it; its bytes return to
+    // producers once it and every record before it are released.
+    ByteRecord peek() noexcept {
+        std::uint64_t h = head_.load(RELAXED);
+        for (;;) {
+            if (h == committed_.load(ACQUIRE)) return {};
+            const std::uint64_t w = buf_.header(h).load(RELAXED);
+            const std::uint64_t next = h + Buf::span_of(Buf::length(w));
+            if (head_.compare_exchange_weak(h, next, ACQ_REL, RELAXED)) {
+                if (!(w & Buf::kPadding)) return { buf_.payload(h), Buf::length(w), h };
+                retire(h);
+                h = next;
+            }
+        }
+    }
+
+    void release(const ByteRecord& r) noexcept { retire(r.pos); }
+
+    // peek / f / release for up to max records; returns the count.
+    template <class F>
+    std::size_t consume(F&& f, std::size_t max = std::numeric_limits<std::size_t>::max()) {
+        std::size_t n = 0;
+        for (; n < max; ++n) {
+            const ByteRecord r = peek();
+            if (!r) break;
+            f(r);
+            release(r);
+        }
+        return n;
+    }
+
+    template <class F>
+    bool try_read(F&& f) { return consume(f, 1) == 1; }
+
+    template <class F>
+    void read(F&& f) { not_empty_.await([&] { return try_read(f); }); }
+
+private:
+    // Marks the claimed record at pos consumed, then moves released_ over
+    // the consumed run in front of it. The fence pairs with the one of a
+    // concurrent releaser: of two neighbours released at once, at least
+    // one sees the other's bit, so no consumed run is left unswept.
+    void retire(std::uint64_t pos) noexcept {
+        std::atomic_ref<std::uint64_t> h = buf_.header(pos);
+        h.store(h.load(RELAXED) | Buf::kConsumed, RELEASE);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        bool freed = false;
+        std::uint64_t r = released_.load(ACQUIRE);
+        while (r != head_.load(ACQUIRE)) { // [released_, head_) is claimed
+            const std::uint64_t w = buf_.header(r).load(ACQUIRE);
+            if (!(w & Buf::kConsumed)) break;
+            const std::uint64_t next = r + Buf::span_of(Buf::length(w));
+            if (released_.compare_exchange_weak(r, next, ACQ_REL, ACQUIRE)) { r = next; freed = true; }
+        }
+        if (freed) not_full_.notify();
+    }
+
+    Buf buf_;
+
+    alignas(64) std::atomic<std::uint64_t> tail_;
+    CachePad _pad1_;
+    alignas(64) std::atomic<std::uint64_t> committed_;
+    CachePad _pad2_;
+    alignas(64) std::atomic<std::uint64_t> head_;
+    CachePad _pad3_;
+    alignas(64) std::atomic<std::uint64_t> released_;
+    CachePad _pad4_;
+
+    alignas(64) EventCount not_empty_; // consumers park here
+    alignas(64) EventCount not_full_;  // producers park here
+};
+
+} // namespace ring
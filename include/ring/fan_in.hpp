@@ -0,0 +1,165 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "backoff.hpp"
+#include "memory.hpp"
+#include "park.hpp"
+#include "ring_spsc.hpp"
+
+namespace ring {
+
+// Many producers, one consumer, no shared producer index: producer p owns
+// lane p (a RingSPSC) and the consumer sweeps the lanes round robin,
+// taking a batch from each. Producers never contend with each other, only
+// with the consumer on their own lane. Items keep FIFO order per producer;
+// across producers the plain sweep gives no order, dequeue_ordered() does
+// a k-way merge on a key (e.g. a send timestamp) for sequenced feeds.
+//
+// Each producer index must be used by one thread at a time (it is an SPSC
+// ring underneath), and all dequeue calls must come from one thread.
+template <class T, class Layout = PaddedLayout, class Backoff = DefaultBackoff>
+class FanInRing {
+public:
+    using lane_type = RingSPSC<T, Layout, Backoff>;
+
+    // Producers go through producer(p) rather than calling the ring (see
+    // bench_core.hpp, which keys off this).
+    static constexpr bool per_producer_lanes = true;
+
+    // Producer-side handle: enqueue ops of lane p that also wake a parked
+    // consumer.
+    class Producer {
+    public:
+        bool try_enqueue(const T& v) noexcept { return woke(lane_.try_enqueue(v)); }
+        bool try_enqueue(T&& v) noexcept { return woke(lane_.try_enqueue(std::move(v))); }
+        std::size_t try_enqueue_many(const T* data, std::size_t n) noexcept { return woke(lane_.try_enqueue_many(data, n)); }
+
+        // Wait for room in this lane only (per the lane's park / Backoff).
+        void enqueue(const T& v) noexcept { lane_.enqueue(v); owner_.not_empty_.notify(); }
+        void enqueue(T&& v) noexcept { lane_.enqueue(std::move(v)); owner_.not_empty_.notify(); }
+        std::size_t enqueue_many(const T* data, std::size_t n) noexcept { return woke(lane_.enqueue_many(data, n)); }
+
+        // Read-only (size, capacity): writes must go through the handle so
+        // the consumer gets woken.
+        const lane_type& lane() const noexcept { return lane_; }
+
+    private:
+        friend class FanInRing;
+        Producer(FanInRing& owner, std::size_t capacity, const SlotAllocator& alloc)
+            : owner_(owner), lane_(capacity, alloc) {}
+
+        template <class R>
+        R woke(R r) noexcept {
+            if (r) owner_.not_empty_.notify();
+            return r;
+        }
+
+        FanInRing& owner_;
+        lane_type  lane_;
+    };
+
+    // One lane of capacity_per_producer slots per producer.
+    FanInRing(std::size_t producers, std::size_t capacity_per_producer, const SlotAllocator& alloc = {}) {
+        if (producers == 0) producers = 1;
+        for (std::size_t p = 0; p < producers; ++p) {
+            lanes_.push_back(std::unique_ptr<Producer>(new Producer(*this, capacity_per_producer, alloc)));
+        }
+        heads_.resize(producers);
+    }
+
+    FanInRing(const FanInRing&) = delete;
+    FanInRing& operator=(const FanInRing&) = delete;
+
+    std::size_t producers() const noexcept { return lanes_.size(); }
+    std::size_t capacity_per_producer() const noexcept { return lanes_[0]->lane_.capacity(); }
+
+    Producer& producer(std::size_t p) noexcept { return *lanes_[p]; }
+
+    // -------- Consumer (one thread) --------
+
+    // Round-robin sweep: starting after the lane the previous call stopped
+    // at, takes whatever each lane has until n items are out or every lane
+    // was visited once. One cached index refresh per lane visited. A lane
+    // it takes from drops the head key dequeue_ordered() cached for it.
+    std::size_t dequeue_many(T* out, std::size_t n) noexcept {
+        const std::size_t lanes = lanes_.size();
+        std::size_t got = 0;
+        for (std::size_t k = 0; k < lanes && got < n; ++k) {
+            const std::size_t i = next_lane_;
+            next_lane_ = (i + 1 == lanes) ? 0 : i + 1;
+            const std::size_t took = lanes_[i]->lane_.dequeue_many(out + got, n - got);
+            if (took) { heads_[i].valid = false; got += took; }
+        }
+        return got;
+    }
+
+    bool try_dequeue(T& out) noexcept { return dequeue_many(&out, 1) == 1; }
+
+    // Blocking: parks until some producer enqueues.
+    void dequeue(T& out) noexcept { not_empty_.await([&] { return try_dequeue(out); }); }
+
+    template <class Rep, class Period>
+    bool dequeue_for(T& out, const std::chrono::duration<Rep, Period>& timeout) noexcept {
+        return not_empty_.await_until([&] { return try_dequeue(out); }, std::chrono::steady_clock::now() + timeout);
+    }
+
+    // K-way merge: up to n items in ascending key(item) order, key being an
+    // unsigned integer such as a send timestamp that each producer emits in
+    // ascending order. strict = true only emits while every lane has an item
+    // waiting, so nothing with a smaller key can still arrive; a lane whose
+    // producer has gone quiet therefore stalls the merge, and strict = false
+    // flushes what is there (e.g. once producers are done). Ties go to the
+    // lower lane.
+    template <class Key>
+    std::size_t dequeue_ordered(T* out, std::size_t n, Key&& key, bool strict = true) {
+        std::size_t got = 0;
+        while (got < n) {
+            std::size_t best = lanes_.size();
+            bool best_set = false;
+            std::uint64_t best_key = 0;
+            for (std::size_t i = 0; i < lanes_.size(); ++i) {
+                Head& h = heads_[i];
+                if (!h.valid) {
+                    auto r = lanes_[i]->lane_.peek(1);
+                    if (r.empty()) {
+                        if (strict) return got;
+                        continue;
+                    }
+                    h.key = static_cast<std::uint64_t>(key(static_cast<const T&>(*r[0])));
+                    h.valid = true;
+                }
+                if (!best_set || h.key < best_key) { best = i; best_key = h.key; best_set = true; }
+            }
+            if (!best_set) break;
+            lanes_[best]->lane_.try_dequeue(out[got++]);
+            heads_[best].valid = false;
+        }
+        return got;
+    }
+
+    // Sum of lane sizes; approximate while producers are active.
+    std::size_t size() const noexcept {
+        std::size_t s = 0;
+        for (const auto& l : lanes_) s += l->lane_.size();
+        return s;
+    }
+
+private:
+    struct Head {             // consumer-owned: key of lane i's first item
+        std::uint64_t key   = 0;
+        bool          valid = false;
+    };
+
+    std::vector<std::unique_ptr<Producer>> lanes_;
+    std::vector<Head> heads_;
+    std::size_t next_lane_ = 0; // consumer-owned sweep position
+
+    alignas(64) EventCount not_empty_; // consumer parks here
+};
+
+} // namespace ring
@@ -0,0 +1,99 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include "utils.hpp"
+
+namespace ring {
+
+// Hazard pointers (Michael 2004) for the few structures that unlink and
+// reuse nodes other threads may still be reading (linked_ring.hpp).
+//
+// One process-wide list of records, each holding kHazardsPerThread
+// pointers. A thread takes a free record on first use and hands it back
+// when it exits, so the list only grows to the peak number of threads that
+// used hazards at once; records are never freed. protect() publishes a
+// pointer before it is dereferenced; a node may only be reused once
+// is_hazard() says no record holds it.
+constexpr std::size_t kHazardsPerThread = 2;
+
+struct alignas(64) HazardRecord {
+    std::atomic<const void*> ptr[kHazardsPerThread] = {};
+    std::atomic<bool>        active{false};
+    HazardRecord*            next = nullptr; // immutable once linked
+};
+
+namespace detail {
+
+inline std::atomic<HazardRecord*>& hazard_list() noexcept {
+    static std::atomic<HazardRecord*> head{nullptr};
+    return head;
+}
+
+inline HazardRecord* acquire_hazard_record() {
+    std::atomic<HazardRecord*>& head = hazard_list();
+    for (HazardRecord* r = head.load(ACQUIRE); r; r = r->next) {
+        bool idle = false;
+        if (!r->active.load(RELAXED) && r->active.compare_exchange_strong(idle, true, ACQ_REL)) return r;
+    }
+    auto* r = new HazardRecord;
+    r->active.store(true, RELAXED);
+    HazardRecord* old = head.load(RELAXED);
+    do { r->next = old; } while (!head.compare_exchange_weak(old, r, RELEASE, RELAXED));
+    return r;
+}
+
+struct HazardOwner {
+    HazardRecord* rec = acquire_hazard_record();
+    ~HazardOwner() {
+        for (auto& p : rec->ptr) p.store(nullptr, RELAXED);
+        rec->active.store(false, RELEASE);
+    }
+};
+
+} // namespace detail
+
+// The calling thread's record.
+inline HazardRecord& this_thread_hazards() {
+    thread_local detail::HazardOwner owner;
+    return *owner.rec;
+}
+
+// Loads src into hazard slot i and re-checks src until the published
+// pointer is the current one; the result stays safe to dereference until
+// the slot is cleared or overwritten.
+template <class N>
+N* protect(std::atomic<N*>& src, HazardRecord& rec, std::size_t i = 0) noexcept {
+    N* p = src.load(ACQUIRE);
+    for (;;) {
+        rec.ptr[i].store(p, std::memory_order_seq_cst);
+        N* q = src.load(std::memory_order_seq_cst);
+        if (q == p) return p;
+        p = q;
+    }
+}
+
+inline void clear_hazard(HazardRecord& rec, std::size_t i = 0) noexcept { rec.ptr[i].store(nullptr, RELEASE); }
+
+// Snapshot of every published hazard, sorted for is_hazard(). Taken by the
+// reclaiming thread after the nodes it wants to reuse were unlinked.
+class HazardSnapshot {
+public:
+    HazardSnapshot() {
+        std::atomic_thread_fence(std::memory_order_seq_cst); // unlink before scan
+        for (HazardRecord* r = detail::hazard_list().load(ACQUIRE); r; r = r->next) {
+            for (auto& p : r->ptr) {
+                if (const void* v = p.load(ACQUIRE)) ptrs_.push_back(v);
+            }
+        }
+        std::sort(ptrs_.begin(), ptrs_.end());
+    }
+
+    bool is_hazard(const void* p) const noexcept { return std::binary_search(ptrs_.begin(), ptrs_.end(), p); }
+
+private:
+    std::vector<const void*> ptrs_;
+};
+
+} // namespace ring
@@ -0,0 +1,354 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "hazard.hpp"
+#include "memory.hpp"
+#include "park.hpp"
+#include "ring.hpp"
+#include "utils.hpp"
+
+namespace ring {
+
+// Unbounded MPMC queue made of linked ticketed-slot segments.
+//
+// Normally all traffic runs through one hot segment that wraps like a
+// RingMPMC. When a producer finds it full it closes it (a bit in the
+// segment's tail ticket, so no later ticket is handed out there) and links
+// a fresh segment behind it, taken from a small recycling pool; producers
+// never wait for consumers. Consumers drain a closed segment to its last
+// ticket, move head_ on and retire it. Retired segments go back to the
+// pool (or are freed past max_pooled) once no thread holds a hazard
+// pointer to them (hazard.hpp), so after a burst the queue shrinks back to
+// one cache-resident segment. Items keep FIFO order across segments.
+//
+// The pool/retire path takes a mutex; it only runs when a segment fills
+// up or drains, never per item.
+template <class T, class Layout = PaddedLayout>
+class LinkedRingMPMC {
+    static constexpr std::uint64_t kClosed = std::uint64_t{1} << 63;
+
+    using storage_type = typename Layout::template storage<T>;
+
+    struct Segment {
+        Segment(std::size_t capacity, const SlotAllocator& alloc)
+            : mask(capacity - 1), slots(capacity, alloc) {}
+
+        // Back to the just-constructed state; only for unlinked, unhazarded segments.
+        void reset() noexcept {
+            for (std::size_t i = 0; i <= mask; ++i) slots[i].seq.store(static_cast<std::uint64_t>(i), RELAXED);
+            head.store(0, RELAXED);
+            tail.store(0, RELAXED);
+            next.store(nullptr, RELAXED);
+        }
+
+        SlotRef<T> slot(std::uint64_t idx) noexcept { return slots[static_cast<std::size_t>(idx) & mask]; }
+
+        // Claims the free run at tail (at most n); 0 once the segment is
+        // closed. The producer that finds it full closes it.
+        std::size_t claim_free(std::size_t n, std::uint64_t& start) noexcept {
+            std::uint64_t t = tail.load(RELAXED);
+            for (;;) {
+                if (t & kClosed) return 0;
+                std::size_t free = 0;
+                while (free < n && slot(t + free).seq.load(ACQUIRE) == t + free) ++free;
+                if (free == 0) {
+                    const std::uint64_t seq = slot(t).seq.load(ACQUIRE);
+                    if (static_cast<std::int64_t>(seq - t) < 0) {   // full: close at exactly t
+                        if (tail.compare_exchange_weak(t, t | kClosed, ACQ_REL, RELAXED)) return 0;
+                    } else {
+                        t = tail.load(RELAXED);
+                    }
+                    continue;
+                }
+                if (tail.compare_exchange_weak(t, t + free, ACQ_REL, RELAXED)) { start = t; return free; }
+            }
+        }
+
+        // Claims the ready run at head (at most n); 0 when nothing is ready.
+        std::size_t claim_ready(std::size_t n, std::uint64_t& start) noexcept {
+            std::uint64_t h = head.load(RELAXED);
+            for (;;) {
+                std::size_t ready = 0;
+                while (ready < n && slot(h + ready).seq.load(ACQUIRE) == h + ready + 1) ++ready;
+                if (ready == 0) return 0;
+                if (head.compare_exchange_weak(h, h + ready, ACQ_REL, RELAXED)) { start = h; return ready; }
+            }
+        }
+
+        // Closed and every ticket handed out has been consumed.
+        bool drained() const noexcept {
+            const std::uint64_t t = tail.load(ACQUIRE);
+            return (t & kClosed) && head.load(ACQUIRE) >= (t & ~kClosed);
+        }
+
+        bool ready_at_head() noexcept {
+            const std::uint64_t h = head.load(RELAXED);
+            return slot(h).seq.load(ACQUIRE) == h + 1;
+        }
+
+        const std::size_t mask;
+        storage_type      slots;
+        alignas(64) std::atomic<std::uint64_t> head{0};
+        CachePad _pad1_;
+        alignas(64) std::atomic<std::uint64_t> tail{0}; // kClosed once full and succeeded
+        CachePad _pad2_;
+        alignas(64) std::atomic<Segment*> next{nullptr};
+    };
+
+public:
+    using layout_type = Layout;
+
+    // segment_capacity is rounded up to a power of two; up to max_pooled
+    // drained segments are kept for reuse. alloc places segment slots (see
+    // numa.hpp).
+    explicit LinkedRingMPMC(std::size_t segment_capacity = 4096, std::size_t max_pooled = 4,
+                            const SlotAllocator& alloc = {})
+        : segment_capacity_(next_pow2(segment_capacity < 2 ? 2 : segment_capacity)),
+          max_pooled_(max_pooled),
+          alloc_(alloc)
+    {
+        Segment* s = new Segment(segment_capacity_, alloc_);
+        head_.store(s, RELAXED);
+        tail_.store(s, RELAXED);
+    }
+
+    ~LinkedRingMPMC() {
+        for (Segment* s = head_.load(RELAXED); s;) {
+            Segment* next = s->next.load(RELAXED);
+            destroy_items(s);
+            delete s;
+            s = next;
+        }
+        for (Segment* s : retired_) delete s;
+        for (Segment* s : pool_) delete s;
+    }
+
+    LinkedRingMPMC(const LinkedRingMPMC&) = delete;
+    LinkedRingMPMC& operator=(const LinkedRingMPMC&) = delete;
+
+    std::size_t segment_capacity() const noexcept { return segment_capacity_; }
+
+    // Segments currently linked (1 outside bursts).
+    std::size_t segment_count() const noexcept { return segments_.load(RELAXED); }
+
+    // Drained segments waiting in the recycling pool.
+    std::size_t pooled() const {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        return pool_.size();
+    }
+
+    // -------- Producers: never wait --------
+    void enqueue(const T& v) { enqueue_one(v); }
+    void enqueue(T&& v) { enqueue_one(std::move(v)); }
+
+    // Kept for drop-in use where a RingMPMC was; always succeeds.
+    bool try_enqueue(const T& v) { enqueue_one(v); return true; }
+    bool try_enqueue(T&& v) { enqueue_one(std::move(v)); return true; }
+
+    // Same as enqueue_many: there is no full.
+    std::size_t try_enqueue_many(const T* data, std::size_t n) { return enqueue_many(data, n); }
+
+    // Enqueues all of data[0..n), one claim per contiguous run; returns n.
+    std::size_t enqueue_many(const T* data, std::size_t n) {
+        HazardRecord& hz = this_thread_hazards();
+        std::size_t done = 0;
+        while (done < n) {
+            Segment* seg = protect(tail_, hz);
+            std::uint64_t start = 0;
+            const std::size_t k = seg->claim_free(n - done, start);
+            if (k == 0) { advance_tail(seg); continue; }
+            for (std::size_t i = 0; i < k; ++i) {
+                SlotRef<T> s = seg->slot(start + i);
+                construct_in_slot(s, data[done + i]);
+                s.seq.store(start + i + 1, RELEASE);
+            }
+            done += k;
+        }
+        clear_hazard(hz);
+        not_empty_.notify();
+        return n;
+    }
+
+    // -------- Consumers --------
+    bool try_dequeue(T& out) { return dequeue_many(&out, 1) == 1; }
+
+    // Up to n items from the head segment; 0 when the queue is empty (or
+    // the next item's producer has not finished writing it).
+    std::size_t dequeue_many(T* out, std::size_t n) {
+        if (n == 0) return 0;
+        HazardRecord& hz = this_thread_hazards();
+        for (;;) {
+            Segment* seg = protect(head_, hz);
+            std::uint64_t start = 0;
+            const std::size_t k = seg->claim_ready(n, start);
+            if (k) {
+                for (std::size_t i = 0; i < k; ++i) {
+                    SlotRef<T> s = seg->slot(start + i);
+                    move_out_and_destroy(s, out[i]);
+                    s.seq.store(start + i + seg->mask + 1, RELEASE);
+                }
+                clear_hazard(hz);
+                return k;
+            }
+
+            Segment* next = seg->next.load(ACQUIRE);
+            if (!next || !seg->drained()) {
+                if (next && seg->ready_at_head()) continue; // raced a producer's commit
+                clear_hazard(hz);
+                return 0;
+            }
+
+            // seg is closed and empty: unlink it, make sure tail_ is past it too.
+            Segment* expected = seg;
+            if (head_.compare_exchange_strong(expected, next, ACQ_REL, ACQUIRE)) {
+                expected = seg;
+                tail_.compare_exchange_strong(expected, next, ACQ_REL, RELAXED);
+                clear_hazard(hz);
+                retire(seg);
+            }
+        }
+    }
+
+    // Blocking / timed dequeue (park on an EventCount like RingMPMC).
+    void dequeue(T& out) { not_empty_.await([&] { return try_dequeue(out); }); }
+
+    template <class Rep, class Period>
+    bool dequeue_for(T& out, const std::chrono::duration<Rep, Period>& timeout) {
+        return not_empty_.await_until([&] { return try_dequeue(out); }, std::chrono::steady_clock::now() + timeout);
+    }
+
+    // Exact for a single segment; during a burst the head segment's count
+    // plus a full capacity per segment behind it. Approximate while other
+    // threads are active.
+    std::size_t size() const noexcept {
+        HazardRecord& hz = this_thread_hazards();
+        Segment* seg = protect(head_, hz);
+        const std::uint64_t t = seg->tail.load(RELAXED) & ~kClosed;
+        const std::uint64_t h = seg->head.load(RELAXED);
+        const std::size_t behind = segments_.load(RELAXED);
+        clear_hazard(hz);
+        return (t > h ? static_cast<std::size_t>(t - h) : 0) + (behind > 1 ? (behind - 1) * segment_capacity_ : 0);
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+private:
+    template <class U>
+    void enqueue_one(U&& v) {
+        HazardRecord& hz = this_thread_hazards();
+        for (;;) {
+            Segment* seg = protect(tail_, hz);
+            std::uint64_t start = 0;
+            if (seg->claim_free(1, start) == 0) { advance_tail(seg); continue; }
+            SlotRef<T> s = seg->slot(start);
+            construct_in_slot(s, std::forward<U>(v));
+            s.seq.store(start + 1, RELEASE);
+            clear_hazard(hz);
+            not_empty_.notify();
+            return;
+        }
+    }
+
+    // seg (protected, closed) is the tail we saw: move tail_ to its
+    // successor, linking a fresh segment first if there is none yet.
+    void advance_tail(Segment* seg) {
+        Segment* next = seg->next.load(ACQUIRE);
+        if (!next) {
+            Segment* fresh = take_segment();
+            if (seg->next.compare_exchange_strong(next, fresh, ACQ_REL, ACQUIRE)) {
+                segments_.fetch_add(1, RELAXED);
+                next = fresh;
+            } else {
+                give_back(fresh); // another producer linked one; never published
+            }
+        }
+        Segment* expected = seg;
+        tail_.compare_exchange_strong(expected, next, ACQ_REL, RELAXED);
+    }
+
+    Segment* take_segment() {
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            if (!pool_.empty()) {
+                Segment* s = pool_.back();
+                pool_.pop_back();
+                return s;
+            }
+        }
+        return new Segment(segment_capacity_, alloc_);
+    }
+
+    void give_back(Segment* s) {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (pool_.size() < max_pooled_) pool_.push_back(s);
+        else delete s;
+    }
+
+    // s is unlinked from head_ and tail_; reuse it (and earlier retirees)
+    // once no hazard pointer covers it.
+    void retire(Segment* s) {
+        segments_.fetch_sub(1, RELAXED);
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        retired_.push_back(s);
+        const HazardSnapshot hazards;
+        std::size_t kept = 0;
+        for (Segment* r : retired_) {
+            if (hazards.is_hazard(r)) { retired_[kept++] = r; continue; }
+            r->reset();
+            if (pool_.size() < max_pooled_) pool_.push_back(r);
+            else delete r;
+        }
+        retired_.resize(kept);
+    }
+
+    static void destroy_items(Segment* s) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            const std::uint64_t end = s->tail.load(RELAXED) & ~kClosed;
+            for (std::uint64_t i = s->head.load(RELAXED); i < end; ++i) s->slot(i).ptr()->~T();
+        }
+    }
+
+    template <class U>
+    static void construct_in_slot(SlotRef<T> s, U&& value) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            *s.ptr() = static_cast<T>(std::forward<U>(value));
+        } else {
+            new (s.ptr()) T(std::forward<U>(value));
+        }
+    }
+
+    static void move_out_and_destroy(SlotRef<T> s, T& out) noexcept {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            out = *s.ptr();
+        } else {
+            T* p = s.ptr();
+            out = std::move(*p);
+            p->~T();
+        }
+    }
+
+    const std::size_t   segment_capacity_;
+    const std::size_t   max_pooled_;
+    const SlotAllocator alloc_;
+
+    alignas(64) mutable std::atomic<Segment*> head_{nullptr};
+    CachePad _pad1_;
+    alignas(64) std::atomic<Segment*> tail_{nullptr};
+    std::atomic<std::size_t>          segments_{1};
+    CachePad _pad2_;
+
+    alignas(64) EventCount not_empty_; // consumers park here
+
+    mutable std::mutex     pool_mutex_;
+    std::vector<Segment*>  pool_;    // reset, ready to link
+    std::vector<Segment*>  retired_; // unlinked, maybe still hazarded
+};
+
+} // namespace ring
@@ -0,0 +1,174 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+  #define NOMINMAX
+  #endif
+  #include <windows.h>
+#elif defined(__linux__)
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+namespace ring {
+
+// SlotAllocator::flags bits understood by the built-in allocators.
+constexpr unsigned kNumaInterleave = 1u << 0; // spread pages over all nodes
+constexpr unsigned kHugePages      = 1u << 1; // 2 MiB pages
+constexpr unsigned kGiganticPages  = 1u << 2; // 1 GiB pages where available, else 2 MiB
+constexpr unsigned kPrefault       = 1u << 3; // fault every page in at construction
+constexpr unsigned kLockPages      = 1u << 4; // mlock/VirtualLock (also faults pages in)
+
+// Where a ring's slot storage comes from. Passed to the ring constructor;
+// a plain struct of function pointers so the ring type does not change with
+// placement. allocate() throws std::bad_alloc on failure, like operator new.
+// node/flags/ctx are free for the hook to interpret (see numa.hpp).
+struct SlotAllocator {
+    using allocate_fn   = void* (*)(const SlotAllocator&, std::size_t bytes, std::size_t align);
+    using deallocate_fn = void  (*)(const SlotAllocator&, void* p, std::size_t bytes, std::size_t align) noexcept;
+
+    static void* heap_allocate(const SlotAllocator&, std::size_t bytes, std::size_t align) {
+        return ::operator new[](bytes, std::align_val_t{align});
+    }
+    static void heap_deallocate(const SlotAllocator&, void* p, std::size_t, std::size_t align) noexcept {
+        ::operator delete[](p, std::align_val_t{align});
+    }
+
+    allocate_fn   allocate   = &heap_allocate;
+    deallocate_fn deallocate = &heap_deallocate;
+    int           node       = -1;      // NUMA node, -1 = none/calling thread's
+    unsigned      flags      = 0;
+    void*         ctx        = nullptr; // user hook state
+};
+
+// -------- OS page mappings --------
+// Huge pages are best effort. On Linux we try hugetlbfs (MAP_HUGETLB) first,
+// then a 2 MiB-aligned mapping with transparent huge pages (MADV_HUGEPAGE).
+// On Windows we try MEM_LARGE_PAGES (needs SeLockMemoryPrivilege) and fall
+// back to normal pages. Without kPrefault/kLockPages pages fault on first
+// touch as usual.
+namespace detail {
+
+constexpr std::size_t kPage4K = std::size_t(4) << 10;
+constexpr std::size_t kPage2M = std::size_t(2) << 20;
+constexpr std::size_t kPage1G = std::size_t(1) << 30;
+
+inline std::size_t page_round(std::size_t bytes, unsigned flags) noexcept {
+    const std::size_t page = (flags & kGiganticPages) ? kPage1G
+                           : (flags & kHugePages)     ? kPage2M
+                           : kPage4K;
+    return (bytes + page - 1) & ~(page - 1);
+}
+
+#if defined(__linux__)
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+inline void* mmap_anon(std::size_t len, int extra) noexcept {
+    void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+}
+#endif
+
+// Maps len bytes (already page_round()ed) without faulting them in.
+// node >= 0 is a placement preference that only Windows applies here;
+// Linux callers mbind() the result before faulting.
+inline void* os_map(std::size_t len, unsigned flags, int node) {
+    void* p = nullptr;
+#if defined(__linux__)
+    (void)node;
+    if (flags & (kHugePages | kGiganticPages)) {
+        if (flags & kGiganticPages) p = mmap_anon(len, MAP_HUGETLB | (30 << MAP_HUGE_SHIFT));
+        if (!p) p = mmap_anon(len, MAP_HUGETLB | (21 << MAP_HUGE_SHIFT));
+        if (!p) {
+            // No reserved hugetlbfs pages: align to 2 MiB and ask for THP.
+            if (char* raw = static_cast<char*>(mmap_anon(len + kPage2M, 0))) {
+                char* aligned = reinterpret_cast<char*>(
+                    (reinterpret_cast<std::uintptr_t>(raw) + kPage2M - 1) & ~std::uintptr_t(kPage2M - 1));
+                if (aligned != raw) ::munmap(raw, static_cast<std::size_t>(aligned - raw));
+                ::munmap(aligned + len, static_cast<std::size_t>(raw + kPage2M - aligned));
+                ::madvise(aligned, len, MADV_HUGEPAGE);
+                p = aligned;
+            }
+        }
+    } else {
+        p = mmap_anon(len, 0);
+    }
+#elif defined(_WIN32)
+    const DWORD pref = node >= 0 ? static_cast<DWORD>(node) : NUMA_NO_PREFERRED_NODE;
+    if ((flags & (kHugePages | kGiganticPages)) && GetLargePageMinimum() != 0) {
+        p = VirtualAllocExNuma(GetCurrentProcess(), nullptr, len, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                               PAGE_READWRITE, pref);
+    }
+    if (!p) p = VirtualAllocExNuma(GetCurrentProcess(), nullptr, len, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, pref);
+#else
+    (void)len; (void)flags; (void)node;
+#endif
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+// Applies kPrefault / kLockPages to a fresh mapping.
+inline void os_fault_in(void* p, std::size_t len, unsigned flags) noexcept {
+    if (!(flags & (kPrefault | kLockPages))) return;
+    bool faulted = false;
+#if defined(__linux__)
+    if (flags & kLockPages) faulted = ::mlock(p, len) == 0; // RLIMIT_MEMLOCK may refuse
+#elif defined(_WIN32)
+    if (flags & kLockPages) faulted = VirtualLock(p, len) != 0; // bounded by the working set
+#endif
+    if (!faulted) {
+        volatile char* c = static_cast<volatile char*>(p);
+        for (std::size_t off = 0; off < len; off += kPage4K) c[off] = 0;
+    }
+}
+
+inline void os_unmap(void* p, std::size_t len) noexcept {
+#if defined(__linux__)
+    ::munmap(p, len);
+#elif defined(_WIN32)
+    (void)len;
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    (void)p; (void)len;
+#endif
+}
+
+inline void* page_allocate(const SlotAllocator& a, std::size_t bytes, std::size_t align) {
+#if defined(__linux__) || defined(_WIN32)
+    (void)align; // page aligned
+    const std::size_t len = page_round(bytes, a.flags);
+    void* p = os_map(len, a.flags, -1);
+    os_fault_in(p, len, a.flags);
+    return p;
+#else
+    return SlotAllocator::heap_allocate(a, bytes, align);
+#endif
+}
+
+inline void page_deallocate(const SlotAllocator& a, void* p, std::size_t bytes, std::size_t align) noexcept {
+#if defined(__linux__) || defined(_WIN32)
+    (void)align;
+    os_unmap(p, page_round(bytes, a.flags));
+#else
+    SlotAllocator::heap_deallocate(a, p, bytes, align);
+#endif
+}
+
+} // namespace detail
+
+// Slot storage straight from the OS, e.g. page_allocator(kHugePages | kPrefault)
+// to back a large ring with 2 MiB pages that are faulted in up front.
+inline SlotAllocator page_allocator(unsigned flags = kHugePages | kPrefault) {
+    SlotAllocator a;
+    a.allocate   = &detail::page_allocate;
+    a.deallocate = &detail::page_deallocate;
+    a.flags      = flags;
+    return a;
+}
+
+} // namespace ring
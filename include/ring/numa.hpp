@@ -0,0 +1,186 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+#include "affinity.hpp"
+#include "memory.hpp"
+
+#if defined(__linux__)
+  #include <fstream>
+  #include <linux/mempolicy.h>
+  #include <sched.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+namespace ring {
+
+// NUMA queries and node-aware slot allocators.
+//
+// Linux goes through sysfs and mbind(2) directly (no libnuma dependency),
+// Windows through the Numa* / VirtualAllocExNuma APIs. Everywhere else the
+// machine is reported as a single node and the allocators fall back to the
+// heap. Placement is best effort: if the kernel refuses a policy (no NUMA,
+// seccomp), memory stays first-touch.
+
+// Online NUMA node ids (at least {0}).
+inline std::vector<int> numa_nodes() {
+    std::vector<int> nodes;
+#if defined(__linux__)
+    std::ifstream f("/sys/devices/system/node/online");
+    std::string s;
+    if (std::getline(f, s)) {
+        for (unsigned n : detail::parse_cpulist(s)) nodes.push_back(static_cast<int>(n));
+    }
+#elif defined(_WIN32)
+    ULONG highest = 0;
+    if (GetNumaHighestNodeNumber(&highest)) {
+        for (ULONG n = 0; n <= highest; ++n) nodes.push_back(static_cast<int>(n));
+    }
+#endif
+    if (nodes.empty()) nodes.push_back(0);
+    return nodes;
+}
+
+// NUMA node of a logical CPU (numbered as in affinity.hpp); 0 if unknown.
+inline int numa_node_of_cpu(unsigned cpu) {
+#if defined(__linux__)
+    for (int n : numa_nodes()) {
+        std::ifstream f("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist");
+        std::string s;
+        if (!std::getline(f, s)) continue;
+        for (unsigned c : detail::parse_cpulist(s)) if (c == cpu) return n;
+    }
+#elif defined(_WIN32)
+    unsigned base = 0;
+    for (WORD g = 0; g < GetActiveProcessorGroupCount(); ++g) {
+        const unsigned cnt = GetActiveProcessorCount(g);
+        if (cpu < base + cnt) {
+            PROCESSOR_NUMBER pn{};
+            pn.Group  = g;
+            pn.Number = static_cast<BYTE>(cpu - base);
+            USHORT node = 0;
+            return GetNumaProcessorNodeEx(&pn, &node) ? static_cast<int>(node) : 0;
+        }
+        base += cnt;
+    }
+#else
+    (void)cpu;
+#endif
+    return 0;
+}
+
+// Logical CPU the calling thread runs on right now; -1 if unknown.
+inline int current_cpu() noexcept {
+#if defined(__linux__)
+    return sched_getcpu();
+#elif defined(_WIN32)
+    PROCESSOR_NUMBER pn{};
+    GetCurrentProcessorNumberEx(&pn);
+    unsigned base = 0;
+    for (WORD g = 0; g < pn.Group; ++g) base += GetActiveProcessorCount(g);
+    return static_cast<int>(base + pn.Number);
+#else
+    return -1;
+#endif
+}
+
+// NUMA node of the calling thread, looked up once per thread. Pin threads
+// (pin_current_thread) before their first call.
+inline int this_thread_numa_node() noexcept {
+    thread_local int node = []() noexcept {
+        const int cpu = current_cpu();
+        try { return cpu < 0 ? 0 : numa_node_of_cpu(static_cast<unsigned>(cpu)); } catch (...) { return 0; }
+    }();
+    return node;
+}
+
+namespace detail {
+
+// Maps len bytes (page_round()ed) placed on node or interleaved, then
+// applies the page flags from memory.hpp. The policy is bound before the
+// first touch so kPrefault/kLockPages fault pages in where they belong.
+#if defined(__linux__)
+inline void* numa_map(std::size_t len, unsigned flags, int node, bool interleave) {
+    void* p = os_map(len, flags, -1);
+
+    constexpr unsigned kWordBits = sizeof(unsigned long) * 8;
+    constexpr unsigned kMaxNodes = 1024;
+    unsigned long mask[kMaxNodes / kWordBits] = {};
+    auto set = [&](int n) {
+        if (n >= 0 && static_cast<unsigned>(n) < kMaxNodes) mask[n / kWordBits] |= 1ul << (n % kWordBits);
+    };
+    if (interleave) { for (int n : numa_nodes()) set(n); }
+    else            { set(node); }
+    ::syscall(SYS_mbind, p, len, interleave ? MPOL_INTERLEAVE : MPOL_PREFERRED, mask, kMaxNodes + 1, 0);
+    os_fault_in(p, len, flags);
+    return p;
+}
+#elif defined(_WIN32)
+inline void* numa_map(std::size_t len, unsigned flags, int node, bool interleave) {
+    void* p = nullptr;
+    if (!interleave) {
+        p = os_map(len, flags, node);
+    } else {
+        // Reserve once, then commit 64 KiB chunks round-robin over the nodes.
+        // Large pages cannot be committed piecemeal, so they are not used here.
+        const std::vector<int> nodes = numa_nodes();
+        constexpr std::size_t kChunk = 64 * 1024;
+        p = VirtualAlloc(nullptr, len, MEM_RESERVE, PAGE_READWRITE);
+        for (std::size_t off = 0, i = 0; p && off < len; off += kChunk, ++i) {
+            const std::size_t n = (len - off < kChunk) ? len - off : kChunk;
+            if (!VirtualAllocExNuma(GetCurrentProcess(), static_cast<char*>(p) + off, n, MEM_COMMIT,
+                                    PAGE_READWRITE, static_cast<DWORD>(nodes[i % nodes.size()]))) {
+                VirtualFree(p, 0, MEM_RELEASE);
+                p = nullptr;
+            }
+        }
+        if (!p) throw std::bad_alloc();
+    }
+    os_fault_in(p, len, flags);
+    return p;
+}
+#endif
+
+inline void* numa_allocate(const SlotAllocator& a, std::size_t bytes, std::size_t align) {
+#if defined(__linux__) || defined(_WIN32)
+    (void)align; // page aligned
+    const bool interleave = (a.flags & kNumaInterleave) != 0;
+    return numa_map(page_round(bytes, a.flags), a.flags, a.node >= 0 ? a.node : this_thread_numa_node(), interleave);
+#else
+    return SlotAllocator::heap_allocate(a, bytes, align);
+#endif
+}
+
+inline void numa_deallocate(const SlotAllocator& a, void* p, std::size_t bytes, std::size_t align) noexcept {
+#if defined(__linux__) || defined(_WIN32)
+    (void)align;
+    os_unmap(p, page_round(bytes, a.flags));
+#else
+    SlotAllocator::heap_deallocate(a, p, bytes, align);
+#endif
+}
+
+} // namespace detail
+
+// Slot storage on one node (-1: the node of the constructing thread).
+// page_flags takes the memory.hpp page bits, e.g. kHugePages | kPrefault.
+inline SlotAllocator node_local_allocator(int node = -1, unsigned page_flags = 0) {
+    SlotAllocator a;
+    a.allocate   = &detail::numa_allocate;
+    a.deallocate = &detail::numa_deallocate;
+    a.node       = node;
+    a.flags      = page_flags;
+    return a;
+}
+
+// Slot storage interleaved page by page across all online nodes.
+inline SlotAllocator interleaved_allocator(unsigned page_flags = 0) {
+    SlotAllocator a = node_local_allocator(-1, page_flags);
+    a.flags |= kNumaInterleave;
+    return a;
+}
+
+} // namespace ring
@@ -0,0 +1,41 @@
+#pragma once
+
+namespace ring {
+
+// -------- Overflow policies --------
+// Template parameter of RingMPMC / BroadcastRing: what the waiting producer
+// ops (enqueue, enqueue_many, publish, publish_many) do when the ring is
+// full, i.e. when a consumer has stalled. try_* ops never wait and are not
+// affected; neither are the explicit deadline/timeout ops.
+//   BlockOnFull      wait for room (the default, lossless)
+//   FailOnFull       return at once with what fit; the caller keeps the rest
+//   DropNewest       return at once; items that did not fit are discarded
+//                    and counted as dropped
+//   OverwriteOldest  make room by discarding the oldest items (counted as
+//                    dropped); producers never wait on consumers. Broadcast
+//                    readers that were lapped detect it from the slot
+//                    generation and skip ahead (see BroadcastRing::lost).
+// Dropped items show up in RingStatsSnapshot::dropped (stats.hpp).
+enum class OverflowAction { Block, Fail, DropNewest, OverwriteOldest };
+
+struct BlockOnFull {
+    static constexpr const char* name = "block";
+    static constexpr OverflowAction action = OverflowAction::Block;
+};
+
+struct FailOnFull {
+    static constexpr const char* name = "fail";
+    static constexpr OverflowAction action = OverflowAction::Fail;
+};
+
+struct DropNewest {
+    static constexpr const char* name = "drop-newest";
+    static constexpr OverflowAction action = OverflowAction::DropNewest;
+};
+
+struct OverwriteOldest {
+    static constexpr const char* name = "overwrite-oldest";
+    static constexpr OverflowAction action = OverflowAction::OverwriteOldest;
+};
+
+} // namespace ring
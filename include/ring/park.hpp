@@ -0,0 +1,304 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+  #define NOMINMAX
+  #endif
+  #include <windows.h>
+  #if defined(_MSC_VER)
+    #pragma comment(lib, "Synchronization.lib")
+  #endif
+#elif defined(__linux__)
+  #include <climits>
+  #include <ctime>
+  #include <linux/futex.h>
+  #include <linux/membarrier.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+namespace ring {
+
+// OS-level wait/wake on an atomic word (futex on Linux, WaitOnAddress on
+// Windows). park_wait blocks while the word still holds `expected`, for at
+// most `timeout`; spurious wakeups are allowed, so callers re-check their
+// condition. Elsewhere timed waits degrade to a sleep and untimed ones to
+// std::atomic::wait/notify_all.
+//
+// 64-bit words are supported for timed waits only: on Linux the futex
+// watches the low 32 bits, which change on every ticket/index update.
+//
+// kParkWakes: park_wake_all() also ends a timed park_wait. Not so for the
+// sleep fallback, which always runs to its timeout.
+#if defined(__linux__) || defined(_WIN32)
+inline constexpr bool kParkWakes = true;
+#else
+inline constexpr bool kParkWakes = false;
+#endif
+
+namespace detail {
+
+#if defined(__linux__)
+inline void futex_wait(const void* addr, std::uint32_t expected, const timespec* ts) noexcept {
+    ::syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, ts, nullptr, 0);
+}
+
+inline void futex_wake_all(const void* addr) noexcept {
+    ::syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+inline timespec to_timespec(std::chrono::nanoseconds d) noexcept {
+    timespec ts;
+    ts.tv_sec  = static_cast<time_t>(d.count() / 1'000'000'000);
+    ts.tv_nsec = static_cast<long>(d.count() % 1'000'000'000);
+    return ts;
+}
+
+template <class W>
+inline const void* low_word(const std::atomic<W>& w) noexcept {
+    const char* p = reinterpret_cast<const char*>(&w);
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    p += sizeof(W) - sizeof(std::uint32_t);
+#endif
+    return p;
+}
+#endif
+
+#if defined(_WIN32)
+inline DWORD to_millis(std::chrono::nanoseconds d) noexcept {
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+    return ms <= 0 ? 1 : static_cast<DWORD>(ms); // WaitOnAddress has ms granularity
+}
+#endif
+
+} // namespace detail
+
+template <class W>
+inline void park_wait(const std::atomic<W>& word, W expected, std::chrono::nanoseconds timeout) noexcept {
+    static_assert(sizeof(W) == 4 || sizeof(W) == 8, "park_wait needs a 32- or 64-bit word");
+#if defined(__linux__)
+    const timespec ts = detail::to_timespec(timeout);
+    detail::futex_wait(detail::low_word(word), static_cast<std::uint32_t>(expected), &ts);
+#elif defined(_WIN32)
+    WaitOnAddress(const_cast<std::atomic<W>*>(&word), &expected, sizeof(W), detail::to_millis(timeout));
+#else
+    if (word.load(std::memory_order_relaxed) == expected) std::this_thread::sleep_for(timeout);
+#endif
+}
+
+// Untimed wait; 32-bit words only (they are the only ones we wake).
+inline void park_wait(const std::atomic<std::uint32_t>& word, std::uint32_t expected) noexcept {
+#if defined(__linux__)
+    detail::futex_wait(&word, expected, nullptr);
+#elif defined(_WIN32)
+    WaitOnAddress(const_cast<std::atomic<std::uint32_t>*>(&word), &expected, sizeof(expected), INFINITE);
+#else
+    word.wait(expected, std::memory_order_relaxed);
+#endif
+}
+
+inline void park_wake_all(std::atomic<std::uint32_t>& word) noexcept {
+#if defined(__linux__)
+    detail::futex_wake_all(&word);
+#elif defined(_WIN32)
+    WakeByAddressAll(&word);
+#else
+    word.notify_all();
+#endif
+}
+
+// Asymmetric fence pair for Dekker-style handshakes where one side is hot:
+// light_fence() only stops the compiler from reordering, heavy_fence()
+// makes every running thread of the process execute a full barrier
+// (membarrier on Linux, FlushProcessWriteBuffers on Windows). A store
+// before light_fence() and a load after heavy_fence() cannot both miss
+// each other. Without OS support heavy_fence() is a plain fence and
+// returns false; the light side must then use a full fence as well
+// (heavy_fence_supported() tells it which).
+
+namespace detail {
+
+// Test hook: behave as if the OS had no process-wide barrier. Set it only
+// while no handshake is in flight.
+inline std::atomic<bool> no_os_barrier{false};
+
+// Whether heavy_fence() has an OS barrier behind it; probed once. On Linux
+// only the private expedited membarrier counts: MEMBARRIER_CMD_GLOBAL
+// waits for an RCU grace period (milliseconds), far too slow for a fence
+// taken on every park, so without expedited support notify() pays a full
+// fence instead.
+inline bool os_barrier() noexcept {
+#if defined(__linux__)
+    static const bool ok = ::syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+    return ok;
+#elif defined(_WIN32)
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace detail
+
+inline bool heavy_fence_supported() noexcept {
+    return detail::os_barrier() && !detail::no_os_barrier.load(std::memory_order_relaxed);
+}
+
+inline void light_fence() noexcept { std::atomic_signal_fence(std::memory_order_seq_cst); }
+
+inline bool heavy_fence() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!heavy_fence_supported()) return false;
+#if defined(__linux__)
+    ::syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+#elif defined(_WIN32)
+    FlushProcessWriteBuffers();
+#endif
+    return true;
+}
+
+// A suspended coroutine (or any callback) waiting on an EventCount; lives
+// in the waiter's own frame. try_wake runs on the notifying thread: it
+// retries the waiter's op and, on success, schedules its resumption (the
+// node may be gone once it returns true). ready is a side-effect-free
+// "could the op succeed now" check on ctx (the ring).
+struct AsyncWaiter {
+    AsyncWaiter* next = nullptr;
+    bool (*try_wake)(AsyncWaiter*) noexcept = nullptr;
+    bool (*ready)(void* ctx) noexcept = nullptr;
+    void* ctx = nullptr;
+};
+
+// Parking lot for one ring condition ("not empty" / "not full").
+// notify() is a relaxed load of the waiter count unless someone is parked,
+// so publishers pay no RMW and no fence on the fast path. Waiters close
+// the window against a concurrent publish on their side instead: they
+// register, heavy_fence(), then re-check the ring before parking, so a
+// wakeup cannot be missed and await() parks with no timeout. Where
+// heavy_fence() has no OS barrier behind it, notify() pays a full fence.
+//
+// Parked threads are counted in waiters_ and woken through epoch_; async
+// waiters (suspend()) sit on a lock-free list that notify() drains.
+class EventCount {
+public:
+    // await_until's longest park where timed parks cannot be woken (!kParkWakes).
+    static constexpr std::chrono::milliseconds kSleepSlice{1};
+
+    void notify() noexcept {
+        // Pairs with heavy_fence() in suspend() / attempt().
+        if (heavy_fence_supported()) light_fence();
+        else std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::uint64_t w = waiters_.load(std::memory_order_relaxed);
+        if (w == 0) return;
+        if (w & kThreadMask) {
+            epoch_.fetch_add(1, std::memory_order_release);
+            park_wake_all(epoch_);
+        }
+        if (w >= kAsyncWaiter) wake_async(nullptr);
+    }
+
+    // Registers w, then re-checks w.ready. Returns true if w stays queued:
+    // a later notify() will run w.try_wake, possibly before suspend()
+    // returns, so the caller must not touch w afterwards. Returns false if
+    // the caller took w back (its op may succeed now) and should retry.
+    bool suspend(AsyncWaiter& w) noexcept {
+        bool (*const ready)(void*) noexcept = w.ready;
+        void* const ctx = w.ctx;
+        waiters_.fetch_add(kAsyncWaiter, std::memory_order_seq_cst);
+        push(&w, &w);
+        heavy_fence(); // register before the re-check
+        if (!ready(ctx)) return true;
+        return !wake_async(&w);
+    }
+
+    // Retries try_op, parking in between, until it succeeds.
+    template <class TryOp>
+    void await(TryOp&& try_op) noexcept {
+        while (!attempt(try_op, [this](std::uint32_t key) { park_wait(epoch_, key); })) {}
+    }
+
+    // Same, but gives up at deadline; returns whether try_op succeeded.
+    template <class TryOp, class Clock, class Dur>
+    bool await_until(TryOp&& try_op, const std::chrono::time_point<Clock, Dur>& deadline) noexcept {
+        for (;;) {
+            const auto now = Clock::now();
+            if (now >= deadline) return try_op();
+            const auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+            const auto park_for = (kParkWakes || left < kSleepSlice) ? left : std::chrono::nanoseconds(kSleepSlice);
+            if (attempt(try_op, [&](std::uint32_t key) { park_wait(epoch_, key, park_for); })) return true;
+        }
+    }
+
+private:
+    template <class TryOp, class Park>
+    bool attempt(TryOp& try_op, Park&& park) noexcept {
+        if (try_op()) return true;
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        heavy_fence(); // register before the re-check
+        const std::uint32_t key = epoch_.load(std::memory_order_acquire);
+        const bool ok = try_op();
+        if (!ok) park(key);
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        return ok;
+    }
+
+    // waiters_: parked threads in the low half, async waiters in the high.
+    static constexpr std::uint64_t kThreadMask  = 0xFFFFFFFFull;
+    static constexpr std::uint64_t kAsyncWaiter = 1ull << 32;
+
+    void push(AsyncWaiter* first, AsyncWaiter* last) noexcept {
+        AsyncWaiter* old = async_.load(std::memory_order_relaxed);
+        do { last->next = old; } while (!async_.compare_exchange_weak(old, first, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Takes the whole list (no ABA: nodes are only ever pushed) and wakes
+    // waiters oldest first until one's op fails; that one and the rest go
+    // back in one push, followed by the same re-check as suspend(). Returns
+    // whether self was among the nodes taken (it is handed back to the
+    // caller, not woken).
+    bool wake_async(AsyncWaiter* self) noexcept {
+        bool got_self = false;
+        for (;;) {
+            AsyncWaiter* list = async_.exchange(nullptr, std::memory_order_acquire);
+            if (!list) return got_self;
+            AsyncWaiter* fifo = nullptr;
+            std::uint64_t n = 0;
+            while (list) { AsyncWaiter* next = list->next; list->next = fifo; fifo = list; list = next; ++n; }
+            waiters_.fetch_sub(n * kAsyncWaiter, std::memory_order_relaxed);
+
+            AsyncWaiter* rest = nullptr;
+            AsyncWaiter* rest_tail = nullptr;
+            std::uint64_t left = 0;
+            while (fifo) {
+                AsyncWaiter* next = fifo->next;
+                if (fifo == self) {
+                    got_self = true;
+                } else if (rest || !fifo->try_wake(fifo)) {
+                    fifo->next = nullptr;
+                    if (rest_tail) rest_tail->next = fifo; else rest = fifo;
+                    rest_tail = fifo;
+                    ++left;
+                }
+                fifo = next;
+            }
+            if (!rest) return got_self;
+
+            bool (*const ready)(void*) noexcept = rest->ready;
+            void* const ctx = rest->ctx;
+            waiters_.fetch_add(left * kAsyncWaiter, std::memory_order_seq_cst);
+            push(rest, rest_tail);
+            heavy_fence();
+            if (!ready(ctx)) return got_self;
+        }
+    }
+
+    std::atomic<std::uint32_t>  epoch_{0};
+    std::atomic<std::uint64_t>  waiters_{0};
+    std::atomic<AsyncWaiter*>   async_{nullptr};
+};
+
+} // namespace ring
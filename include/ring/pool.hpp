@@ -0,0 +1,167 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "backoff.hpp"
+#include "memory.hpp"
+#include "ring.hpp"
+#include "ring_mpmc.hpp"
+
+namespace ring {
+
+// A fixed set of preallocated T objects handed out by pointer, for payloads
+// too large to copy through a ring: acquire -> fill -> enqueue the T* ->
+// consume -> release makes no heap allocation, and no allocator metadata
+// moves between the producing and consuming cores. Idle objects sit in a
+// RingMPMC<T*> free list; every object starts on its own cache line and
+// spans whole lines (stride rounded up to 64 bytes), so objects in use on
+// different cores never false-share.
+//
+// Objects are default-constructed with the pool and destroyed with it; in
+// between acquire() hands them out in whatever state the last user left
+// (a std::vector member keeps its capacity). Every object must be back in
+// the pool before the pool is destroyed.
+template <class T, class Layout = PaddedLayout, class Backoff = DefaultBackoff>
+class Pool {
+public:
+    using free_list_type = RingMPMC<T*, Layout, Backoff>;
+
+    static constexpr std::size_t kAlign  = alignof(T) > 64 ? alignof(T) : 64;
+    static constexpr std::size_t kStride = (sizeof(T) + kAlign - 1) & ~(kAlign - 1);
+
+    // Returns an object to the pool it came from (the deleter of Ptr).
+    struct Releaser {
+        Pool* pool = nullptr;
+        void operator()(T* p) const noexcept { pool->release(p); }
+    };
+    using Ptr = std::unique_ptr<T, Releaser>;
+
+    // count objects (at least 1); object memory comes from alloc like ring
+    // slots do (see numa.hpp), the free list from the heap.
+    explicit Pool(std::size_t count, const SlotAllocator& alloc = {})
+        : alloc_(alloc),
+          count_(count ? count : 1),
+          free_(count_),
+          bytes_(count_ * kStride),
+          base_(static_cast<std::byte*>(alloc_.allocate(alloc_, bytes_, kAlign)))
+    {
+        std::size_t built = 0;
+        try {
+            for (; built < count_; ++built) new (base_ + built * kStride) T();
+        } catch (...) {
+            destroy(built);
+            throw;
+        }
+        // The free list holds capacity >= count pointers, so releases never wait for room.
+        for (std::size_t i = 0; i < count_; ++i) free_.try_enqueue(object(i));
+    }
+
+    ~Pool() { destroy(count_); }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    std::size_t capacity() const noexcept { return count_; }
+
+    // Objects currently idle; approximate while other threads use the pool.
+    std::size_t available() const noexcept { return free_.size(); }
+
+    bool owns(const T* p) const noexcept {
+        const auto* b = reinterpret_cast<const std::byte*>(p);
+        return b >= base_ && b < base_ + bytes_ && static_cast<std::size_t>(b - base_) % kStride == 0;
+    }
+
+    // An idle object, or nullptr when all are in use.
+    T* try_acquire() noexcept {
+        T* p = nullptr;
+        return free_.try_dequeue(p) ? p : nullptr;
+    }
+
+    // Blocking: parks until some object is released.
+    T* acquire() noexcept {
+        T* p = nullptr;
+        free_.dequeue(p);
+        return p;
+    }
+
+    // From any thread; p must come from this pool and not be in it already.
+    void release(T* p) noexcept { free_.enqueue(p); }
+
+    Ptr try_acquire_ptr() noexcept { return Ptr(try_acquire(), Releaser{this}); }
+    Ptr acquire_ptr() noexcept { return Ptr(acquire(), Releaser{this}); }
+
+    // Owning handle for a pointer that came out of a ring.
+    Ptr adopt(T* p) noexcept { return Ptr(p, Releaser{this}); }
+
+    free_list_type& free_list() noexcept { return free_; }
+
+    // Per-thread front end: keeps up to 2 * batch pointers of its own and
+    // moves batch of them to or from the free list at a time, so a thread
+    // that acquires and releases at a steady rate touches the shared ring
+    // once per batch instead of once per object. Released objects are
+    // handed out again LIFO, while still in this core's cache. Use from
+    // one thread; the destructor returns what it holds.
+    class Cache {
+    public:
+        explicit Cache(Pool& pool, std::size_t batch = 32)
+            : pool_(pool), batch_(batch ? batch : 1), items_(2 * batch_) {}
+
+        ~Cache() { flush(); }
+
+        Cache(const Cache&) = delete;
+        Cache& operator=(const Cache&) = delete;
+
+        T* try_acquire() noexcept {
+            if (n_ == 0) n_ = pool_.free_.dequeue_many(items_.data(), batch_);
+            return n_ ? items_[--n_] : nullptr;
+        }
+
+        T* acquire() noexcept {
+            if (T* p = try_acquire()) return p;
+            return pool_.acquire();
+        }
+
+        void release(T* p) noexcept {
+            if (n_ == items_.size()) {
+                pool_.free_.enqueue_many(items_.data() + n_ - batch_, batch_);
+                n_ -= batch_;
+            }
+            items_[n_++] = p;
+        }
+
+        // Returns every held object to the pool.
+        void flush() noexcept {
+            if (n_) pool_.free_.enqueue_many(items_.data(), n_);
+            n_ = 0;
+        }
+
+        std::size_t held() const noexcept { return n_; }
+
+    private:
+        Pool& pool_;
+        const std::size_t batch_;
+        std::vector<T*> items_;
+        std::size_t n_ = 0;
+    };
+
+private:
+    T* object(std::size_t i) noexcept { return std::launder(reinterpret_cast<T*>(base_ + i * kStride)); }
+
+    void destroy(std::size_t built) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (std::size_t i = 0; i < built; ++i) object(i)->~T();
+        }
+        alloc_.deallocate(alloc_, base_, bytes_, kAlign);
+    }
+
+    const SlotAllocator alloc_;
+    const std::size_t count_;
+    free_list_type free_;
+    const std::size_t bytes_;
+    std::byte* base_;
+};
+
+} // namespace ring
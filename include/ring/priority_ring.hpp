@@ -0,0 +1,188 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include "backoff.hpp"
+#include "memory.hpp"
+#include "park.hpp"
+#include "ring_mpmc.hpp"
+#include "utils.hpp"
+
+namespace ring {
+
+enum class DrainOrder {
+    Strict,             // lane 0 first; lane i only once lanes 0..i-1 are drained
+    WeightedRoundRobin, // up to weight[i] items per lane per round
+};
+
+// Lanes RingMPMC lanes behind one consumer interface, lane 0 the most
+// urgent: control traffic put on lane 0 overtakes bulk items queued on
+// later lanes instead of waiting behind them. FIFO holds per lane only.
+//
+// occupancy() is a bitmask of lanes that may hold items. Consumers walk
+// its set bits, so empty lanes cost nothing (their index lines are never
+// touched); a bit is set by the producer that makes the lane non-empty and
+// cleared by the consumer that finds it empty, which then re-checks the
+// lane. Both sides fence around the mask (producers only once per
+// enqueue call) so a lane can never hold items with its bit clear.
+template <class T, std::size_t Lanes, class Layout = PaddedLayout, class Backoff = DefaultBackoff>
+class PriorityRing {
+    static_assert(Lanes >= 1 && Lanes <= 64, "PriorityRing: 1..64 lanes (one mask bit each)");
+
+public:
+    using lane_type    = RingMPMC<T, Layout, Backoff>;
+    using weights_type = std::array<std::uint32_t, Lanes>;
+
+    static constexpr std::size_t lanes = Lanes;
+
+    // Equal weights: WeightedRoundRobin degenerates to plain round robin.
+    static constexpr weights_type equal_weights() noexcept {
+        weights_type w{};
+        for (auto& x : w) x = 1;
+        return w;
+    }
+
+    // Every lane gets capacity_per_lane slots; weights are the per-round
+    // quanta of WeightedRoundRobin (0 counts as 1).
+    explicit PriorityRing(std::size_t capacity_per_lane, const weights_type& weights = equal_weights(),
+                          const SlotAllocator& alloc = {}) {
+        for (std::size_t i = 0; i < Lanes; ++i) {
+            lanes_[i] = std::make_unique<lane_type>(capacity_per_lane, alloc);
+            weights_[i] = weights[i] ? weights[i] : 1;
+        }
+    }
+
+    PriorityRing(const PriorityRing&) = delete;
+    PriorityRing& operator=(const PriorityRing&) = delete;
+
+    std::size_t capacity_per_lane() const noexcept { return lanes_[0]->capacity(); }
+    // Read-only (size, stats): writes must go through try_enqueue* so mark() sees them.
+    const lane_type& lane(std::size_t i) const noexcept { return *lanes_[i]; }
+
+    // Lanes that may hold items (bit i = lane i).
+    std::uint64_t occupancy() const noexcept { return occupied_.load(ACQUIRE); }
+
+    // -------- Producers --------
+    bool try_enqueue(std::size_t lane, const T& v) noexcept { return mark(lane, lanes_[lane]->try_enqueue(v)); }
+    bool try_enqueue(std::size_t lane, T&& v) noexcept { return mark(lane, lanes_[lane]->try_enqueue(std::move(v))); }
+
+    std::size_t try_enqueue_many(std::size_t lane, const T* data, std::size_t n) noexcept {
+        return mark(lane, lanes_[lane]->try_enqueue_many(data, n));
+    }
+
+    // Wait for room in that lane only (per the lane's park / Backoff).
+    bool enqueue(std::size_t lane, const T& v) noexcept { return mark(lane, lanes_[lane]->enqueue(v)); }
+    bool enqueue(std::size_t lane, T&& v) noexcept { return mark(lane, lanes_[lane]->enqueue(std::move(v))); }
+
+    std::size_t enqueue_many(std::size_t lane, const T* data, std::size_t n) noexcept {
+        return mark(lane, lanes_[lane]->enqueue_many(data, n));
+    }
+
+    // -------- Consumers (any number) --------
+
+    // Up to n items from the occupied lanes in the given order, in one call.
+    std::size_t dequeue_many(T* out, std::size_t n, DrainOrder order = DrainOrder::Strict) noexcept {
+        return order == DrainOrder::Strict ? drain_strict(out, n) : drain_weighted(out, n);
+    }
+
+    bool try_dequeue(T& out, DrainOrder order = DrainOrder::Strict) noexcept { return dequeue_many(&out, 1, order) == 1; }
+
+    // Blocking: parks until some producer enqueues.
+    void dequeue(T& out, DrainOrder order = DrainOrder::Strict) noexcept {
+        not_empty_.await([&] { return try_dequeue(out, order); });
+    }
+
+    template <class Rep, class Period>
+    bool dequeue_for(T& out, const std::chrono::duration<Rep, Period>& timeout, DrainOrder order = DrainOrder::Strict) noexcept {
+        return not_empty_.await_until([&] { return try_dequeue(out, order); }, std::chrono::steady_clock::now() + timeout);
+    }
+
+    // Sum of lane sizes; approximate while producers are active.
+    std::size_t size() const noexcept {
+        std::size_t s = 0;
+        for (const auto& l : lanes_) s += l->size();
+        return s;
+    }
+
+private:
+    // After a successful enqueue: publish the lane's bit (fence so the
+    // mask load cannot pass the item's publication), then wake consumers.
+    template <class R>
+    R mark(std::size_t lane, R r) noexcept {
+        if (r) {
+            const std::uint64_t bit = std::uint64_t{1} << lane;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!(occupied_.load(RELAXED) & bit)) occupied_.fetch_or(bit, RELEASE);
+            not_empty_.notify();
+        }
+        return r;
+    }
+
+    // dequeue_many on lane i; a short take means the lane ran dry, so its
+    // bit is cleared and restored if an item raced in.
+    std::size_t take(std::size_t i, T* out, std::size_t n) noexcept {
+        const std::size_t k = lanes_[i]->dequeue_many(out, n);
+        if (k < n) {
+            const std::uint64_t bit = std::uint64_t{1} << i;
+            occupied_.fetch_and(~bit, ACQ_REL);
+            std::atomic_thread_fence(std::memory_order_seq_cst); // clear before the re-check
+            if (lanes_[i]->size() != 0) occupied_.fetch_or(bit, RELEASE);
+        }
+        return k;
+    }
+
+    std::size_t drain_strict(T* out, std::size_t n) noexcept {
+        std::size_t got = 0;
+        for (std::uint64_t m = occupied_.load(ACQUIRE); m && got < n; m &= m - 1) {
+            got += take(static_cast<std::size_t>(std::countr_zero(m)), out + got, n - got);
+        }
+        return got;
+    }
+
+    // Deficit-style round robin: the current lane hands out up to its
+    // weight, then the turn moves on; a lane that runs dry or is empty
+    // forfeits the rest of its turn. The position (lane, quantum used) is
+    // shared by all consumers and carried across calls, so small batches
+    // still see every lane in proportion; concurrent consumers only blur
+    // the proportions, never correctness.
+    std::size_t drain_weighted(T* out, std::size_t n) noexcept {
+        const std::uint64_t pos = turn_.load(RELAXED);
+        std::size_t   lane = static_cast<std::size_t>(pos >> 32) % Lanes;
+        std::uint32_t used = static_cast<std::uint32_t>(pos);
+        std::size_t got = 0, idle = 0;
+        while (got < n && idle < Lanes) {
+            std::size_t k = 0;
+            if (occupied_.load(ACQUIRE) & (std::uint64_t{1} << lane)) {
+                const std::size_t want = std::min<std::size_t>(n - got, weights_[lane] - used);
+                k = take(lane, out + got, want);
+                got  += k;
+                used += static_cast<std::uint32_t>(k);
+                if (k < want) used = weights_[lane]; // dry: turn over
+            } else {
+                used = weights_[lane];
+            }
+            idle = k ? 0 : idle + 1;
+            if (used >= weights_[lane]) { lane = (lane + 1 == Lanes) ? 0 : lane + 1; used = 0; }
+        }
+        turn_.store((static_cast<std::uint64_t>(lane) << 32) | used, RELAXED);
+        return got;
+    }
+
+    std::array<std::unique_ptr<lane_type>, Lanes> lanes_;
+    weights_type weights_{};
+
+    alignas(64) std::atomic<std::uint64_t> occupied_{0};
+    CachePad _pad1_;
+    alignas(64) std::atomic<std::uint64_t> turn_{0}; // WRR position: lane << 32 | quantum used
+    CachePad _pad2_;
+
+    alignas(64) EventCount not_empty_; // consumers park here
+};
+
+} // namespace ring
@@ -1,9 +1,12 @@
 #pragma once
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <new>
 #include <type_traits>
+#include "memory.hpp"
+#include "simd.hpp"
 #include "utils.hpp"
 
 namespace ring {
@@ -26,4 +29,295 @@ struct Slot {
     const T* ptr() const noexcept { return std::launder(reinterpret_cast<const T*>(&storage)); }
 };
 
+// Same ticket + payload pair without the cache-line split.
+template <class T>
+struct PackedSlot {
+    std::atomic<std::uint64_t> seq; // ticket
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+    T*       ptr()       noexcept { return std::launder(reinterpret_cast<T*>(&storage)); }
+    const T* ptr() const noexcept { return std::launder(reinterpret_cast<const T*>(&storage)); }
+};
+
+// What the rings operate on: the ticket and payload address of one slot,
+// independent of where the layout actually keeps them.
+template <class T>
+struct SlotRef {
+    std::atomic<std::uint64_t>& seq;
+    T* const p;
+
+    T* ptr() const noexcept { return p; }
+};
+
+// A claimed run of logical slots [start, start + count), as handed out by the
+// zero-copy reserve()/peek() APIs. r[i] addresses the payload of slot
+// start + i in place (raw storage after reserve(), a live T after peek()).
+template <class T, class Storage>
+struct SlotSpan {
+    Storage*      slots = nullptr;
+    std::size_t   mask  = 0;
+    std::uint64_t start = 0;
+    std::size_t   count = 0;
+
+    // Payloads can move as bytes: trivially copyable T in a layout whose
+    // values are one dense array (split), so a run is at most two blocks.
+    static constexpr bool bulk_copy = Storage::contiguous && std::is_trivially_copyable_v<T>;
+
+    std::size_t size()  const noexcept { return count; }
+    bool        empty() const noexcept { return count == 0; }
+
+    T* operator[](std::size_t i) const noexcept {
+        return (*slots)[static_cast<std::size_t>(start + i) & mask].ptr();
+    }
+
+    // bulk_copy only: src[0..count) into the run / the run into dst[0..count).
+    void copy_in(const T* src) const noexcept {
+        static_assert(bulk_copy);
+        const std::size_t pos = static_cast<std::size_t>(start) & mask, first = first_block(pos);
+        simd::copy(slots->values() + pos, src, first * sizeof(T));
+        if (first < count) simd::copy(slots->values(), src + first, (count - first) * sizeof(T));
+    }
+
+    void copy_out(T* dst) const noexcept {
+        static_assert(bulk_copy);
+        const std::size_t pos = static_cast<std::size_t>(start) & mask, first = first_block(pos);
+        simd::copy(dst, slots->values() + pos, first * sizeof(T));
+        if (first < count) simd::copy(dst + first, slots->values(), (count - first) * sizeof(T));
+    }
+
+private:
+    std::size_t first_block(std::size_t pos) const noexcept {
+        return (count < mask + 1 - pos) ? count : mask + 1 - pos; // up to the wrap
+    }
+};
+
+// -------- Slot storage --------
+// Owns capacity slots (memory from a SlotAllocator) and initializes
+// seq[i] = i. Payloads are raw storage; the ring constructs/destroys T in
+// place, including the items still queued when the ring is destroyed.
+
+// Array of whole slots (Slot<T> or PackedSlot<T>).
+template <class T, class S>
+class SlotArray {
+public:
+    static constexpr std::size_t bytes_per_slot = sizeof(S);
+    static constexpr bool        contiguous     = false;
+
+    explicit SlotArray(std::size_t capacity, const SlotAllocator& alloc = {})
+        : alloc_(alloc),
+          bytes_(capacity * sizeof(S)),
+          slots_(static_cast<S*>(alloc_.allocate(alloc_, bytes_, alignof(S))))
+    {
+        for (std::size_t i = 0; i < capacity; ++i) {
+            new (&slots_[i]) S();
+            slots_[i].seq.store(static_cast<std::uint64_t>(i), RELAXED);
+        }
+    }
+
+    ~SlotArray() {
+        if constexpr (!std::is_trivially_destructible_v<S>) {
+            for (std::size_t i = 0; i < bytes_ / sizeof(S); ++i) slots_[i].~S();
+        }
+        alloc_.deallocate(alloc_, slots_, bytes_, alignof(S));
+    }
+
+    SlotArray(const SlotArray&) = delete;
+    SlotArray& operator=(const SlotArray&) = delete;
+
+    SlotRef<T> operator[](std::size_t i) noexcept { return { slots_[i].seq, slots_[i].ptr() }; }
+
+private:
+    const SlotAllocator alloc_;
+    const std::size_t bytes_;
+    S* slots_;
+};
+
+// Ticket array followed by a dense payload array in one allocation.
+// contiguous: seqs() / values() expose both arrays to the batch paths
+// (vector ticket scans, block payload copies).
+template <class T>
+class SplitSlots {
+    using Seq     = std::atomic<std::uint64_t>;
+    using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+    static constexpr std::size_t kAlign = alignof(Storage) > 64 ? alignof(Storage) : 64;
+
+public:
+    static constexpr std::size_t bytes_per_slot = sizeof(Seq) + sizeof(Storage);
+    static constexpr bool        contiguous     = true;
+
+    explicit SplitSlots(std::size_t capacity, const SlotAllocator& alloc = {})
+        : alloc_(alloc),
+          values_off_((capacity * sizeof(Seq) + kAlign - 1) & ~(kAlign - 1)),
+          bytes_(values_off_ + capacity * sizeof(Storage)),
+          base_(static_cast<std::byte*>(alloc_.allocate(alloc_, bytes_, kAlign)))
+    {
+        Seq* seqs = reinterpret_cast<Seq*>(base_);
+        for (std::size_t i = 0; i < capacity; ++i) {
+            new (&seqs[i]) Seq(static_cast<std::uint64_t>(i));
+        }
+    }
+
+    ~SplitSlots() { alloc_.deallocate(alloc_, base_, bytes_, kAlign); }
+
+    SplitSlots(const SplitSlots&) = delete;
+    SplitSlots& operator=(const SplitSlots&) = delete;
+
+    SlotRef<T> operator[](std::size_t i) noexcept {
+        Seq*     seqs = std::launder(reinterpret_cast<Seq*>(base_));
+        Storage* vals = reinterpret_cast<Storage*>(base_ + values_off_);
+        return { seqs[i], std::launder(reinterpret_cast<T*>(&vals[i])) };
+    }
+
+    Seq* seqs() noexcept { return std::launder(reinterpret_cast<Seq*>(base_)); }
+    T*   values() noexcept { return reinterpret_cast<T*>(base_ + values_off_); }
+
+private:
+    const SlotAllocator alloc_;
+    const std::size_t values_off_;
+    const std::size_t bytes_;
+    std::byte* base_;
+};
+
+// Same layouts with N slots inline in the owning object (no allocation),
+// used through Fixed<N, Layout>.
+template <class T, class S, std::size_t N>
+class InlineSlotArray {
+public:
+    static constexpr std::size_t bytes_per_slot = sizeof(S);
+    static constexpr bool        contiguous     = false;
+
+    InlineSlotArray() noexcept {
+        for (std::size_t i = 0; i < N; ++i) slots_[i].seq.store(static_cast<std::uint64_t>(i), RELAXED);
+    }
+
+    InlineSlotArray(const InlineSlotArray&) = delete;
+    InlineSlotArray& operator=(const InlineSlotArray&) = delete;
+
+    SlotRef<T> operator[](std::size_t i) noexcept { return { slots_[i].seq, slots_[i].ptr() }; }
+
+private:
+    alignas(64) std::array<S, N> slots_;
+};
+
+template <class T, std::size_t N>
+class InlineSplitSlots {
+    using Seq     = std::atomic<std::uint64_t>;
+    using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+    static constexpr std::size_t kAlign = alignof(Storage) > 64 ? alignof(Storage) : 64;
+
+public:
+    static constexpr std::size_t bytes_per_slot = sizeof(Seq) + sizeof(Storage);
+    static constexpr bool        contiguous     = true;
+
+    InlineSplitSlots() noexcept {
+        for (std::size_t i = 0; i < N; ++i) seqs_[i].store(static_cast<std::uint64_t>(i), RELAXED);
+    }
+
+    InlineSplitSlots(const InlineSplitSlots&) = delete;
+    InlineSplitSlots& operator=(const InlineSplitSlots&) = delete;
+
+    SlotRef<T> operator[](std::size_t i) noexcept {
+        return { seqs_[i], std::launder(reinterpret_cast<T*>(&vals_[i])) };
+    }
+
+    Seq* seqs() noexcept { return seqs_.data(); }
+    T*   values() noexcept { return reinterpret_cast<T*>(vals_.data()); }
+
+private:
+    alignas(64)     std::array<Seq, N>     seqs_;
+    alignas(kAlign) std::array<Storage, N> vals_;
+};
+
+// -------- Layout policies --------
+// Template parameter of RingMPMC / RingSPSC; trades resident-set size
+// against false sharing between neighbouring slots.
+//   PaddedLayout: seq and payload on separate cache lines (>= 128B per slot)
+//   PackedLayout: seq and payload side by side (16B per slot for 32-bit T)
+//   SplitLayout:  seq[] array + value[] array (seq scans stay in the ticket array)
+//
+// inline_storage<T, N> is the same layout kept inside the ring (Fixed<N>).
+struct PaddedLayout {
+    static constexpr const char* name = "padded";
+    template <class T> using storage = SlotArray<T, Slot<T>>;
+    template <class T, std::size_t N> using inline_storage = InlineSlotArray<T, Slot<T>, N>;
+};
+
+struct PackedLayout {
+    static constexpr const char* name = "packed";
+    template <class T> using storage = SlotArray<T, PackedSlot<T>>;
+    template <class T, std::size_t N> using inline_storage = InlineSlotArray<T, PackedSlot<T>, N>;
+};
+
+struct SplitLayout {
+    static constexpr const char* name = "split";
+    template <class T> using storage = SplitSlots<T>;
+    template <class T, std::size_t N> using inline_storage = InlineSplitSlots<T, N>;
+};
+
+// Compile-time capacity: RingMPMC<T, Fixed<1024>> has capacity and mask as
+// constants folded into the code and its slots inline in the ring object,
+// so the ring can live in static storage or inside another object without
+// a heap allocation. Constructed with no arguments.
+template <std::size_t N, class Layout = PaddedLayout>
+struct Fixed {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "Fixed<N>: N must be a power of two");
+    static constexpr const char* name = Layout::name;
+    static constexpr std::size_t capacity = N;
+    template <class T> using storage = typename Layout::template inline_storage<T, N>;
+};
+
+namespace detail {
+
+// Fixed capacity of a layout policy, 0 for runtime-sized layouts.
+template <class Layout, class = void>
+struct fixed_capacity : std::integral_constant<std::size_t, 0> {};
+
+template <class Layout>
+struct fixed_capacity<Layout, std::void_t<decltype(Layout::capacity)>>
+    : std::integral_constant<std::size_t, Layout::capacity> {};
+
+// Stand-in for a size_t member whose value is known at compile time.
+template <std::size_t V>
+struct StaticSize {
+    constexpr StaticSize() noexcept = default;
+    explicit constexpr StaticSize(std::size_t) noexcept {}
+    constexpr operator std::size_t() const noexcept { return V; }
+};
+
+// Length of the run of slots idx, idx + 1, ... (at most n) whose tickets
+// read idx + offset, idx + 1 + offset, ...: offset 0 finds free slots,
+// 1 ready ones. Contiguous storage goes through simd::ticket_run (split at
+// the wrap) and then one acquire fence, which orders the payload reads
+// after the whole run as the per-slot acquire loads do elsewhere.
+template <class Storage>
+std::size_t ticket_run(Storage& slots, std::size_t mask, std::uint64_t idx, std::uint64_t offset, std::size_t n) noexcept {
+    if constexpr (Storage::contiguous) {
+        const std::size_t pos = static_cast<std::size_t>(idx) & mask;
+        const std::size_t first = (n < mask + 1 - pos) ? n : mask + 1 - pos;
+        std::size_t k = simd::ticket_run(slots.seqs() + pos, idx + offset, first);
+        if (k == first && k < n) k += simd::ticket_run(slots.seqs(), idx + k + offset, n - k);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return k;
+    } else {
+        std::size_t k = 0;
+        while (k < n && slots[static_cast<std::size_t>(idx + k) & mask].seq.load(ACQUIRE) == idx + k + offset) ++k;
+        return k;
+    }
+}
+
+// Types of a ring's capacity_ / mask_ members for a layout.
+template <class Layout, std::size_t N = fixed_capacity<Layout>::value>
+struct ring_size_types {
+    using capacity_type = StaticSize<N>;
+    using mask_type     = StaticSize<N - 1>;
+};
+
+template <class Layout>
+struct ring_size_types<Layout, 0> {
+    using capacity_type = std::size_t;
+    using mask_type     = std::size_t;
+};
+
+} // namespace detail
+
 } // namespace ring
@@ -2,65 +2,100 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <new>
+#include <stdexcept>
 #include <thread>
 #include <type_traits>
 #include <utility>
 #include <algorithm>
 #include <chrono>
+#include "backoff.hpp"
+#include "overflow.hpp"
+#include "park.hpp"
 #include "ring.hpp"
+#include "stats.hpp"
 #include "utils.hpp"
 
-#if defined(_MSC_VER)
-  #include <immintrin.h>
-  #define RING_PAUSE() _mm_pause()
-#else
-  #define RING_PAUSE() do {} while(0)
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
 #endif
 
 namespace ring {
 
 // Multi-Producer / Multi-Consumer ring with ticketed slots.
-template <class T>
+// Layout selects the slot memory layout (see ring.hpp), Backoff how waiting
+// loops back off (see backoff.hpp), Stats whether contention counters are
+// kept (see stats.hpp; NoStats compiles them out), Overflow what enqueue()
+// and enqueue_many() do on a full ring (see overflow.hpp).
+template <class T, class Layout = PaddedLayout, class Backoff = DefaultBackoff, class Stats = NoStats,
+          class Overflow = BlockOnFull>
 class RingMPMC {
 public:
-    explicit RingMPMC(std::size_t capacity)
+    using layout_type   = Layout;
+    using backoff_type  = Backoff;
+    using stats_type    = Stats;
+    using overflow_type = Overflow;
+    using storage_type  = typename Layout::template storage<T>;
+    using span_type     = SlotSpan<T, storage_type>;
+
+    // Non-zero for Fixed<N> layouts (capacity known at compile time).
+    static constexpr std::size_t fixed_capacity = detail::fixed_capacity<Layout>::value;
+
+    // alloc decides where slot storage lives (heap by default; see numa.hpp).
+    explicit RingMPMC(std::size_t capacity, const SlotAllocator& alloc = {}) requires (fixed_capacity == 0)
         : capacity_(next_pow2(capacity)),
           mask_(capacity_ - 1),
-          slots_(static_cast<Slot<T>*>(::operator new[](capacity_ * sizeof(Slot<T>)))),
+          slots_(capacity_, alloc),
           head_(0), tail_(0)
-    {
-        for (std::size_t i = 0; i < capacity_; ++i) {
-            new (&slots_[i]) Slot<T>();
-            slots_[i].seq.store(static_cast<std::uint64_t>(i), RELAXED);
-        }
-    }
+    {}
+
+    // Fixed<N> layouts: N inline slots, nothing allocated.
+    RingMPMC() requires (fixed_capacity != 0)
+        : capacity_(fixed_capacity),
+          mask_(fixed_capacity - 1),
+          head_(0), tail_(0)
+    {}
 
+    // Destroys the items still queued between head_ and tail_; nothing to
+    // walk for trivially destructible T. Must not race with any other call.
     ~RingMPMC() {
-        ::operator delete[](slots_);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            const std::uint64_t end = tail_.load(RELAXED);
+            for (std::uint64_t i = head_.load(RELAXED); i < end; ++i) {
+                SlotRef<T> s = slot(i);
+                if (s.seq.load(RELAXED) == i + 1) s.ptr()->~T(); // skip reserved, never committed
+            }
+        }
     }
 
     RingMPMC(const RingMPMC&) = delete;
     RingMPMC& operator=(const RingMPMC&) = delete;
 
     std::size_t capacity() const noexcept { return capacity_; }
+    static constexpr std::size_t bytes_per_slot() noexcept { return storage_type::bytes_per_slot; }
 
     // -------- Single-item ops --------
     bool try_enqueue(const T& v) noexcept {
         std::uint64_t pos = tail_.load(RELAXED);
         for (;;) {
-            Slot<T>& s = slot(pos);
+            SlotRef<T> s = slot(pos);
             std::uint64_t seq = s.seq.load(ACQUIRE);
             intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
             if (diff == 0) {
                 if (tail_.compare_exchange_weak(pos, pos + 1, ACQ_REL, RELAXED)) {
                     construct_in_slot(s, v);
                     s.seq.store(pos + 1, RELEASE);
+                    not_empty_.notify();
+                    note_enqueued(1, pos + 1);
                     return true;
                 }
+                stats_.cas_retry();
             } else if (diff < 0) {
+                stats_.full();
                 return false; // full
             } else {
+                stats_.cas_retry();
                 pos = tail_.load(RELAXED);
             }
         }
@@ -69,18 +104,23 @@ public:
     bool try_enqueue(T&& v) noexcept {
         std::uint64_t pos = tail_.load(RELAXED);
         for (;;) {
-            Slot<T>& s = slot(pos);
+            SlotRef<T> s = slot(pos);
             std::uint64_t seq = s.seq.load(ACQUIRE);
             intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
             if (diff == 0) {
                 if (tail_.compare_exchange_weak(pos, pos + 1, ACQ_REL, RELAXED)) {
                     construct_in_slot(s, std::move(v));
                     s.seq.store(pos + 1, RELEASE);
+                    not_empty_.notify();
+                    note_enqueued(1, pos + 1);
                     return true;
                 }
+                stats_.cas_retry();
             } else if (diff < 0) {
+                stats_.full();
                 return false;
             } else {
+                stats_.cas_retry();
                 pos = tail_.load(RELAXED);
             }
         }
@@ -89,49 +129,521 @@ public:
     bool try_dequeue(T& out) noexcept {
         std::uint64_t pos = head_.load(RELAXED);
         for (;;) {
-            Slot<T>& s = slot(pos);
+            SlotRef<T> s = slot(pos);
             std::uint64_t seq = s.seq.load(ACQUIRE);
             intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
             if (diff == 0) {
                 if (head_.compare_exchange_weak(pos, pos + 1, ACQ_REL, RELAXED)) {
                     move_out_and_destroy(s, out);
                     s.seq.store(pos + capacity_, RELEASE);
+                    not_full_.notify();
+                    stats_.dequeued(1);
                     return true;
                 }
+                stats_.cas_retry();
             } else if (diff < 0) {
+                stats_.empty();
                 return false; // empty
+            } else if (seq == pos + kSkip) {
+                step_over_skip(pos);
             } else {
+                stats_.cas_retry();
                 pos = head_.load(RELAXED);
             }
         }
     }
 
-    // -------- Deadline wrappers (spin/yield until deadline) --------
+    // -------- Deadline wrappers (back off until deadline) --------
     template <class Clock, class Dur>
     bool enqueue_until(const T& v, const std::chrono::time_point<Clock, Dur>& deadline) noexcept {
-        int spins = 0;
+        Backoff backoff;
         do {
             if (try_enqueue(v)) return true;
-            if (++spins < 200) { RING_PAUSE(); }
-            else { std::this_thread::yield(); spins = 0; }
+            stats_.backoff(backoff_wait(backoff, head_, head_.load(RELAXED))); // full: wait for consumers
         } while (Clock::now() < deadline);
         return false;
     }
 
     template <class Clock, class Dur>
     bool dequeue_until(T& out, const std::chrono::time_point<Clock, Dur>& deadline) noexcept {
-        int spins = 0;
+        Backoff backoff;
         do {
             if (try_dequeue(out)) return true;
-            if (++spins < 200) { RING_PAUSE(); }
-            else { std::this_thread::yield(); spins = 0; }
+            stats_.backoff(backoff_wait(backoff, tail_, tail_.load(RELAXED))); // empty: wait for producers
         } while (Clock::now() < deadline);
         return false;
     }
 
+    // -------- Blocking ops (park instead of spinning) --------
+    // Waiters park on futex/WaitOnAddress; the opposite side only issues a
+    // wake when somebody is parked (see EventCount in park.hpp).
+    // enqueue() only parks under BlockOnFull; it returns false when
+    // FailOnFull / DropNewest turned the item away.
+    bool enqueue(const T& v) noexcept { return enqueue_one(v); }
+    bool enqueue(T&& v) noexcept { return enqueue_one(std::move(v)); }
+    void dequeue(T& out) noexcept { not_empty_.await([&] { return try_dequeue(out); }); }
+
+    template <class Rep, class Period>
+    bool enqueue_for(const T& v, const std::chrono::duration<Rep, Period>& timeout) noexcept {
+        return not_full_.await_until([&] { return try_enqueue(v); }, std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <class Rep, class Period>
+    bool dequeue_for(T& out, const std::chrono::duration<Rep, Period>& timeout) noexcept {
+        return not_empty_.await_until([&] { return try_dequeue(out); }, std::chrono::steady_clock::now() + timeout);
+    }
+
     // -------- Batched enqueue (block reservation) --------
+    // BlockOnFull: reserves min(n, capacity) tickets up front and waits for
+    // each slot to free up; always returns the reserved count.
+    // FailOnFull / DropNewest: try_enqueue_many, the rest is left to the
+    // caller / dropped. OverwriteOldest: evicts the oldest items until all
+    // n are in (only the newest capacity survive when n > capacity);
+    // returns n.
     // Pointer overload (portable for VS2019)
     std::size_t enqueue_many(const T* data, std::size_t n) noexcept {
+        if constexpr (Overflow::action == OverflowAction::Block) {
+            return enqueue_many_reserved(data, n);
+        } else if constexpr (Overflow::action == OverflowAction::OverwriteOldest) {
+            std::size_t done = 0;
+            Backoff backoff;
+            while (done < n) {
+                const std::size_t put = try_enqueue_many(data + done, n - done);
+                done += put;
+                if (done < n && evict_oldest(n - done) == 0 && put == 0) wait_head_slot(backoff);
+            }
+            return n;
+        } else {
+            const std::size_t done = try_enqueue_many(data, n);
+            if constexpr (Overflow::action == OverflowAction::DropNewest) {
+                if (done < n) stats_.dropped(n - done);
+            }
+            return done;
+        }
+    }
+
+    // -------- Batched enqueue (non-reserving, claim only free run) --------
+    // Never waits on consumers: returns how many of data[0..n) were enqueued
+    // (0 when full), so callers get a real backpressure signal.
+    std::size_t try_enqueue_many(const T* data, std::size_t n) noexcept {
+        std::uint64_t start = 0;
+        const std::size_t free = claim_free(n, start);
+        if constexpr (span_type::bulk_copy) {
+            span_type{ &slots_, mask_, start, free }.copy_in(data);
+            for (std::size_t i = 0; i < free; ++i) slot(start + i).seq.store(start + i + 1, RELEASE);
+        } else {
+            for (std::size_t i = 0; i < free; ++i) {
+                const std::uint64_t idx = start + i;
+                SlotRef<T> s = slot(idx);
+                construct_in_slot(s, data[i]);
+                s.seq.store(idx + 1, RELEASE);
+            }
+        }
+        if (free) not_empty_.notify();
+        return free;
+    }
+
+    // -------- Batched dequeue (non-reserving, claim only ready run) --------
+    std::size_t dequeue_many(T* out, std::size_t n) noexcept {
+        std::uint64_t start = 0;
+        const std::size_t ready = claim_ready(n, start);
+        if constexpr (span_type::bulk_copy) {
+            span_type{ &slots_, mask_, start, ready }.copy_out(out);
+            for (std::size_t i = 0; i < ready; ++i) slot(start + i).seq.store(start + i + capacity_, RELEASE);
+        } else {
+            for (std::size_t i = 0; i < ready; ++i) {
+                const std::uint64_t idx = start + i;
+                SlotRef<T> s = slot(idx);
+                move_out_and_destroy(s, out[i]);
+                s.seq.store(idx + capacity_, RELEASE);
+            }
+        }
+        if (ready) { not_full_.notify(); stats_.dequeued(ready); }
+        return ready;
+    }
+
+    // -------- Zero-copy produce / consume --------
+    // reserve(n) claims up to n free slots (possibly none) without copying;
+    // construct a T in every r[i], then commit(r) publishes the whole run.
+    // peek(n) claims up to n ready items for in-place reads; release(r)
+    // destroys them and hands the slots back to producers. Claimed slots are
+    // owned by the caller until commit/release, and other threads of the
+    // same side keep going past them.
+    span_type reserve(std::size_t n) noexcept {
+        span_type r{ &slots_, mask_, 0, 0 };
+        r.count = claim_free(n, r.start);
+        return r;
+    }
+
+    void commit(const span_type& r) noexcept {
+        for (std::size_t i = 0; i < r.count; ++i) {
+            const std::uint64_t idx = r.start + i;
+            slot(idx).seq.store(idx + 1, RELEASE);
+        }
+        if (r.count) not_empty_.notify();
+    }
+
+    span_type peek(std::size_t n) noexcept {
+        span_type r{ &slots_, mask_, 0, 0 };
+        r.count = claim_ready(n, r.start);
+        if (r.count) stats_.dequeued(r.count);
+        return r;
+    }
+
+    void release(const span_type& r) noexcept {
+        for (std::size_t i = 0; i < r.count; ++i) {
+            const std::uint64_t idx = r.start + i;
+            SlotRef<T> s = slot(idx);
+            if constexpr (!std::is_trivially_destructible_v<T>) s.ptr()->~T();
+            s.seq.store(idx + capacity_, RELEASE);
+        }
+        if (r.count) not_full_.notify();
+    }
+
+    // -------- Drain --------
+    // Hands every ready item to f(T&&) and frees its slot, one claimed run
+    // at a time, until the ring is empty; returns the count. For shutdown
+    // paths that give payloads back to a pool instead of destroying them.
+    // Safe alongside other consumers (each item goes to exactly one of
+    // them); f must not throw.
+    template <class F>
+    std::size_t drain(F&& f) {
+        std::size_t total = 0;
+        for (;;) {
+            std::uint64_t start = 0;
+            const std::size_t ready = claim_ready(capacity_, start);
+            if (ready == 0) return total;
+            for (std::size_t i = 0; i < ready; ++i) {
+                const std::uint64_t idx = start + i;
+                SlotRef<T> s = slot(idx);
+                f(std::move(*s.ptr()));
+                if constexpr (!std::is_trivially_destructible_v<T>) s.ptr()->~T();
+                s.seq.store(idx + capacity_, RELEASE);
+            }
+            not_full_.notify();
+            stats_.dequeued(ready);
+            total += ready;
+        }
+    }
+
+#if defined(__cpp_impl_coroutine)
+    // -------- Coroutine awaitables --------
+    // Each completes at once when its op goes through; otherwise the
+    // coroutine is queued on not_empty_ / not_full_ (EventCount::suspend)
+    // and a later publish on the other side retries the op on the
+    // publishing thread and resumes the coroutine once it succeeds. No
+    // thread blocks and nothing polls. Resumption runs inline on that
+    // thread, or is handed to ex.submit(f) when an executor is passed
+    // (e.g. ring::Scheduler), which keeps publishers' stacks shallow.
+    //   T           co_await q.async_dequeue()
+    //   std::size_t co_await q.async_dequeue_many(out, n)   1..n items
+    //   bool        co_await q.async_enqueue(v)   false if Overflow turned v away
+    //   std::size_t co_await q.async_enqueue_many(data, n)  all n under BlockOnFull
+    // Non-blocking Overflow policies never suspend on enqueue.
+    auto async_dequeue() noexcept { return Awaitable<DequeueOp>(*this, not_empty_, {}); }
+    template <class Ex> auto async_dequeue(Ex& ex) noexcept { return Awaitable<DequeueOp>(*this, not_empty_, {}, resumer(ex)); }
+
+    auto async_dequeue_many(T* out, std::size_t n) noexcept { return Awaitable<DequeueManyOp>(*this, not_empty_, {out, n}); }
+    template <class Ex> auto async_dequeue_many(T* out, std::size_t n, Ex& ex) noexcept {
+        return Awaitable<DequeueManyOp>(*this, not_empty_, {out, n}, resumer(ex));
+    }
+
+    auto async_enqueue(T v) noexcept { return Awaitable<EnqueueOp>(*this, not_full_, {std::move(v)}); }
+    template <class Ex> auto async_enqueue(T v, Ex& ex) noexcept {
+        return Awaitable<EnqueueOp>(*this, not_full_, {std::move(v)}, resumer(ex));
+    }
+
+    auto async_enqueue_many(const T* data, std::size_t n) noexcept { return Awaitable<EnqueueManyOp>(*this, not_full_, {data, n}); }
+    template <class Ex> auto async_enqueue_many(const T* data, std::size_t n, Ex& ex) noexcept {
+        return Awaitable<EnqueueManyOp>(*this, not_full_, {data, n}, resumer(ex));
+    }
+#endif
+
+    // -------- Ticket blocks (per-thread reservation caches) --------
+    // Opt-in handles for threads making many small calls: each keeps a
+    // block of tickets so most calls only touch their own slots, not the
+    // shared tail_/head_ line. A handle belongs to one thread; handles and
+    // plain calls can be mixed freely on the same ring.
+
+    // Claims `block` tickets with one fetch_add on tail_ and fills them in
+    // order. try_enqueue() returns false (full) while the slot of the next
+    // ticket still holds an item from the previous lap. Unfilled tickets
+    // hold back items other threads enqueue after them, so flush() before
+    // going idle: it hands the rest back by moving tail_ back when no
+    // producer claimed after the block, and otherwise marks each as a skip
+    // ticket that consumers step over (waiting per Backoff for its slot to
+    // be freed first). Needs capacity >= 4.
+    //
+    // That wait has no bound, and the destructor runs flush(): a skip can
+    // only be written once consumers have taken the previous lap's item from
+    // its slot, and giving the ticket up instead would stall every consumer
+    // behind it. Destroying a handle with unfilled tickets on a full ring
+    // that nobody drains therefore blocks; flush() while consumers run.
+    class ProducerBlock {
+    public:
+        explicit ProducerBlock(RingMPMC& q, std::size_t block = 256)
+            : q_(q),
+              block_(q.capacity_ >= 4 ? std::clamp<std::size_t>(block, 1, q.capacity_)
+                                      : throw std::invalid_argument("ProducerBlock: ring capacity must be >= 4")) {}
+        ~ProducerBlock() { flush(); }
+
+        ProducerBlock(const ProducerBlock&) = delete;
+        ProducerBlock& operator=(const ProducerBlock&) = delete;
+
+        bool try_enqueue(const T& v) noexcept { return put(v); }
+        bool try_enqueue(T&& v) noexcept { return put(std::move(v)); }
+
+        void flush() noexcept {
+            if (next_ == end_) return;
+            std::uint64_t expected = end_;
+            if (q_.tail_.compare_exchange_strong(expected, next_, ACQ_REL, RELAXED)) {
+                q_.not_full_.notify(); // the returned tickets are free slots again
+            } else {
+                for (; next_ < end_; ++next_) q_.mark_skip(next_);
+            }
+            next_ = end_ = 0;
+        }
+
+        // Tickets claimed but not yet filled.
+        std::size_t reserved() const noexcept { return static_cast<std::size_t>(end_ - next_); }
+
+    private:
+        template <class U>
+        bool put(U&& v) noexcept {
+            if (next_ == end_) {
+                next_ = q_.tail_.fetch_add(block_, ACQ_REL);
+                end_  = next_ + block_;
+            }
+            SlotRef<T> s = q_.slot(next_);
+            if (s.seq.load(ACQUIRE) != next_) { q_.stats_.full(); return false; }
+            construct_in_slot(s, std::forward<U>(v));
+            s.seq.store(next_ + 1, RELEASE);
+            ++next_;
+            q_.not_empty_.notify();
+            q_.note_enqueued(1, next_);
+            return true;
+        }
+
+        RingMPMC&         q_;
+        const std::size_t block_;
+        std::uint64_t     next_ = 0, end_ = 0; // unfilled tickets [next_, end_)
+    };
+
+    // Claims the ready run at head_ (at most `block` items, one CAS, never
+    // waits) and serves try_dequeue() from it, freeing each slot as its item
+    // is taken. flush() returns the untaken rest: by moving head_ back when
+    // no consumer claimed after the run, otherwise by re-enqueueing the
+    // items at the tail.
+    //
+    // The fallback gives up FIFO: re-enqueued items land behind everything
+    // enqueued meanwhile. It takes the whole rest out first (into a buffer
+    // of `block` items the handle allocates up front): the tail may already
+    // be a lap ahead of the run, so waiting for room while still holding
+    // its slots could deadlock. It then waits (parked on not_full_) for
+    // room, as does the destructor, which runs flush(). Take only what you
+    // will consume, or flush() while the run is still at head_.
+    class ConsumerBlock {
+    public:
+        explicit ConsumerBlock(RingMPMC& q, std::size_t block = 256)
+            : q_(q), block_(std::clamp<std::size_t>(block, 1, q.capacity_)), spill_(std::make_unique<T[]>(block_)) {}
+        ~ConsumerBlock() { flush(); }
+
+        ConsumerBlock(const ConsumerBlock&) = delete;
+        ConsumerBlock& operator=(const ConsumerBlock&) = delete;
+
+        bool try_dequeue(T& out) noexcept {
+            if (next_ == end_) {
+                const std::size_t n = q_.claim_ready(block_, next_);
+                if (n == 0) { next_ = end_ = 0; return false; }
+                end_ = next_ + n;
+            }
+            take(out);
+            q_.not_full_.notify();
+            q_.stats_.dequeued(1);
+            return true;
+        }
+
+        void flush() noexcept {
+            if (next_ == end_) return;
+            std::uint64_t expected = end_;
+            if (q_.head_.compare_exchange_strong(expected, next_, ACQ_REL, RELAXED)) {
+                q_.not_empty_.notify();
+            } else {
+                const std::size_t n = static_cast<std::size_t>(end_ - next_);
+                for (std::size_t i = 0; i < n; ++i) take(spill_[i]);
+                q_.not_full_.notify();
+                for (std::size_t i = 0; i < n; ++i) {
+                    q_.not_full_.await([&] { return q_.try_enqueue(std::move(spill_[i])); });
+                }
+            }
+            next_ = end_ = 0;
+        }
+
+        // Items claimed but not yet taken.
+        std::size_t reserved() const noexcept { return static_cast<std::size_t>(end_ - next_); }
+
+    private:
+        void take(T& out) noexcept {
+            SlotRef<T> s = q_.slot(next_);
+            move_out_and_destroy(s, out);
+            s.seq.store(next_ + q_.capacity_, RELEASE);
+            ++next_;
+        }
+
+        RingMPMC&            q_;
+        const std::size_t    block_;
+        std::unique_ptr<T[]> spill_;              // flush()'s fallback holds the run here
+        std::uint64_t        next_ = 0, end_ = 0; // claimed, untaken [next_, end_)
+    };
+
+    std::size_t size() const noexcept {
+        auto h = head_.load(RELAXED);
+        auto t = tail_.load(RELAXED);
+        if constexpr (Stats::enabled) { if (t > h) stats_.occupancy(static_cast<std::size_t>(t - h)); }
+        return static_cast<std::size_t>(t - h);
+    }
+
+    // Counters since construction / reset_stats(); all zero with NoStats.
+    RingStatsSnapshot stats() const noexcept { return stats_.snapshot(); }
+    void reset_stats() noexcept { stats_.reset(); }
+
+private:
+#if defined(__cpp_impl_coroutine)
+    // How a woken coroutine is resumed: inline, or posted to an executor.
+    struct Resumer {
+        void (*post)(void*, std::coroutine_handle<>) = nullptr;
+        void* ex = nullptr;
+
+        void operator()(std::coroutine_handle<> h) const {
+            if (post) post(ex, h);
+            else h.resume();
+        }
+    };
+
+    template <class Ex>
+    static Resumer resumer(Ex& ex) noexcept {
+        return { [](void* e, std::coroutine_handle<> h) { static_cast<Ex*>(e)->submit([h] { h.resume(); }); }, &ex };
+    }
+
+    // Op: bool operator()(RingMPMC&) attempts the op (true = done),
+    // result() is what co_await yields, ready(ring) says whether an
+    // attempt could succeed now without attempting it.
+    template <class Op>
+    class Awaitable : AsyncWaiter {
+    public:
+        Awaitable(RingMPMC& q, EventCount& ev, Op op, Resumer r = {}) noexcept
+            : q_(q), ev_(ev), op_(std::move(op)), resume_(r) {}
+
+        bool await_ready() noexcept { return op_(q_); }
+
+        bool await_suspend(std::coroutine_handle<> h) noexcept {
+            h_ = h;
+            this->try_wake = &wake;
+            this->ready = &Op::ready;
+            this->ctx = &q_;
+            for (;;) {
+                EventCount& ev = ev_; // *this may be resumed and gone once queued
+                if (ev.suspend(*this)) return true;
+                if (op_(q_)) return false;
+            }
+        }
+
+        auto await_resume() noexcept { return op_.result(); }
+
+    private:
+        static bool wake(AsyncWaiter* w) noexcept {
+            auto* self = static_cast<Awaitable*>(w);
+            if (!self->op_(self->q_)) return false;
+            const Resumer r = self->resume_;
+            r(self->h_);
+            return true;
+        }
+
+        RingMPMC&               q_;
+        EventCount&             ev_;
+        Op                      op_;
+        Resumer                 resume_;
+        std::coroutine_handle<> h_;
+    };
+
+    struct DequeueOp {
+        T value{};
+        bool operator()(RingMPMC& q) noexcept { return q.try_dequeue(value); }
+        T result() noexcept { return std::move(value); }
+        static bool ready(void* q) noexcept { return static_cast<RingMPMC*>(q)->dequeue_ready(); }
+    };
+
+    struct DequeueManyOp {
+        T*          out;
+        std::size_t n;
+        std::size_t got = 0;
+        bool operator()(RingMPMC& q) noexcept { got = q.dequeue_many(out, n); return got != 0 || n == 0; }
+        std::size_t result() const noexcept { return got; }
+        static bool ready(void* q) noexcept { return static_cast<RingMPMC*>(q)->dequeue_ready(); }
+    };
+
+    struct EnqueueOp {
+        T    value;
+        bool ok = true;
+        bool operator()(RingMPMC& q) noexcept {
+            if constexpr (Overflow::action == OverflowAction::Block) return q.try_enqueue(std::move(value));
+            else { ok = q.enqueue_one(std::move(value)); return true; }
+        }
+        bool result() const noexcept { return ok; }
+        static bool ready(void* q) noexcept { return static_cast<RingMPMC*>(q)->enqueue_ready(); }
+    };
+
+    struct EnqueueManyOp {
+        const T*    data;
+        std::size_t n;
+        std::size_t done = 0;
+        bool operator()(RingMPMC& q) noexcept {
+            if constexpr (Overflow::action == OverflowAction::Block) {
+                done += q.try_enqueue_many(data + done, n - done);
+                return done == n;
+            } else {
+                done = q.enqueue_many(data, n);
+                return true;
+            }
+        }
+        std::size_t result() const noexcept { return done; }
+        static bool ready(void* q) noexcept { return static_cast<RingMPMC*>(q)->enqueue_ready(); }
+    };
+#endif
+
+    // Side-effect-free "would a dequeue / enqueue at the index succeed"
+    // checks for async waiters (a skip ticket counts as ready: stepping
+    // over it is progress).
+    bool dequeue_ready() noexcept {
+        const std::uint64_t h = head_.load(ACQUIRE);
+        const std::uint64_t seq = slot(h).seq.load(ACQUIRE);
+        return seq == h + 1 || seq == h + kSkip;
+    }
+
+    bool enqueue_ready() noexcept {
+        const std::uint64_t t = tail_.load(ACQUIRE);
+        return slot(t).seq.load(ACQUIRE) == t;
+    }
+
+    template <class U>
+    bool enqueue_one(U&& v) noexcept {
+        if constexpr (Overflow::action == OverflowAction::Block) {
+            not_full_.await([&] { return try_enqueue(std::forward<U>(v)); });
+            return true;
+        } else if constexpr (Overflow::action == OverflowAction::OverwriteOldest) {
+            Backoff backoff;
+            while (!try_enqueue(std::forward<U>(v))) {
+                if (evict_oldest(1) == 0) wait_head_slot(backoff);
+            }
+            return true;
+        } else {
+            if (try_enqueue(std::forward<U>(v))) return true;
+            if constexpr (Overflow::action == OverflowAction::DropNewest) stats_.dropped(1);
+            return false;
+        }
+    }
+
+    std::size_t enqueue_many_reserved(const T* data, std::size_t n) noexcept {
         if (n == 0) return 0;
         const std::size_t want = (n > capacity_) ? capacity_ : n;
 
@@ -139,64 +651,27 @@ public:
         std::size_t done = 0;
         for (std::size_t i = 0; i < want; ++i) {
             const std::uint64_t idx = start + i;
-            Slot<T>& s = slot(idx);
+            SlotRef<T> s = slot(idx);
             const std::uint64_t expected = idx;
 
-            int spins = 0;
+            Backoff backoff;
             for (;;) {
                 std::uint64_t seq = s.seq.load(ACQUIRE);
                 if (seq == expected) break;
-                if (++spins < 200) { RING_PAUSE(); }
-                else { std::this_thread::yield(); spins = 0; }
+                stats_.backoff(backoff_wait(backoff, s.seq, seq));
             }
 
             construct_in_slot(s, data[i]);
             s.seq.store(idx + 1, RELEASE);
             ++done;
         }
+        not_empty_.notify();
+        note_enqueued(done, start + want);
         return done;
     }
 
-    // -------- Batched dequeue (non-reserving, claim only ready run) --------
-    std::size_t dequeue_many(T* out, std::size_t n) noexcept {
-        if (n == 0) return 0;
-        n = (n > capacity_) ? capacity_ : n;
-
-        for (;;) {
-            std::uint64_t start = head_.load(RELAXED);
-
-            // Count contiguous ready items
-            std::size_t ready = 0;
-            while (ready < n) {
-                const std::uint64_t idx = start + ready;
-                Slot<T>& s = slot(idx);
-                if (s.seq.load(ACQUIRE) != (idx + 1)) break;
-                ++ready;
-            }
-            if (ready == 0) return 0;
-
-            if (head_.compare_exchange_weak(start, start + ready, ACQ_REL, RELAXED)) {
-                for (std::size_t i = 0; i < ready; ++i) {
-                    const std::uint64_t idx = start + i;
-                    Slot<T>& s = slot(idx);
-                    move_out_and_destroy(s, out[i]);
-                    s.seq.store(idx + capacity_, RELEASE);
-                }
-                return ready;
-            }
-            // lost race; retry
-        }
-    }
-
-    std::size_t size() const noexcept {
-        auto h = head_.load(RELAXED);
-        auto t = tail_.load(RELAXED);
-        return static_cast<std::size_t>(t - h);
-    }
-
-private:
     template <class U>
-    static inline void construct_in_slot(Slot<T>& s, U&& value) noexcept {
+    static inline void construct_in_slot(SlotRef<T> s, U&& value) noexcept {
         if constexpr (std::is_trivially_copyable_v<T>) {
             *s.ptr() = static_cast<T>(std::forward<U>(value));
         } else {
@@ -204,7 +679,7 @@ private:
         }
     }
 
-    static inline void move_out_and_destroy(Slot<T>& s, T& out) noexcept {
+    static inline void move_out_and_destroy(SlotRef<T> s, T& out) noexcept {
         if constexpr (std::is_trivially_copyable_v<T>) {
             out = *s.ptr();
         } else {
@@ -214,19 +689,154 @@ private:
         }
     }
 
-    Slot<T>& slot(std::uint64_t idx) noexcept {
+    // Claims the contiguous run of free slots at tail_ (at most n) by CAS on
+    // tail_; returns its length, 0 when full.
+    std::size_t claim_free(std::size_t n, std::uint64_t& start) noexcept {
+        if (n == 0) return 0;
+        n = (n > capacity_) ? capacity_ : n;
+
+        for (;;) {
+            start = tail_.load(RELAXED);
+
+            // Count contiguous free slots
+            const std::size_t free = detail::ticket_run(slots_, mask_, start, 0, n);
+            if (free == 0) {
+                const std::uint64_t seq = slot(start).seq.load(ACQUIRE);
+                if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(start) < 0) { stats_.full(); return 0; } // full
+                stats_.cas_retry();
+                continue; // tail_ moved since we loaded it
+            }
+
+            if (tail_.compare_exchange_weak(start, start + free, ACQ_REL, RELAXED)) {
+                note_enqueued(free, start + free);
+                return free;
+            }
+            stats_.cas_retry(); // lost race; retry
+        }
+    }
+
+    // Claims the contiguous run of ready items at head_ (at most n) by CAS on
+    // head_; returns its length, 0 when empty.
+    //
+    // A lost CAS keeps the part of the verified run past the new head_ and
+    // only scans on from its end: every ticket at or past head_ is
+    // unconsumed (claims move head_ past their run, a ConsumerBlock only
+    // rewinds it to its first untaken item), so a slot seen ready there is
+    // still ready and its payload already acquired.
+    std::size_t claim_ready(std::size_t n, std::uint64_t& start) noexcept {
+        if (n == 0) return 0;
+        n = (n > capacity_) ? capacity_ : n;
+
+        start = head_.load(RELAXED);
+        std::size_t ready = 0; // [start, start + ready) seen ready
+        std::size_t passes = 0, loads = 0;
+        for (;;) {
+            // Extend the run of contiguous ready items
+            ++passes;
+            if (ready < n) {
+                const std::size_t k = detail::ticket_run(slots_, mask_, start + ready, 1, n - ready);
+                loads += k + (ready + k < n); // the mismatching ticket, if any
+                ready += k;
+            }
+            if (ready == 0) {
+                if (slot(start).seq.load(ACQUIRE) == start + kSkip) { step_over_skip(start); continue; }
+                stats_.empty();
+                return 0;
+            }
+
+            const std::uint64_t seen = start, end = start + ready;
+            if (head_.compare_exchange_weak(start, end, ACQ_REL, RELAXED)) { stats_.scanned(passes, loads); return ready; }
+            stats_.cas_retry(); // lost race: start is the current head_
+            ready = (start >= seen && start < end) ? static_cast<std::size_t>(end - start) : 0;
+        }
+    }
+
+    // OverwriteOldest: discards up to n of the oldest ready items the way a
+    // consumer would (CAS on head_), so the ticket protocol is unchanged and
+    // consumers can never observe a half-overwritten slot.
+    std::size_t evict_oldest(std::size_t n) noexcept {
+        std::uint64_t start = 0;
+        const std::size_t k = claim_ready(n, start);
+        for (std::size_t i = 0; i < k; ++i) {
+            const std::uint64_t idx = start + i;
+            SlotRef<T> s = slot(idx);
+            if constexpr (!std::is_trivially_destructible_v<T>) s.ptr()->~T();
+            s.seq.store(idx + capacity_, RELEASE);
+        }
+        if (k) { not_full_.notify(); stats_.dropped(k); }
+        return k;
+    }
+
+    // OverwriteOldest with nothing to evict and no room: the slot at head_
+    // is mid-write (or mid-free), so wait per Backoff for it to move on
+    // rather than spinning on claim_ready.
+    void wait_head_slot(Backoff& backoff) noexcept {
+        SlotRef<T> s = slot(head_.load(ACQUIRE));
+        stats_.backoff(backoff_wait(backoff, s.seq, s.seq.load(ACQUIRE)));
+    }
+
+    // Ticket idx handed back unfilled by a ProducerBlock: seq = idx + kSkip
+    // (neither free, ready nor consumed for capacity >= 4), and the consumer
+    // that reaches it moves head_ past without producing an item.
+    static constexpr std::uint64_t kSkip = 2;
+
+    void mark_skip(std::uint64_t idx) noexcept {
+        SlotRef<T> s = slot(idx);
+        Backoff backoff;
+        for (;;) {
+            const std::uint64_t seq = s.seq.load(ACQUIRE);
+            if (seq == idx) break;
+            stats_.backoff(backoff_wait(backoff, s.seq, seq));
+        }
+        s.seq.store(idx + kSkip, RELEASE);
+        not_empty_.notify(); // items behind the skip may be ready
+    }
+
+    // pos holds a skip ticket: claim it like an item and free the slot.
+    // On a lost race pos is reloaded from head_.
+    void step_over_skip(std::uint64_t& pos) noexcept {
+        if (head_.compare_exchange_weak(pos, pos + 1, ACQ_REL, RELAXED)) {
+            slot(pos).seq.store(pos + capacity_, RELEASE);
+            not_full_.notify();
+            pos += 1;
+        } else {
+            stats_.cas_retry();
+        }
+    }
+
+    // Counts n enqueued items ending at ticket end; with stats on, also
+    // samples occupancy (costs a load of head_).
+    void note_enqueued(std::size_t n, std::uint64_t end) noexcept {
+        stats_.enqueued(n);
+        if constexpr (Stats::enabled) {
+            const std::uint64_t h = head_.load(RELAXED);
+            if (end > h) stats_.occupancy(static_cast<std::size_t>(end - h));
+        }
+    }
+
+    SlotRef<T> slot(std::uint64_t idx) noexcept {
         return slots_[static_cast<std::size_t>(idx) & mask_];
     }
 
 private:
-    const std::size_t capacity_;
-    const std::size_t mask_;
-    Slot<T>* slots_;
+    [[no_unique_address]] const typename detail::ring_size_types<Layout>::capacity_type capacity_;
+    [[no_unique_address]] const typename detail::ring_size_types<Layout>::mask_type     mask_;
+    storage_type slots_;
 
     alignas(64) std::atomic<std::uint64_t> head_;
     CachePad _pad1_;
     alignas(64) std::atomic<std::uint64_t> tail_;
     CachePad _pad2_;
+
+    alignas(64) EventCount not_empty_; // consumers park here
+    alignas(64) EventCount not_full_;  // producers park here
+
+    [[no_unique_address]] Stats stats_;
 };
 
+// RingMPMC with compile-time capacity N and inline slots (see Fixed in ring.hpp).
+template <class T, std::size_t N, class Layout = PaddedLayout, class Backoff = DefaultBackoff, class Stats = NoStats,
+          class Overflow = BlockOnFull>
+using FixedRingMPMC = RingMPMC<T, Fixed<N, Layout>, Backoff, Stats, Overflow>;
+
 } // namespace ring
@@ -7,94 +7,244 @@
 #include <utility>
 #include <chrono>
 #include <thread>
+#include "backoff.hpp"
+#include "park.hpp"
 #include "ring.hpp"
 #include "utils.hpp"
 
 namespace ring {
 
 // Single-Producer / Single-Consumer ring with ticketed slots.
-template <class T>
+// Layout selects the slot memory layout (see ring.hpp), Backoff how waiting
+// loops back off (see backoff.hpp).
+template <class T, class Layout = PaddedLayout, class Backoff = DefaultBackoff>
 class RingSPSC {
 public:
-    explicit RingSPSC(std::size_t capacity)
+    using layout_type  = Layout;
+    using backoff_type = Backoff;
+    using storage_type = typename Layout::template storage<T>;
+    using span_type    = SlotSpan<T, storage_type>;
+
+    // Non-zero for Fixed<N> layouts (capacity known at compile time).
+    static constexpr std::size_t fixed_capacity = detail::fixed_capacity<Layout>::value;
+
+    // alloc decides where slot storage lives (heap by default; see numa.hpp).
+    explicit RingSPSC(std::size_t capacity, const SlotAllocator& alloc = {}) requires (fixed_capacity == 0)
         : capacity_(next_pow2(capacity)),
           mask_(capacity_ - 1),
-          slots_(static_cast<Slot<T>*>(::operator new[](capacity_ * sizeof(Slot<T>)))),
+          slots_(capacity_, alloc),
+          head_(0), tail_(0)
+    {}
+
+    // Fixed<N> layouts: N inline slots, nothing allocated.
+    RingSPSC() requires (fixed_capacity != 0)
+        : capacity_(fixed_capacity),
+          mask_(fixed_capacity - 1),
           head_(0), tail_(0)
-    {
-        for (std::size_t i = 0; i < capacity_; ++i) {
-            new (&slots_[i]) Slot<T>();
-            slots_[i].seq.store(static_cast<std::uint64_t>(i), RELAXED);
+    {}
+
+    // Destroys the items still queued between head_ and tail_; nothing to
+    // walk for trivially destructible T. Must not race with any other call.
+    ~RingSPSC() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            const std::uint64_t end = tail_.load(RELAXED);
+            for (std::uint64_t i = head_.load(RELAXED); i < end; ++i) slot(i).ptr()->~T();
         }
     }
 
-    ~RingSPSC() { ::operator delete[](slots_); }
-
     RingSPSC(const RingSPSC&) = delete;
     RingSPSC& operator=(const RingSPSC&) = delete;
 
     std::size_t capacity() const noexcept { return capacity_; }
+    static constexpr std::size_t bytes_per_slot() noexcept { return storage_type::bytes_per_slot; }
 
     bool try_enqueue(const T& v) noexcept {
         const std::uint64_t t = tail_.load(RELAXED);
-        Slot<T>& s = slot(t);
+        SlotRef<T> s = slot(t);
         if (s.seq.load(ACQUIRE) != t) return false; // full
         construct_in_slot(s, v);
         s.seq.store(t + 1, RELEASE);
-        tail_.store(t + 1, RELAXED);
+        tail_.store(t + 1, RELEASE);
+        not_empty_.notify();
         return true;
     }
 
     bool try_enqueue(T&& v) noexcept {
         const std::uint64_t t = tail_.load(RELAXED);
-        Slot<T>& s = slot(t);
+        SlotRef<T> s = slot(t);
         if (s.seq.load(ACQUIRE) != t) return false;
         construct_in_slot(s, std::move(v));
         s.seq.store(t + 1, RELEASE);
-        tail_.store(t + 1, RELAXED);
+        tail_.store(t + 1, RELEASE);
+        not_empty_.notify();
         return true;
     }
 
     bool try_dequeue(T& out) noexcept {
         const std::uint64_t h = head_.load(RELAXED);
-        Slot<T>& s = slot(h);
+        SlotRef<T> s = slot(h);
         if (s.seq.load(ACQUIRE) != (h + 1)) return false; // empty
         move_out_and_destroy(s, out);
         s.seq.store(h + capacity_, RELEASE);
-        head_.store(h + 1, RELAXED);
+        head_.store(h + 1, RELEASE);
+        not_full_.notify();
         return true;
     }
 
     template <class Clock, class Dur>
     bool enqueue_until(const T& v, const std::chrono::time_point<Clock, Dur>& deadline) noexcept {
-        do { if (try_enqueue(v)) return true; std::this_thread::yield(); }
+        Backoff backoff;
+        do { if (try_enqueue(v)) return true; backoff.wait(head_, head_.load(RELAXED)); }
         while (Clock::now() < deadline);
         return false;
     }
 
     template <class Clock, class Dur>
     bool dequeue_until(T& out, const std::chrono::time_point<Clock, Dur>& deadline) noexcept {
-        do { if (try_dequeue(out)) return true; std::this_thread::yield(); }
+        Backoff backoff;
+        do { if (try_dequeue(out)) return true; backoff.wait(tail_, tail_.load(RELAXED)); }
         while (Clock::now() < deadline);
         return false;
     }
 
+    // -------- Blocking ops (park instead of spinning) --------
+    // Waiters park on futex/WaitOnAddress; the opposite side only issues a
+    // wake when somebody is parked (see EventCount in park.hpp).
+    void enqueue(const T& v) noexcept { not_full_.await([&] { return try_enqueue(v); }); }
+    void enqueue(T&& v) noexcept { not_full_.await([&] { return try_enqueue(std::move(v)); }); }
+    void dequeue(T& out) noexcept { not_empty_.await([&] { return try_dequeue(out); }); }
+
+    template <class Rep, class Period>
+    bool enqueue_for(const T& v, const std::chrono::duration<Rep, Period>& timeout) noexcept {
+        return not_full_.await_until([&] { return try_enqueue(v); }, std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <class Rep, class Period>
+    bool dequeue_for(T& out, const std::chrono::duration<Rep, Period>& timeout) noexcept {
+        return not_empty_.await_until([&] { return try_dequeue(out); }, std::chrono::steady_clock::now() + timeout);
+    }
+
+    // -------- Batched ops (cached peer index) --------
+    // The producer keeps a private copy of head_ and the consumer one of
+    // tail_; the shared index is only re-read when the cached value says the
+    // ring is full/empty. Slots still carry their tickets, so batch and
+    // single-item ops can be mixed freely (single-item ops don't refresh the
+    // caches, so a cache may fall behind our own index; treat that as 0). A
+    // fresh load can trail as well: single-item ops publish the slot ticket
+    // before moving tail_ / head_, so the other side may already be past it.
+
+    // Non-blocking: returns how many of data[0..n) were enqueued (0 if full).
+    std::size_t try_enqueue_many(const T* data, std::size_t n) noexcept {
+        const span_type r = reserve(n);
+        if constexpr (span_type::bulk_copy) {
+            r.copy_in(data);
+        } else {
+            for (std::size_t i = 0; i < r.count; ++i) construct_in_slot(slot(r.start + i), data[i]);
+        }
+        commit(r);
+        return r.count;
+    }
+
+    // Waits (per Backoff) until min(n, capacity) items are enqueued.
+    std::size_t enqueue_many(const T* data, std::size_t n) noexcept {
+        const std::size_t want = (n > capacity_) ? capacity_ : n;
+        std::size_t done = 0;
+        Backoff backoff;
+        while (done < want) {
+            done += try_enqueue_many(data + done, want - done);
+            if (done < want) backoff.wait(head_, head_.load(RELAXED));
+        }
+        return done;
+    }
+
+    std::size_t dequeue_many(T* out, std::size_t n) noexcept {
+        const span_type r = peek(n);
+        if constexpr (span_type::bulk_copy) {
+            r.copy_out(out);
+        } else {
+            for (std::size_t i = 0; i < r.count; ++i) out[i] = std::move(*r[i]);
+        }
+        release(r);
+        return r.count;
+    }
+
+    // -------- Zero-copy produce / consume --------
+    // reserve(n) returns up to n free slots (possibly none); construct a T in
+    // every r[i], then commit(r) publishes them. peek(n) returns up to n ready
+    // items for in-place reads; release(r) destroys them and frees the slots.
+    // One outstanding reservation per side: tail_/head_ only move on
+    // commit/release.
+    span_type reserve(std::size_t n) noexcept {
+        const std::uint64_t t = tail_.load(RELAXED);
+        std::size_t free = (head_cache_ + capacity_ > t)
+                         ? static_cast<std::size_t>(head_cache_ + capacity_ - t) : 0;
+        if (free < n) {
+            head_cache_ = head_.load(ACQUIRE);
+            free = (head_cache_ + capacity_ > t) ? static_cast<std::size_t>(head_cache_ + capacity_ - t) : 0;
+        }
+        return { &slots_, mask_, t, (n > free) ? free : n };
+    }
+
+    void commit(const span_type& r) noexcept {
+        if (r.count == 0) return;
+        for (std::size_t i = 0; i < r.count; ++i) {
+            slot(r.start + i).seq.store(r.start + i + 1, RELEASE);
+        }
+        tail_.store(r.start + r.count, RELEASE);
+        not_empty_.notify();
+    }
+
+    span_type peek(std::size_t n) noexcept {
+        const std::uint64_t h = head_.load(RELAXED);
+        std::size_t ready = (tail_cache_ > h) ? static_cast<std::size_t>(tail_cache_ - h) : 0;
+        if (ready < n) {
+            tail_cache_ = tail_.load(ACQUIRE);
+            ready = (tail_cache_ > h) ? static_cast<std::size_t>(tail_cache_ - h) : 0;
+        }
+        return { &slots_, mask_, h, (n > ready) ? ready : n };
+    }
+
+    void release(const span_type& r) noexcept {
+        if (r.count == 0) return;
+        for (std::size_t i = 0; i < r.count; ++i) {
+            SlotRef<T> s = slot(r.start + i);
+            if constexpr (!std::is_trivially_destructible_v<T>) s.ptr()->~T();
+            s.seq.store(r.start + i + capacity_, RELEASE);
+        }
+        head_.store(r.start + r.count, RELEASE);
+        not_full_.notify();
+    }
+
+    // -------- Drain (consumer) --------
+    // Hands every ready item to f(T&&) and frees its slot until the ring is
+    // empty; returns the count. f must not throw.
+    template <class F>
+    std::size_t drain(F&& f) {
+        std::size_t total = 0;
+        for (span_type r = peek(capacity_); !r.empty(); r = peek(capacity_)) {
+            for (std::size_t i = 0; i < r.count; ++i) f(std::move(*r[i]));
+            release(r);
+            total += r.count;
+        }
+        return total;
+    }
+
     std::size_t size() const noexcept {
         auto h = head_.load(RELAXED);
         auto t = tail_.load(RELAXED);
-        return static_cast<std::size_t>(t - h);
+        return (t > h) ? static_cast<std::size_t>(t - h) : 0;
     }
 
 private:
     template <class U>
-    static inline void construct_in_slot(Slot<T>& s, U&& value) noexcept {
+    static inline void construct_in_slot(SlotRef<T> s, U&& value) noexcept {
         if constexpr (std::is_trivially_copyable_v<T>) {
             *s.ptr() = static_cast<T>(std::forward<U>(value));
         } else {
             new (s.ptr()) T(std::forward<U>(value));
         }
     }
-    static inline void move_out_and_destroy(Slot<T>& s, T& out) noexcept {
+    static inline void move_out_and_destroy(SlotRef<T> s, T& out) noexcept {
         if constexpr (std::is_trivially_copyable_v<T>) {
             out = *s.ptr();
         } else {
@@ -104,17 +254,26 @@ private:
         }
     }
 
-    Slot<T>& slot(std::uint64_t idx) noexcept { return slots_[static_cast<std::size_t>(idx) & mask_]; }
+    SlotRef<T> slot(std::uint64_t idx) noexcept { return slots_[static_cast<std::size_t>(idx) & mask_]; }
 
 private:
-    const std::size_t capacity_;
-    const std::size_t mask_;
-    Slot<T>* slots_;
+    [[no_unique_address]] const typename detail::ring_size_types<Layout>::capacity_type capacity_;
+    [[no_unique_address]] const typename detail::ring_size_types<Layout>::mask_type     mask_;
+    storage_type slots_;
 
     alignas(64) std::atomic<std::uint64_t> head_;
+    std::uint64_t tail_cache_ = 0; // consumer-owned copy of tail_
     CachePad _pad1_;
     alignas(64) std::atomic<std::uint64_t> tail_;
+    std::uint64_t head_cache_ = 0; // producer-owned copy of head_
     CachePad _pad2_;
+
+    alignas(64) EventCount not_empty_; // consumer parks here
+    alignas(64) EventCount not_full_;  // producer parks here
 };
 
+// RingSPSC with compile-time capacity N and inline slots (see Fixed in ring.hpp).
+template <class T, std::size_t N, class Layout = PaddedLayout, class Backoff = DefaultBackoff>
+using FixedRingSPSC = RingSPSC<T, Fixed<N, Layout>, Backoff>;
+
 } // namespace ring
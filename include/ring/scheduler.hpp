@@ -0,0 +1,195 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "backoff.hpp"
+#include "park.hpp"
+#include "ring_mpmc.hpp"
+#include "work_stealing.hpp"
+
+namespace ring {
+
+// Heap-allocated, type-erased unit of work. Queues carry Task*; invoke()
+// runs the task and frees it.
+struct Task {
+    void (*invoke)(Task*) noexcept;
+};
+
+namespace detail {
+
+template <class F>
+struct TaskImpl final : Task {
+    explicit TaskImpl(F&& f) : Task{&run}, fn(std::move(f)) {}
+    explicit TaskImpl(const F& f) : Task{&run}, fn(f) {}
+
+    static void run(Task* t) noexcept {
+        auto* self = static_cast<TaskImpl*>(t);
+        self->fn();
+        delete self;
+    }
+
+    F fn;
+};
+
+template <class F>
+Task* make_task(F&& f) { return new TaskImpl<std::decay_t<F>>(std::forward<F>(f)); }
+
+struct SchedulerTls {
+    const void* scheduler = nullptr;
+    int         worker    = -1;
+};
+
+inline SchedulerTls& scheduler_tls() noexcept {
+    thread_local SchedulerTls tls;
+    return tls;
+}
+
+inline std::uint64_t xorshift(std::uint64_t& s) noexcept {
+    s ^= s << 13; s ^= s >> 7; s ^= s << 17;
+    return s;
+}
+
+} // namespace detail
+
+// Outstanding-task counter for fork/join: Scheduler::spawn(g, f) adds one,
+// the task's completion removes it, Scheduler::wait(g) helps run other
+// tasks until it reaches zero.
+class TaskGroup {
+public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void add(std::size_t n = 1) noexcept { pending_.fetch_add(n, RELAXED); }
+    void finish() noexcept { pending_.fetch_sub(1, RELEASE); }
+    bool done() const noexcept { return pending_.load(ACQUIRE) == 0; }
+
+private:
+    std::atomic<std::size_t> pending_{0};
+};
+
+// Work-stealing thread pool.
+//
+// Each worker owns a WorkStealingDeque: tasks submitted from a worker go to
+// its own deque (LIFO for locality, no shared CAS), tasks from other
+// threads go through one shared RingMPMC injection queue. An idle worker
+// takes from its deque, then the injection queue, then steals from random
+// victims, and after a short spin parks on an EventCount until new work is
+// pushed. Destruction runs every queued task before joining.
+class Scheduler {
+    static constexpr int kIdleSpins = 64;
+
+    struct alignas(64) Worker {
+        WorkStealingDeque<Task*> deque{256};
+        std::uint64_t            rng;
+        explicit Worker(std::uint64_t seed) : rng(seed) {}
+    };
+
+public:
+    // workers = 0: one per hardware thread.
+    explicit Scheduler(unsigned workers = 0, std::size_t inject_capacity = 4096)
+        : inject_(inject_capacity)
+    {
+        if (workers == 0) workers = std::thread::hardware_concurrency();
+        if (workers == 0) workers = 1;
+        for (unsigned i = 0; i < workers; ++i) workers_.push_back(std::make_unique<Worker>(0x9E3779B97F4A7C15ull * (i + 1)));
+        for (unsigned i = 0; i < workers; ++i) threads_.emplace_back([this, i] { worker_loop(static_cast<int>(i)); });
+    }
+
+    ~Scheduler() {
+        stop_.store(true, RELEASE);
+        idle_.notify();
+        for (auto& t : threads_) t.join();
+    }
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    unsigned worker_count() const noexcept { return static_cast<unsigned>(workers_.size()); }
+
+    // Index of the calling worker thread, -1 for threads outside this pool.
+    int current_worker() const noexcept {
+        const detail::SchedulerTls& tls = detail::scheduler_tls();
+        return tls.scheduler == this ? tls.worker : -1;
+    }
+
+    // Fire and forget.
+    template <class F>
+    void submit(F&& f) { push(detail::make_task(std::forward<F>(f))); }
+
+    // Runs f as part of g.
+    template <class F>
+    void spawn(TaskGroup& g, F&& f) {
+        g.add();
+        submit([&g, fn = std::forward<F>(f)]() mutable { fn(); g.finish(); });
+    }
+
+    // Runs queued tasks on the calling thread until g is done. Callable from
+    // workers (fork/join) and from outside threads.
+    void wait(TaskGroup& g) noexcept {
+        const int self = current_worker();
+        int spins = 0;
+        while (!g.done()) {
+            if (Task* t = find(self)) { t->invoke(t); spins = 0; continue; }
+            if (++spins < kIdleSpins) cpu_relax();
+            else { std::this_thread::yield(); spins = 0; }
+        }
+    }
+
+private:
+    void push(Task* t) {
+        const int self = current_worker();
+        if (self >= 0) workers_[static_cast<std::size_t>(self)]->deque.push(t);
+        else inject_.enqueue(t); // parks while the injection ring is full
+        idle_.notify();
+    }
+
+    Task* find(int self) noexcept {
+        if (self >= 0) {
+            if (auto t = workers_[static_cast<std::size_t>(self)]->deque.take()) return *t;
+        }
+        Task* t = nullptr;
+        if (inject_.try_dequeue(t)) return t;
+
+        const std::size_t n = workers_.size();
+        thread_local std::uint64_t outside_rng = 0x2545F4914F6CDD1Dull;
+        std::uint64_t& rng = self >= 0 ? workers_[static_cast<std::size_t>(self)]->rng : outside_rng;
+        const std::size_t start = static_cast<std::size_t>(detail::xorshift(rng) % n);
+        for (std::size_t k = 0; k < n; ++k) {
+            const std::size_t victim = (start + k) % n;
+            if (static_cast<int>(victim) == self) continue;
+            if (auto s = workers_[victim]->deque.steal()) return *s;
+        }
+        return nullptr;
+    }
+
+    void worker_loop(int self) noexcept {
+        detail::scheduler_tls() = { this, self };
+        int spins = 0;
+        for (;;) {
+            if (Task* t = find(self)) { t->invoke(t); spins = 0; continue; }
+            if (stop_.load(ACQUIRE)) break;
+            if (++spins < kIdleSpins) { cpu_relax(); continue; }
+            spins = 0;
+
+            Task* t = nullptr;
+            idle_.await([&] { t = find(self); return t != nullptr || stop_.load(ACQUIRE); });
+            if (t) t->invoke(t);
+        }
+        detail::scheduler_tls() = {};
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    RingMPMC<Task*> inject_;   // submissions from outside the pool
+    EventCount idle_;          // parked idle workers
+    std::atomic<bool> stop_{false};
+    std::vector<std::thread> threads_;
+};
+
+} // namespace ring
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "numa.hpp"
+#include "ring_mpmc.hpp"
+
+namespace ring {
+
+// One RingMPMC per NUMA node, each with node-local slot storage.
+// Every call works against a home shard (by default the shard of the
+// calling thread's node): producers spill to remote shards only when home
+// is full, consumers drain home first and steal from remote shards only
+// when it is empty. Ordering holds per shard, not across shards.
+template <class T, class Layout = PaddedLayout, class Backoff = DefaultBackoff>
+class ShardedRing {
+public:
+    using ring_type = RingMPMC<T, Layout, Backoff>;
+
+    // One shard per online NUMA node.
+    explicit ShardedRing(std::size_t capacity_per_shard)
+        : ShardedRing(capacity_per_shard, numa_nodes()) {}
+
+    // One shard per entry of nodes (repeats allowed, e.g. for testing).
+    ShardedRing(std::size_t capacity_per_shard, const std::vector<int>& nodes)
+        : nodes_(nodes.empty() ? std::vector<int>{0} : nodes)
+    {
+        for (int n : nodes_) {
+            shards_.push_back(std::make_unique<ring_type>(capacity_per_shard, node_local_allocator(n)));
+        }
+    }
+
+    ShardedRing(const ShardedRing&) = delete;
+    ShardedRing& operator=(const ShardedRing&) = delete;
+
+    std::size_t shard_count() const noexcept { return shards_.size(); }
+    ring_type&  shard(std::size_t i) noexcept { return *shards_[i]; }
+    int         shard_node(std::size_t i) const noexcept { return nodes_[i]; }
+
+    // First shard on the calling thread's node (shard 0 if none matches).
+    std::size_t home_shard() const noexcept {
+        const int node = this_thread_numa_node();
+        for (std::size_t i = 0; i < nodes_.size(); ++i) if (nodes_[i] == node) return i;
+        return 0;
+    }
+
+    // -------- Producers: home first, spill when full --------
+    bool try_enqueue(const T& v) noexcept { return try_enqueue(home_shard(), v); }
+
+    bool try_enqueue(std::size_t home, const T& v) noexcept {
+        for (std::size_t k = 0; k < shards_.size(); ++k) {
+            if (at(home + k).try_enqueue(v)) return true;
+        }
+        return false;
+    }
+
+    std::size_t try_enqueue_many(const T* data, std::size_t n) noexcept {
+        return try_enqueue_many(home_shard(), data, n);
+    }
+
+    std::size_t try_enqueue_many(std::size_t home, const T* data, std::size_t n) noexcept {
+        std::size_t done = 0;
+        for (std::size_t k = 0; k < shards_.size() && done < n; ++k) {
+            done += at(home + k).try_enqueue_many(data + done, n - done);
+        }
+        return done;
+    }
+
+    // -------- Consumers: drain home, steal only when it is empty --------
+    bool try_dequeue(T& out) noexcept { return try_dequeue(home_shard(), out); }
+
+    bool try_dequeue(std::size_t home, T& out) noexcept {
+        for (std::size_t k = 0; k < shards_.size(); ++k) {
+            if (at(home + k).try_dequeue(out)) return true;
+        }
+        return false;
+    }
+
+    std::size_t dequeue_many(T* out, std::size_t n) noexcept { return dequeue_many(home_shard(), out, n); }
+
+    std::size_t dequeue_many(std::size_t home, T* out, std::size_t n) noexcept {
+        for (std::size_t k = 0; k < shards_.size(); ++k) {
+            const std::size_t got = at(home + k).dequeue_many(out, n);
+            if (got) return got;
+        }
+        return 0;
+    }
+
+    std::size_t size() const noexcept {
+        std::size_t total = 0;
+        for (const auto& s : shards_) total += s->size();
+        return total;
+    }
+
+private:
+    ring_type& at(std::size_t i) noexcept { return *shards_[i % shards_.size()]; }
+
+    const std::vector<int> nodes_;
+    std::vector<std::unique_ptr<ring_type>> shards_;
+};
+
+} // namespace ring
@@ -0,0 +1,531 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include "backoff.hpp"
+#include "ring.hpp"
+#include "utils.hpp"
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+  #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <signal.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace ring {
+
+// Inter-process rings over one named shared-memory region
+// (shm_open + mmap on POSIX, CreateFileMapping on Windows).
+//
+// The region starts with a ShmHeader (format version, ring kind, capacity,
+// slot size, head/tail) followed by the slot array; everything is found at
+// offsets from the mapping base, so each process may map it anywhere.
+// T must be trivially copyable: payloads are copied in and out as bytes and
+// never constructed or destroyed.
+//
+// Initialization is crash safe. The initializer stamps the header state with
+// its pid, fills it in, then publishes kShmReady with a release store;
+// attachers wait (up to a timeout) for kShmReady. If the initializer died
+// half way, a later open_or_create with a capacity takes over and
+// re-initializes; that includes a creator gone before it could size the
+// region, which open_or_create then sizes itself. POSIX regions outlive their processes: call unlink() when
+// the ring is retired (attaching to a ready region resumes where it was).
+//
+// Waiting loops only spin/yield/sleep via Backoff; EventCount wakeups are
+// process-private, so the parking enqueue()/dequeue() of the in-process
+// rings are not offered here.
+
+enum class ShmMode {
+    Create,       // fail if the region exists
+    Attach,       // wait for an existing region to become ready
+    OpenOrCreate, // attach if present, else create
+};
+
+namespace detail {
+
+constexpr std::uint32_t kShmMagic    = 0x474e4952u;          // "RING"
+constexpr std::uint32_t kShmVersion  = 1;                    // bump on header/slot layout changes
+constexpr std::uint64_t kShmReady    = 0x5944414552ull;      // "READY"
+constexpr std::uint64_t kShmInitTag  = 1ull << 63;           // | pid while initializing
+
+enum class ShmKind : std::uint32_t { Spsc = 1, Mpmc = 2 };
+
+struct ShmHeader {
+    std::atomic<std::uint64_t> state;  // 0 (fresh), kShmInitTag | pid, kShmReady
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t kind;
+    std::uint32_t slot_bytes;          // sizeof one slot
+    std::uint64_t capacity;
+    std::uint64_t slots_offset;        // from the region base
+    std::uint64_t total_bytes;
+    alignas(64) std::atomic<std::uint64_t> head;
+    alignas(64) std::atomic<std::uint64_t> tail;
+    CachePad pad;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared rings need address-free 64-bit atomics");
+
+inline std::uint64_t shm_slots_offset() noexcept { return (sizeof(ShmHeader) + 63) & ~std::uint64_t(63); }
+
+inline std::uint64_t current_pid() noexcept {
+#if defined(_WIN32)
+    return GetCurrentProcessId();
+#else
+    return static_cast<std::uint64_t>(::getpid());
+#endif
+}
+
+inline bool process_alive(std::uint64_t pid) noexcept {
+#if defined(_WIN32)
+    HANDLE h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+    if (!h) return GetLastError() == ERROR_ACCESS_DENIED;
+    DWORD code = 0;
+    const bool alive = GetExitCodeProcess(h, &code) && code == STILL_ACTIVE;
+    CloseHandle(h);
+    return alive;
+#else
+    return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+[[noreturn]] inline void shm_throw_os(const std::string& what) {
+#if defined(_WIN32)
+    throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+#else
+    throw std::system_error(errno, std::generic_category(), what);
+#endif
+}
+
+// A mapped named region. Creating sizes it to `bytes`; attaching maps
+// whatever size the creator chose, retrying until the region exists.
+// OpenOrCreate sizes a region still at zero length to `bytes` (POSIX).
+class ShmRegion {
+public:
+    ShmRegion(ShmMode mode, const std::string& name, std::size_t bytes, std::chrono::milliseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+#if defined(_WIN32)
+        const std::string os_name = "Local\\" + (name.empty() || name[0] != '/' ? name : name.substr(1));
+        if (mode != ShmMode::Attach) {
+            const unsigned long long len = bytes;
+            map_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                      static_cast<DWORD>(len >> 32), static_cast<DWORD>(len), os_name.c_str());
+            if (!map_) shm_throw_os("CreateFileMapping " + name);
+            created_ = GetLastError() != ERROR_ALREADY_EXISTS;
+            if (!created_ && mode == ShmMode::Create) {
+                CloseHandle(map_);
+                throw std::runtime_error("shm region already exists: " + name);
+            }
+        } else {
+            while (!(map_ = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, os_name.c_str()))) {
+                if (std::chrono::steady_clock::now() >= deadline) shm_throw_os("OpenFileMapping " + name);
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        base_ = MapViewOfFile(map_, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        if (!base_) { const DWORD e = GetLastError(); CloseHandle(map_); SetLastError(e); shm_throw_os("MapViewOfFile " + name); }
+        MEMORY_BASIC_INFORMATION mbi{};
+        VirtualQuery(base_, &mbi, sizeof(mbi));
+        size_ = mbi.RegionSize;
+#else
+        const std::string os_name = (!name.empty() && name[0] == '/') ? name : "/" + name;
+        int fd = -1;
+        if (mode != ShmMode::Attach) {
+            fd = ::shm_open(os_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+            if (fd >= 0) {
+                created_ = true;
+                if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                    const int e = errno;
+                    ::close(fd);
+                    ::shm_unlink(os_name.c_str());
+                    errno = e;
+                    shm_throw_os("ftruncate " + name);
+                }
+            } else if (errno != EEXIST) {
+                shm_throw_os("shm_open " + name);
+            } else if (mode == ShmMode::Create) {
+                throw std::runtime_error("shm region already exists: " + name);
+            }
+        }
+        if (!created_) {
+            // The creator may not have shm_open()ed or ftruncate()d yet, or
+            // may have died in between. OpenOrCreate knows the size it would
+            // have created and sizes a zero-length region itself (the same
+            // size as the creator's for the same capacity, so racing a live
+            // creator is harmless); the header init then runs as usual.
+            struct stat st{};
+            for (;;) {
+                if (fd < 0) fd = ::shm_open(os_name.c_str(), O_RDWR, 0600);
+                if (fd >= 0 && ::fstat(fd, &st) == 0) {
+                    if (st.st_size > 0) break;
+                    if (mode == ShmMode::OpenOrCreate) {
+                        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                            const int e = errno;
+                            ::close(fd);
+                            errno = e;
+                            shm_throw_os("ftruncate " + name);
+                        }
+                        continue;
+                    }
+                }
+                if (fd < 0 && errno != ENOENT) shm_throw_os("shm_open " + name);
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    if (fd >= 0) ::close(fd);
+                    throw std::runtime_error("timed out attaching shm region: " + name);
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            bytes = static_cast<std::size_t>(st.st_size);
+        }
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const int e = errno;
+        ::close(fd); // the mapping keeps the object alive
+        if (p == MAP_FAILED) { errno = e; shm_throw_os("mmap " + name); }
+        base_ = p;
+        size_ = bytes;
+#endif
+    }
+
+    ~ShmRegion() {
+#if defined(_WIN32)
+        UnmapViewOfFile(base_);
+        CloseHandle(map_);
+#else
+        ::munmap(base_, size_);
+#endif
+    }
+
+    ShmRegion(const ShmRegion&) = delete;
+    ShmRegion& operator=(const ShmRegion&) = delete;
+
+    void*       base()    const noexcept { return base_; }
+    std::size_t size()    const noexcept { return size_; }
+    bool        created() const noexcept { return created_; }
+
+    // Removes the name; existing mappings stay valid. No-op on Windows, where
+    // the region goes away with its last handle.
+    static bool unlink(const std::string& name) noexcept {
+#if defined(_WIN32)
+        (void)name;
+        return true;
+#else
+        const std::string os_name = (!name.empty() && name[0] == '/') ? name : "/" + name;
+        return ::shm_unlink(os_name.c_str()) == 0;
+#endif
+    }
+
+private:
+    void*       base_    = nullptr;
+    std::size_t size_    = 0;
+    bool        created_ = false;
+#if defined(_WIN32)
+    HANDLE      map_     = nullptr;
+#endif
+};
+
+// Runs the init protocol on a mapped header. init(h) fills in everything
+// but state; it runs only when may_init (we know the capacity) and the
+// header is fresh or its initializer is dead.
+template <class Init>
+void shm_init_or_wait(ShmHeader& h, bool may_init, std::chrono::milliseconds timeout, Init&& init) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        std::uint64_t s = h.state.load(ACQUIRE);
+        if (s == kShmReady) return;
+        const bool stale = (s & kShmInitTag) && !process_alive(s & ~kShmInitTag);
+        if (may_init && (s == 0 || stale) &&
+            h.state.compare_exchange_strong(s, kShmInitTag | current_pid(), ACQ_REL, ACQUIRE)) {
+            init(h);
+            h.state.store(kShmReady, RELEASE);
+            return;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            throw std::runtime_error(stale ? "shm ring initializer died" : "timed out waiting for shm ring init");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// Maps (and if needed initializes) a region holding `capacity` slots of
+// Slot; capacity 0 attaches to whatever capacity the region has.
+template <class Slot, class Init>
+ShmHeader& shm_open_ring(ShmRegion& region, ShmKind kind, std::size_t capacity,
+                         std::chrono::milliseconds timeout, Init&& init_slots) {
+    if (region.size() < shm_slots_offset()) throw std::runtime_error("shm region too small for a ring header");
+    ShmHeader& h = *std::launder(reinterpret_cast<ShmHeader*>(region.base()));
+    const std::uint64_t total = shm_slots_offset() + std::uint64_t(capacity) * sizeof(Slot);
+    const bool may_init = capacity != 0 && region.size() >= total;
+
+    shm_init_or_wait(h, may_init, timeout, [&](ShmHeader& hh) {
+        hh.magic        = kShmMagic;
+        hh.version      = kShmVersion;
+        hh.kind         = static_cast<std::uint32_t>(kind);
+        hh.slot_bytes   = static_cast<std::uint32_t>(sizeof(Slot));
+        hh.capacity     = capacity;
+        hh.slots_offset = shm_slots_offset();
+        hh.total_bytes  = total;
+        hh.head.store(0, RELAXED);
+        hh.tail.store(0, RELAXED);
+        init_slots(reinterpret_cast<std::byte*>(region.base()) + hh.slots_offset, capacity);
+    });
+
+    if (h.magic != kShmMagic || h.version != kShmVersion || h.kind != static_cast<std::uint32_t>(kind) ||
+        h.slot_bytes != sizeof(Slot) || h.total_bytes > region.size() ||
+        (capacity != 0 && h.capacity != capacity)) {
+        throw std::runtime_error("shm ring layout mismatch (version, kind, slot type or capacity)");
+    }
+    return h;
+}
+
+inline std::size_t shm_capacity(ShmMode mode, std::size_t capacity) {
+    if (mode != ShmMode::Attach && capacity == 0) throw std::invalid_argument("shm ring capacity must be > 0 to create");
+    return capacity ? next_pow2(capacity) : 0;
+}
+
+} // namespace detail
+
+// -------- Single-producer / single-consumer --------
+// One producer process and one consumer process (or threads in them).
+// Payload slots are a dense T array; head/tail live in the header and
+// each side keeps a process-local cache of the other's index.
+template <class T, class Backoff = DefaultBackoff>
+class ShmRingSPSC {
+    static_assert(std::is_trivially_copyable_v<T>, "shared-memory rings need a trivially copyable T");
+    static_assert(alignof(T) <= 64, "slots start on a 64-byte boundary");
+    using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+public:
+    using backoff_type = Backoff;
+
+    // capacity (rounded up to a power of two) is required to create; when
+    // attaching, 0 accepts the region's capacity and anything else must match.
+    ShmRingSPSC(ShmMode mode, const std::string& name, std::size_t capacity = 0,
+                std::chrono::milliseconds timeout = std::chrono::seconds(1))
+        : region_(mode, name, detail::shm_slots_offset() + detail::shm_capacity(mode, capacity) * sizeof(Storage), timeout),
+          hdr_(detail::shm_open_ring<Storage>(region_, detail::ShmKind::Spsc, detail::shm_capacity(mode, capacity),
+                                              timeout, [](std::byte*, std::size_t) {})),
+          capacity_(static_cast<std::size_t>(hdr_.capacity)),
+          mask_(capacity_ - 1),
+          slots_(reinterpret_cast<Storage*>(static_cast<std::byte*>(region_.base()) + hdr_.slots_offset)),
+          head_cache_(hdr_.head.load(ACQUIRE)),
+          tail_cache_(hdr_.tail.load(ACQUIRE))
+    {}
+
+    ShmRingSPSC(const ShmRingSPSC&) = delete;
+    ShmRingSPSC& operator=(const ShmRingSPSC&) = delete;
+
+    static bool unlink(const std::string& name) noexcept { return detail::ShmRegion::unlink(name); }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+    bool        created()  const noexcept { return region_.created(); }
+
+    bool try_enqueue(const T& v) noexcept { return try_enqueue_many(&v, 1) == 1; }
+    bool try_dequeue(T& out) noexcept { return dequeue_many(&out, 1) == 1; }
+
+    // Producer side.
+    std::size_t try_enqueue_many(const T* data, std::size_t n) noexcept {
+        const std::uint64_t t = hdr_.tail.load(RELAXED);
+        if (head_cache_ + capacity_ - t < n) head_cache_ = hdr_.head.load(ACQUIRE);
+        n = std::min<std::size_t>(n, static_cast<std::size_t>(head_cache_ + capacity_ - t));
+        for (std::size_t i = 0; i < n; ++i) {
+            std::memcpy(&slots_[static_cast<std::size_t>(t + i) & mask_], &data[i], sizeof(T));
+        }
+        if (n) hdr_.tail.store(t + n, RELEASE);
+        return n;
+    }
+
+    // Consumer side.
+    std::size_t dequeue_many(T* out, std::size_t n) noexcept {
+        const std::uint64_t h = hdr_.head.load(RELAXED);
+        if (tail_cache_ - h < n) tail_cache_ = hdr_.tail.load(ACQUIRE);
+        n = std::min<std::size_t>(n, static_cast<std::size_t>(tail_cache_ - h));
+        for (std::size_t i = 0; i < n; ++i) {
+            std::memcpy(&out[i], &slots_[static_cast<std::size_t>(h + i) & mask_], sizeof(T));
+        }
+        if (n) hdr_.head.store(h + n, RELEASE);
+        return n;
+    }
+
+    template <class Clock, class Dur>
+    bool enqueue_until(const T& v, const std::chrono::time_point<Clock, Dur>& deadline) noexcept {
+        Backoff backoff;
+        do {
+            if (try_enqueue(v)) return true;
+            backoff.wait(hdr_.head, head_cache_);
+        } while (Clock::now() < deadline);
+        return false;
+    }
+
+    template <class Clock, class Dur>
+    bool dequeue_until(T& out, const std::chrono::time_point<Clock, Dur>& deadline) noexcept {
+        Backoff backoff;
+        do {
+            if (try_dequeue(out)) return true;
+            backoff.wait(hdr_.tail, tail_cache_);
+        } while (Clock::now() < deadline);
+        return false;
+    }
+
+    void enqueue(const T& v) noexcept {
+        Backoff backoff;
+        while (!try_enqueue(v)) backoff.wait(hdr_.head, head_cache_);
+    }
+
+    void dequeue(T& out) noexcept {
+        Backoff backoff;
+        while (!try_dequeue(out)) backoff.wait(hdr_.tail, tail_cache_);
+    }
+
+    std::size_t size() const noexcept {
+        const std::uint64_t h = hdr_.head.load(ACQUIRE);
+        const std::uint64_t t = hdr_.tail.load(ACQUIRE);
+        return static_cast<std::size_t>(t - h);
+    }
+
+private:
+    detail::ShmRegion region_;
+    detail::ShmHeader& hdr_;
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    Storage* const slots_;
+    std::uint64_t head_cache_; // producer-owned
+    std::uint64_t tail_cache_; // consumer-owned
+};
+
+// -------- Multi-producer / multi-consumer --------
+// Same ticketed-slot protocol as RingMPMC over padded slots, any number of
+// producer and consumer processes.
+template <class T, class Backoff = DefaultBackoff>
+class ShmRingMPMC {
+    static_assert(std::is_trivially_copyable_v<T>, "shared-memory rings need a trivially copyable T");
+    using SlotT = Slot<T>;
+
+public:
+    using backoff_type = Backoff;
+
+    ShmRingMPMC(ShmMode mode, const std::string& name, std::size_t capacity = 0,
+                std::chrono::milliseconds timeout = std::chrono::seconds(1))
+        : region_(mode, name, detail::shm_slots_offset() + detail::shm_capacity(mode, capacity) * sizeof(SlotT), timeout),
+          hdr_(detail::shm_open_ring<SlotT>(region_, detail::ShmKind::Mpmc, detail::shm_capacity(mode, capacity),
+                                            timeout, [](std::byte* p, std::size_t n) {
+                                                SlotT* s = reinterpret_cast<SlotT*>(p);
+                                                for (std::size_t i = 0; i < n; ++i) {
+                                                    new (&s[i]) SlotT();
+                                                    s[i].seq.store(static_cast<std::uint64_t>(i), RELAXED);
+                                                }
+                                            })),
+          capacity_(static_cast<std::size_t>(hdr_.capacity)),
+          mask_(capacity_ - 1),
+          slots_(std::launder(reinterpret_cast<SlotT*>(static_cast<std::byte*>(region_.base()) + hdr_.slots_offset)))
+    {}
+
+    ShmRingMPMC(const ShmRingMPMC&) = delete;
+    ShmRingMPMC& operator=(const ShmRingMPMC&) = delete;
+
+    static bool unlink(const std::string& name) noexcept { return detail::ShmRegion::unlink(name); }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+    bool        created()  const noexcept { return region_.created(); }
+
+    bool try_enqueue(const T& v) noexcept {
+        std::uint64_t pos = hdr_.tail.load(RELAXED);
+        for (;;) {
+            SlotT& s = slots_[static_cast<std::size_t>(pos) & mask_];
+            std::uint64_t seq = s.seq.load(ACQUIRE);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (hdr_.tail.compare_exchange_weak(pos, pos + 1, ACQ_REL, RELAXED)) {
+                    std::memcpy(&s.storage, &v, sizeof(T));
+                    s.seq.store(pos + 1, RELEASE);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = hdr_.tail.load(RELAXED);
+            }
+        }
+    }
+
+    bool try_dequeue(T& out) noexcept {
+        std::uint64_t pos = hdr_.head.load(RELAXED);
+        for (;;) {
+            SlotT& s = slots_[static_cast<std::size_t>(pos) & mask_];
+            std::uint64_t seq = s.seq.load(ACQUIRE);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (hdr_.head.compare_exchange_weak(pos, pos + 1, ACQ_REL, RELAXED)) {
+                    std::memcpy(&out, &s.storage, sizeof(T));
+                    s.seq.store(pos + capacity_, RELEASE);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // empty
+            } else {
+                pos = hdr_.head.load(RELAXED);
+            }
+        }
+    }
+
+    template <class Clock, class Dur>
+    bool enqueue_until(const T& v, const std::chrono::time_point<Clock, Dur>& deadline) noexcept {
+        Backoff backoff;
+        do {
+            if (try_enqueue(v)) return true;
+            backoff.wait(hdr_.head, hdr_.head.load(RELAXED));
+        } while (Clock::now() < deadline);
+        return false;
+    }
+
+    template <class Clock, class Dur>
+    bool dequeue_until(T& out, const std::chrono::time_point<Clock, Dur>& deadline) noexcept {
+        Backoff backoff;
+        do {
+            if (try_dequeue(out)) return true;
+            backoff.wait(hdr_.tail, hdr_.tail.load(RELAXED));
+        } while (Clock::now() < deadline);
+        return false;
+    }
+
+    void enqueue(const T& v) noexcept {
+        Backoff backoff;
+        while (!try_enqueue(v)) backoff.wait(hdr_.head, hdr_.head.load(RELAXED));
+    }
+
+    void dequeue(T& out) noexcept {
+        Backoff backoff;
+        while (!try_dequeue(out)) backoff.wait(hdr_.tail, hdr_.tail.load(RELAXED));
+    }
+
+    std::size_t size() const noexcept {
+        const std::uint64_t h = hdr_.head.load(ACQUIRE);
+        const std::uint64_t t = hdr_.tail.load(ACQUIRE);
+        return (t > h) ? static_cast<std::size_t>(t - h) : 0;
+    }
+
+private:
+    detail::ShmRegion region_;
+    detail::ShmHeader& hdr_;
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    SlotT* const slots_;
+};
+
+} // namespace ring
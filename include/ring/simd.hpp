@@ -0,0 +1,170 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #include <immintrin.h>
+  #define RING_SIMD_X86 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+  #include <arm_neon.h>
+  #define RING_SIMD_NEON 1
+#endif
+
+// Runtime dispatch needs per-function target attributes (GCC / Clang);
+// MSVC only gets what /arch enables at compile time.
+#if defined(RING_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+  #define RING_SIMD_DISPATCH 1
+  #define RING_TARGET(isa) __attribute__((target(isa)))
+#else
+  #define RING_TARGET(isa)
+#endif
+
+// Copies of at least this many bytes into / out of a ring use
+// non-temporal stores (x86 with AVX2), keeping batches that will not be
+// re-read soon out of the copying core's cache. 0 disables them.
+#ifndef RING_STREAM_COPY_BYTES
+#define RING_STREAM_COPY_BYTES (1u << 20)
+#endif
+
+namespace ring::simd {
+
+// Kernels for the split layout (ring.hpp), whose tickets and payloads are
+// dense arrays:
+//   ticket_run(seqs, first, n): length of the prefix of seqs[0..n) equal to
+//     first, first + 1, ... (the ready / free run a batch claim scans for).
+//     Vector loads stand in for relaxed loads of the atomic tickets (each
+//     aligned 8-byte lane is read whole); callers fence after a run.
+//   copy(dst, src, bytes): memcpy, or aligned streaming stores plus sfence
+//     for copies of RING_STREAM_COPY_BYTES and up.
+// The widest ISA the build or (GCC / Clang on x86-64) the CPU supports is
+// picked once: avx512 > avx2 > neon > scalar.
+
+namespace detail {
+
+using TicketRunFn = std::size_t (*)(const std::atomic<std::uint64_t>*, std::uint64_t, std::size_t) noexcept;
+using CopyFn      = void (*)(void*, const void*, std::size_t) noexcept;
+
+inline std::size_t ticket_tail(const std::atomic<std::uint64_t>* s, std::uint64_t first, std::size_t i, std::size_t n) noexcept {
+    while (i < n && s[i].load(std::memory_order_relaxed) == first + i) ++i;
+    return i;
+}
+
+inline std::size_t ticket_run_scalar(const std::atomic<std::uint64_t>* s, std::uint64_t first, std::size_t n) noexcept {
+    return ticket_tail(s, first, 0, n);
+}
+
+inline void copy_scalar(void* dst, const void* src, std::size_t bytes) noexcept { std::memcpy(dst, src, bytes); }
+
+#if defined(RING_SIMD_X86)
+RING_TARGET("avx2")
+inline std::size_t ticket_run_avx2(const std::atomic<std::uint64_t>* s, std::uint64_t first, std::size_t n) noexcept {
+    const auto* p = reinterpret_cast<const std::uint64_t*>(s);
+    __m256i ramp = _mm256_add_epi64(_mm256_set1_epi64x(static_cast<long long>(first)), _mm256_setr_epi64x(0, 1, 2, 3));
+    const __m256i step = _mm256_set1_epi64x(4);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const unsigned m = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, ramp))));
+        if (m != 0xFu) return i + static_cast<std::size_t>(std::countr_one(m));
+        ramp = _mm256_add_epi64(ramp, step);
+    }
+    return ticket_tail(s, first, i, n);
+}
+
+RING_TARGET("avx512f")
+inline std::size_t ticket_run_avx512(const std::atomic<std::uint64_t>* s, std::uint64_t first, std::size_t n) noexcept {
+    const auto* p = reinterpret_cast<const std::uint64_t*>(s);
+    __m512i ramp = _mm512_add_epi64(_mm512_set1_epi64(static_cast<long long>(first)), _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7));
+    const __m512i step = _mm512_set1_epi64(8);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m512i v = _mm512_loadu_si512(p + i);
+        const unsigned m = static_cast<unsigned>(_mm512_cmpeq_epu64_mask(v, ramp));
+        if (m != 0xFFu) return i + static_cast<std::size_t>(std::countr_one(m));
+        ramp = _mm512_add_epi64(ramp, step);
+    }
+    return ticket_tail(s, first, i, n);
+}
+
+// Head up to 32-byte alignment of dst by memcpy, streaming body, memcpy
+// tail; the sfence orders the streamed bytes before later (release) ticket
+// stores.
+RING_TARGET("avx2")
+inline void copy_stream_avx2(void* dst, const void* src, std::size_t bytes) noexcept {
+    auto* d = static_cast<unsigned char*>(dst);
+    const auto* s = static_cast<const unsigned char*>(src);
+    if (bytes < RING_STREAM_COPY_BYTES || RING_STREAM_COPY_BYTES == 0) { std::memcpy(d, s, bytes); return; }
+    const std::size_t head = (32 - (reinterpret_cast<std::uintptr_t>(d) & 31)) & 31;
+    std::memcpy(d, s, head);
+    d += head; s += head; bytes -= head;
+    for (; bytes >= 32; bytes -= 32, d += 32, s += 32) {
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s)));
+    }
+    std::memcpy(d, s, bytes);
+    _mm_sfence();
+}
+#endif
+
+#if defined(RING_SIMD_NEON)
+inline std::size_t ticket_run_neon(const std::atomic<std::uint64_t>* s, std::uint64_t first, std::size_t n) noexcept {
+    const auto* p = reinterpret_cast<const std::uint64_t*>(s);
+    const std::uint64_t init[2] = { first, first + 1 };
+    uint64x2_t ramp = vld1q_u64(init);
+    const uint64x2_t step = vdupq_n_u64(2);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const uint64x2_t eq = vceqq_u64(vld1q_u64(p + i), ramp);
+        if (!vgetq_lane_u64(eq, 0)) return i;
+        if (!vgetq_lane_u64(eq, 1)) return i + 1;
+        ramp = vaddq_u64(ramp, step);
+    }
+    return ticket_tail(s, first, i, n);
+}
+#endif
+
+struct Kernels {
+    TicketRunFn ticket_run;
+    CopyFn      copy;
+    const char* isa;
+};
+
+inline Kernels pick_kernels() noexcept {
+#if defined(RING_SIMD_X86)
+  #if defined(__AVX512F__)
+    return { &ticket_run_avx512, &copy_stream_avx2, "avx512" };
+  #elif defined(__AVX2__)
+    #if defined(RING_SIMD_DISPATCH)
+    if (__builtin_cpu_supports("avx512f")) return { &ticket_run_avx512, &copy_stream_avx2, "avx512" };
+    #endif
+    return { &ticket_run_avx2, &copy_stream_avx2, "avx2" };
+  #elif defined(RING_SIMD_DISPATCH)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return { &ticket_run_avx512, &copy_stream_avx2, "avx512" };
+    if (__builtin_cpu_supports("avx2"))    return { &ticket_run_avx2, &copy_stream_avx2, "avx2" };
+  #endif
+#elif defined(RING_SIMD_NEON)
+    return { &ticket_run_neon, &copy_scalar, "neon" };
+#endif
+    return { &ticket_run_scalar, &copy_scalar, "scalar" };
+}
+
+inline const Kernels& kernels() noexcept {
+    static const Kernels k = pick_kernels();
+    return k;
+}
+
+} // namespace detail
+
+inline std::size_t ticket_run(const std::atomic<std::uint64_t>* seqs, std::uint64_t first, std::size_t n) noexcept {
+    return detail::kernels().ticket_run(seqs, first, n);
+}
+
+inline void copy(void* dst, const void* src, std::size_t bytes) noexcept { detail::kernels().copy(dst, src, bytes); }
+
+// Name of the selected kernel set, for benchmark / log output.
+inline const char* isa() noexcept { return detail::kernels().isa; }
+
+} // namespace ring::simd
@@ -0,0 +1,197 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "backoff.hpp"
+#include "utils.hpp"
+
+namespace ring {
+
+// -------- Stats policies --------
+// Last template parameter of RingMPMC. The ring reports events through
+//   cas_retry()         a head_/tail_ claim lost a race and was retried
+//   backoff(action)     one Backoff::wait step (spin, yield or park)
+//   full() / empty()    a try_/claim op returned nothing
+//   enqueued(n) / dequeued(n)   a successful op moved n items
+//   occupancy(n)        n items were in the ring after an enqueue / in size()
+//   dropped(n)          n items were discarded by an Overflow policy (overflow.hpp)
+//   scanned(p, n)       a dequeue claim that got items took p scan passes
+//                       and n ticket loads (more than one pass = lost CAS)
+// and exports them with snapshot(). Hooks are only called behind
+// `if constexpr (Stats::enabled)` where they would cost a load, so
+// NoStats compiles away entirely.
+
+// log2 buckets: [0] = 1, [1] = 2..3, [2] = 4..7, ... [kBatchBuckets-1] = 2^16 and up.
+constexpr std::size_t kBatchBuckets = 17;
+
+struct RingStatsSnapshot {
+    std::uint64_t cas_retries = 0;
+    std::uint64_t spins       = 0;
+    std::uint64_t yields      = 0;
+    std::uint64_t parks       = 0;
+    std::uint64_t full        = 0;
+    std::uint64_t empty       = 0;
+    std::uint64_t enqueued    = 0;
+    std::uint64_t dequeued    = 0;
+    std::uint64_t high_water  = 0; // max occupancy seen
+    std::uint64_t dropped     = 0; // lost to DropNewest / OverwriteOldest
+    std::uint64_t scans       = 0; // scan passes of successful dequeue claims
+    std::uint64_t scanned     = 0; // tickets loaded by those passes
+    std::uint64_t enqueue_batches[kBatchBuckets] = {};
+    std::uint64_t dequeue_batches[kBatchBuckets] = {};
+
+    // Calls fn(name, value) per counter, e.g. to feed a metrics exporter.
+    // Batch buckets are named "<side>_batch_le_<upper bound>" (last: "_le_inf").
+    template <class Fn>
+    void for_each(Fn&& fn) const {
+        fn(std::string("cas_retries"), cas_retries);
+        fn(std::string("spins"), spins);
+        fn(std::string("yields"), yields);
+        fn(std::string("parks"), parks);
+        fn(std::string("full"), full);
+        fn(std::string("empty"), empty);
+        fn(std::string("enqueued"), enqueued);
+        fn(std::string("dequeued"), dequeued);
+        fn(std::string("high_water"), high_water);
+        fn(std::string("dropped"), dropped);
+        fn(std::string("scans"), scans);
+        fn(std::string("scanned"), scanned);
+        for (std::size_t k = 0; k < kBatchBuckets; ++k) {
+            const std::string le = (k + 1 == kBatchBuckets) ? "inf" : std::to_string((2ull << k) - 1);
+            fn("enqueue_batch_le_" + le, enqueue_batches[k]);
+            fn("dequeue_batch_le_" + le, dequeue_batches[k]);
+        }
+    }
+};
+
+// Default: no counters, no code.
+struct NoStats {
+    static constexpr bool enabled = false;
+
+    void cas_retry() const noexcept {}
+    void backoff(BackoffAction) const noexcept {}
+    void full() const noexcept {}
+    void empty() const noexcept {}
+    void enqueued(std::size_t) const noexcept {}
+    void dequeued(std::size_t) const noexcept {}
+    void occupancy(std::size_t) const noexcept {}
+    void dropped(std::size_t) const noexcept {}
+    void scanned(std::size_t, std::size_t) const noexcept {}
+    RingStatsSnapshot snapshot() const noexcept { return {}; }
+    void reset() const noexcept {}
+};
+
+// Counters sharded per thread: each thread picks one of Shards cache-line
+// aligned blocks on first use (round robin), so threads only share a block
+// once there are more than Shards of them. Increments are relaxed; a
+// snapshot taken under load is a consistent-enough sum, not a cut.
+template <std::size_t Shards = 64>
+class RingStats {
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> cas_retries{0}, spins{0}, yields{0}, parks{0};
+        std::atomic<std::uint64_t> full{0}, empty{0}, enqueued{0}, dequeued{0}, high_water{0}, dropped{0};
+        std::atomic<std::uint64_t> scans{0}, scanned{0};
+        std::atomic<std::uint64_t> enqueue_batches[kBatchBuckets] = {};
+        std::atomic<std::uint64_t> dequeue_batches[kBatchBuckets] = {};
+    };
+
+public:
+    static constexpr bool enabled = true;
+
+    RingStats() : shards_(new Shard[Shards]) {}
+
+    void cas_retry() const noexcept { bump(mine().cas_retries); }
+
+    void backoff(BackoffAction a) const noexcept {
+        Shard& s = mine();
+        bump(a == BackoffAction::Spin ? s.spins : a == BackoffAction::Yield ? s.yields : s.parks);
+    }
+
+    void full()  const noexcept { bump(mine().full); }
+    void empty() const noexcept { bump(mine().empty); }
+
+    void enqueued(std::size_t n) const noexcept {
+        Shard& s = mine();
+        bump(s.enqueued, n);
+        bump(s.enqueue_batches[bucket(n)]);
+    }
+
+    void dequeued(std::size_t n) const noexcept {
+        Shard& s = mine();
+        bump(s.dequeued, n);
+        bump(s.dequeue_batches[bucket(n)]);
+    }
+
+    void occupancy(std::size_t n) const noexcept {
+        std::atomic<std::uint64_t>& hw = mine().high_water;
+        if (n > hw.load(RELAXED)) hw.store(n, RELAXED); // shard is (mostly) thread-owned
+    }
+
+    void dropped(std::size_t n) const noexcept { bump(mine().dropped, n); }
+
+    void scanned(std::size_t passes, std::size_t n) const noexcept {
+        Shard& s = mine();
+        bump(s.scans, passes);
+        bump(s.scanned, n);
+    }
+
+    RingStatsSnapshot snapshot() const noexcept {
+        RingStatsSnapshot r;
+        for (std::size_t i = 0; i < Shards; ++i) {
+            const Shard& s = shards_[i];
+            r.cas_retries += s.cas_retries.load(RELAXED);
+            r.spins       += s.spins.load(RELAXED);
+            r.yields      += s.yields.load(RELAXED);
+            r.parks       += s.parks.load(RELAXED);
+            r.full        += s.full.load(RELAXED);
+            r.empty       += s.empty.load(RELAXED);
+            r.enqueued    += s.enqueued.load(RELAXED);
+            r.dequeued    += s.dequeued.load(RELAXED);
+            r.dropped     += s.dropped.load(RELAXED);
+            r.scans       += s.scans.load(RELAXED);
+            r.scanned     += s.scanned.load(RELAXED);
+            const std::uint64_t hw = s.high_water.load(RELAXED);
+            if (hw > r.high_water) r.high_water = hw;
+            for (std::size_t k = 0; k < kBatchBuckets; ++k) {
+                r.enqueue_batches[k] += s.enqueue_batches[k].load(RELAXED);
+                r.dequeue_batches[k] += s.dequeue_batches[k].load(RELAXED);
+            }
+        }
+        return r;
+    }
+
+    void reset() const noexcept {
+        for (std::size_t i = 0; i < Shards; ++i) {
+            Shard& s = shards_[i];
+            for (auto* c : { &s.cas_retries, &s.spins, &s.yields, &s.parks, &s.full, &s.empty,
+                             &s.enqueued, &s.dequeued, &s.high_water, &s.dropped, &s.scans, &s.scanned }) c->store(0, RELAXED);
+            for (std::size_t k = 0; k < kBatchBuckets; ++k) {
+                s.enqueue_batches[k].store(0, RELAXED);
+                s.dequeue_batches[k].store(0, RELAXED);
+            }
+        }
+    }
+
+private:
+    static void bump(std::atomic<std::uint64_t>& c, std::uint64_t n = 1) noexcept { c.fetch_add(n, RELAXED); }
+
+    static std::size_t bucket(std::size_t n) noexcept {
+        std::size_t k = 0;
+        while (n > 1 && k + 1 < kBatchBuckets) { n >>= 1; ++k; }
+        return k;
+    }
+
+    static std::size_t thread_shard() noexcept {
+        static std::atomic<std::size_t> next{0};
+        thread_local const std::size_t idx = next.fetch_add(1, RELAXED) % Shards;
+        return idx;
+    }
+
+    Shard& mine() const noexcept { return shards_[thread_shard()]; }
+
+    std::unique_ptr<Shard[]> shards_;
+};
+
+} // namespace ring
@@ -0,0 +1,121 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+#include "utils.hpp"
+
+namespace ring {
+
+// Chase-Lev work-stealing deque (Chase & Lev 2005, with the C11 memory
+// orders of Le, Pop, Cohen & Zappa Nardelli 2013).
+//
+// One owner thread push()es and take()s at the bottom (LIFO, no CAS except
+// when racing a thief for the last item); any thread may steal() from the
+// top (FIFO, one CAS). The buffer doubles when full; retired buffers are
+// kept until the deque is destroyed because a thief may still be reading
+// one. T must be trivially copyable and lock-free as std::atomic<T>
+// (pointers, small integers): slots are atomics so racing reads are defined.
+template <class T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque<T>: T must be trivially copyable");
+    static_assert(std::atomic<T>::is_always_lock_free, "WorkStealingDeque<T>: std::atomic<T> must be lock-free");
+
+    struct Buffer {
+        explicit Buffer(std::size_t cap) : mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+        std::size_t capacity() const noexcept { return mask + 1; }
+        void put(std::int64_t i, T v) noexcept { slots[static_cast<std::size_t>(i) & mask].store(v, RELAXED); }
+        T    get(std::int64_t i) const noexcept { return slots[static_cast<std::size_t>(i) & mask].load(RELAXED); }
+
+        const std::size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+public:
+    explicit WorkStealingDeque(std::size_t capacity = 1024) {
+        auto b = std::make_unique<Buffer>(next_pow2(capacity < 2 ? 2 : capacity));
+        buffer_.store(b.get(), RELAXED);
+        buffers_.push_back(std::move(b));
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only.
+    void push(T v) {
+        const std::int64_t b = bottom_.load(RELAXED);
+        const std::int64_t t = top_.load(ACQUIRE);
+        Buffer* a = buffer_.load(RELAXED);
+        if (b - t > static_cast<std::int64_t>(a->capacity()) - 1) a = grow(a, t, b);
+        a->put(b, v);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, RELAXED);
+    }
+
+    // Owner only: most recently pushed item.
+    std::optional<T> take() noexcept {
+        const std::int64_t b = bottom_.load(RELAXED) - 1;
+        Buffer* a = buffer_.load(RELAXED);
+        bottom_.store(b, RELAXED);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(RELAXED);
+
+        if (t > b) { // empty
+            bottom_.store(b + 1, RELAXED);
+            return std::nullopt;
+        }
+        T v = a->get(b);
+        if (t == b) { // last item: race thieves for it
+            const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, RELAXED);
+            bottom_.store(b + 1, RELAXED);
+            if (!won) return std::nullopt;
+        }
+        return v;
+    }
+
+    // Any thread: oldest item, or nullopt when empty or when another thief
+    // won the race (callers simply try elsewhere).
+    std::optional<T> steal() noexcept {
+        std::int64_t t = top_.load(ACQUIRE);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom_.load(ACQUIRE);
+        if (t >= b) return std::nullopt;
+
+        Buffer* a = buffer_.load(ACQUIRE);
+        T v = a->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, RELAXED)) return std::nullopt;
+        return v;
+    }
+
+    // Approximate when other threads are active.
+    std::size_t size() const noexcept {
+        const std::int64_t b = bottom_.load(RELAXED);
+        const std::int64_t t = top_.load(RELAXED);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    std::size_t capacity() const noexcept { return buffer_.load(RELAXED)->capacity(); }
+
+private:
+    Buffer* grow(Buffer* old, std::int64_t t, std::int64_t b) {
+        auto bigger = std::make_unique<Buffer>(old->capacity() * 2);
+        for (std::int64_t i = t; i < b; ++i) bigger->put(i, old->get(i));
+        Buffer* raw = bigger.get();
+        buffers_.push_back(std::move(bigger)); // old stays alive for in-flight thieves
+        buffer_.store(raw, RELEASE);
+        return raw;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top_{0};    // thieves
+    CachePad _pad1_;
+    alignas(64) std::atomic<std::int64_t> bottom_{0}; // owner
+    std::atomic<Buffer*> buffer_{nullptr};
+    std::vector<std::unique_ptr<Buffer>> buffers_;    // owner only
+};
+
+} // namespace ring
@@ -1,13 +1,36 @@
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <thread>
 #include <vector>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <ctime>
+#include <cstdlib>
 
+#include "../include/ring/affinity.hpp"
 #include "../include/ring/ring_spsc.hpp"
 #include "../include/ring/ring_mpmc.hpp"
+#include "../include/ring/sharded_ring.hpp"
+#include "../include/ring/broadcast_ring.hpp"
+#include "../include/ring/byte_ring.hpp"
+#include "../include/ring/fan_in.hpp"
+#include "../include/ring/linked_ring.hpp"
+#include "../include/ring/pool.hpp"
+#include "../include/ring/priority_ring.hpp"
+#include "../include/ring/scheduler.hpp"
+#include "../include/ring/shm_ring.hpp"
+#include "../include/ring/work_stealing.hpp"
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 using namespace std::chrono_literals;
 
@@ -58,9 +81,1228 @@ void mpmc_smoke() {
               << ", consumed=" << consumed.load() << ")\n";
 }
 
+static void check(bool ok, const char* what) {
+    if (!ok) { std::cerr << "ERROR: " << what << "\n"; std::abort(); }
+}
+
+template <class Q>
+void try_enqueue_many_smoke() {
+    Q q(8);
+    int in[16];
+    for (int i = 0; i < 16; ++i) in[i] = i;
+    int out[16] = {};
+
+    check(q.try_enqueue_many(in, 10) == 8, "try_enqueue_many should claim only free slots");
+    check(q.try_enqueue_many(in + 8, 4) == 0, "try_enqueue_many should return 0 when full");
+    check(q.dequeue_many(out, 3) == 3, "dequeue_many count");
+    check(q.try_enqueue_many(in + 8, 8) == 3, "try_enqueue_many partial run after drain");
+    check(q.dequeue_many(out + 3, 16) == 8, "dequeue_many drain");
+    for (int i = 0; i < 11; ++i) check(out[i] == i, "try_enqueue_many FIFO order");
+    std::cout << "try_enqueue_many smoke ran\n";
+}
+
+// Producer mixes batch and single enqueues, consumer mixes batch and single
+// dequeues; every value must arrive once and in order.
+template <class Q>
+void spsc_batch_order() {
+    Q q(64);
+    constexpr std::uint64_t N = 200000;
+
+    std::thread prod([&]{
+        std::uint64_t buf[37];
+        std::uint64_t next = 0;
+        while (next < N) {
+            if (next % 5 == 0) {
+                while (!q.try_enqueue(next)) std::this_thread::yield();
+                ++next;
+                continue;
+            }
+            std::size_t n = 0;
+            while (n < 37 && next + n < N) { buf[n] = next + n; ++n; }
+            next += q.enqueue_many(buf, n);
+        }
+    });
+
+    std::uint64_t expect = 0;
+    std::uint64_t out[29];
+    while (expect < N) {
+        std::size_t got = 0;
+        if (expect % 3 == 0) {
+            got = q.try_dequeue(out[0]) ? 1 : 0;
+        } else {
+            got = q.dequeue_many(out, 29);
+        }
+        if (got == 0) { std::this_thread::yield(); continue; }
+        for (std::size_t i = 0; i < got; ++i) check(out[i] == expect++, "SPSC batch order");
+    }
+    prod.join();
+    check(q.size() == 0, "SPSC ring drained");
+    std::cout << "SPSC batch order ran\n";
+}
+
+// reserve/commit and peek/release: build and read items in place.
+template <class Q>
+void zero_copy_smoke() {
+    Q q(8);
+    auto w = q.reserve(5);
+    check(w.size() == 5, "reserve count");
+    for (std::size_t i = 0; i < w.size(); ++i) new (w[i]) std::string(40, static_cast<char>('a' + i));
+    check(q.peek(8).empty(), "peek before commit must see nothing");
+    q.commit(w);
+
+    auto w2 = q.reserve(8);
+    check(w2.size() == 3, "reserve limited by free slots");
+    for (std::size_t i = 0; i < w2.size(); ++i) new (w2[i]) std::string(1, 'z');
+    q.commit(w2);
+    check(q.reserve(1).empty(), "reserve on full ring");
+
+    auto r = q.peek(6);
+    check(r.size() == 6, "peek count");
+    for (std::size_t i = 0; i < 5; ++i) check(*r[i] == std::string(40, static_cast<char>('a' + i)), "peek value");
+    q.release(r);
+
+    std::string out;
+    check(q.try_dequeue(out) && out == "z", "single dequeue after release");
+    check(q.try_dequeue(out) && out == "z", "single dequeue after release");
+    check(!q.try_dequeue(out), "ring empty");
+    std::cout << "zero-copy smoke ran\n";
+}
+
+// Deadline wrappers and blocking enqueue_many under each Backoff policy.
+template <class Q>
+void backoff_smoke() {
+    Q q(256);
+    int v = 0;
+    check(!q.dequeue_until(v, std::chrono::steady_clock::now() + 2ms), "dequeue_until must time out when empty");
+    for (int i = 0; i < 256; ++i) check(q.try_enqueue(i), "fill");
+    check(!q.enqueue_until(9, std::chrono::steady_clock::now() + 2ms), "enqueue_until must time out when full");
+    for (int i = 0; i < 256; ++i) check(q.try_dequeue(v) && v == i, "drain");
+
+    constexpr int N = 3000;
+    std::thread prod([&]{
+        int buf[3];
+        for (int i = 0; i < N; i += 3) {
+            for (int k = 0; k < 3; ++k) buf[k] = i + k;
+            q.enqueue_many(buf, 3);
+        }
+    });
+    for (int i = 0; i < N; ++i) {
+        check(q.dequeue_until(v, std::chrono::steady_clock::now() + 5s) && v == i, "dequeue_until order");
+    }
+    prod.join();
+    std::cout << "backoff smoke ran (" << Q::backoff_type::name << ")\n";
+}
+
+// Blocking enqueue/dequeue park instead of spinning, and hand items over
+// across a ring much smaller than the traffic.
+template <class Q>
+void blocking_smoke(int producers, int consumers) {
+    Q q(8);
+    int v = 0;
+    const std::clock_t c0 = std::clock();
+    check(!q.dequeue_for(v, 200ms), "dequeue_for must time out when empty");
+    const double cpu_ms = 1000.0 * static_cast<double>(std::clock() - c0) / CLOCKS_PER_SEC;
+    check(cpu_ms < 100.0, "idle dequeue_for should park, not spin");
+
+    constexpr int PER = 20000;
+    std::atomic<long long> sum{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&] { for (int i = 1; i <= PER; ++i) q.enqueue(i); });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            const int n = PER * producers / consumers + (c == 0 ? PER * producers % consumers : 0);
+            int x = 0;
+            for (int i = 0; i < n; ++i) { q.dequeue(x); sum.fetch_add(x, std::memory_order_relaxed); }
+        });
+    }
+    for (auto& t : threads) t.join();
+    check(sum.load() == static_cast<long long>(producers) * PER * (PER + 1) / 2, "blocking handoff sum");
+    std::cout << "blocking smoke ran (idle cpu " << cpu_ms << " ms)\n";
+}
+
+void affinity_smoke() {
+    const ring::Topology t = ring::query_topology();
+    check(t.num_cpus() > 0, "topology has cpus");
+    check(t.num_cores() > 0 && t.num_cores() <= t.num_cpus(), "cores <= cpus");
+    for (ring::Placement p : { ring::Placement::Os, ring::Placement::Spread, ring::Placement::Compact }) {
+        check(t.order(p).size() == t.num_cpus(), "placement covers every cpu");
+    }
+    const unsigned first = t.cpus.front().cpu;
+    const std::vector<unsigned> sib = t.siblings_of(first);
+    check(!sib.empty() && std::find(sib.begin(), sib.end(), first) != sib.end(), "cpu is its own sibling");
+
+    std::thread pinned([&] {
+#if defined(__linux__) || defined(_WIN32)
+        check(ring::pin_current_thread(first), "pin_current_thread");
+#else
+        (void)ring::pin_current_thread(first);
+#endif
+    });
+    pinned.join();
+    std::cout << "affinity smoke ran (" << t.num_cpus() << " cpus, " << t.num_cores() << " cores, "
+              << t.num_l3_domains() << " L3)\n";
+}
+
+// Node-placed slot storage plus the home-first / steal-when-empty shards.
+void numa_smoke() {
+    const std::vector<int> nodes = ring::numa_nodes();
+    check(!nodes.empty(), "at least one NUMA node");
+    {
+        ring::RingMPMC<int> local(1024, ring::node_local_allocator(nodes.front()));
+        ring::RingMPMC<int, ring::SplitLayout> inter(1024, ring::interleaved_allocator());
+        for (int i = 0; i < 1024; ++i) check(local.try_enqueue(i) && inter.try_enqueue(i), "numa ring enqueue");
+        int v = 0;
+        for (int i = 0; i < 1024; ++i) check(local.try_dequeue(v) && v == i && inter.try_dequeue(v) && v == i, "numa ring dequeue");
+    }
+
+    ring::ShardedRing<int> q(4, { nodes.front(), nodes.front() });
+    check(q.shard_count() == 2, "shard count");
+    for (int i = 0; i < 4; ++i) check(q.try_enqueue(1, 100 + i), "enqueue to shard 1");
+    check(q.try_enqueue(1, 104), "spill to shard 0 when home is full");
+    check(q.shard(0).size() == 1 && q.shard(1).size() == 4, "spill placement");
+
+    int out[8];
+    check(q.dequeue_many(0, out, 8) == 1 && out[0] == 104, "home shard drained first");
+    check(q.dequeue_many(0, out, 8) == 4 && out[0] == 100 && out[3] == 103, "steal from remote when home is empty");
+    check(q.dequeue_many(0, out, 8) == 0 && q.size() == 0, "sharded ring empty");
+    std::cout << "numa smoke ran (" << nodes.size() << " nodes)\n";
+}
+
+void page_storage_smoke() {
+    // 1 MiB of padded slots: rounds up to one 2 MiB page, or 1 GiB if asked.
+    ring::RingMPMC<int> huge(16384, ring::page_allocator(ring::kHugePages | ring::kPrefault));
+    ring::RingSPSC<int, ring::SplitLayout> locked(16384, ring::page_allocator(ring::kLockPages));
+    ring::RingMPMC<int> numa(4096, ring::node_local_allocator(-1, ring::kHugePages | ring::kLockPages));
+    for (int i = 0; i < 16384; ++i) check(huge.try_enqueue(i) && locked.try_enqueue(i), "page ring enqueue");
+    for (int i = 0; i < 4096; ++i) check(numa.try_enqueue(i), "numa huge ring enqueue");
+    int v = 0;
+    for (int i = 0; i < 16384; ++i) check(huge.try_dequeue(v) && v == i && locked.try_dequeue(v) && v == i, "page ring dequeue");
+    for (int i = 0; i < 4096; ++i) check(numa.try_dequeue(v) && v == i, "numa huge ring dequeue");
+    check(ring::detail::page_round(1, ring::kHugePages) == (std::size_t(2) << 20), "2 MiB rounding");
+    std::cout << "page storage smoke ran\n";
+}
+
+void shm_smoke() {
+#if !defined(_WIN32)
+    const std::string name = "/ring_test_" + std::to_string(::getpid());
+    ring::ShmRingMPMC<int>::unlink(name);
+    {
+        // Two mappings of one region: what one enqueues the other dequeues.
+        ring::ShmRingMPMC<int> a(ring::ShmMode::Create, name, 100);
+        ring::ShmRingMPMC<int> b(ring::ShmMode::Attach, name);
+        check(a.created() && !b.created() && b.capacity() == 128, "shm attach sees creator's capacity");
+        for (int i = 0; i < 128; ++i) check(a.try_enqueue(i), "shm mpmc enqueue");
+        check(!a.try_enqueue(0) && b.size() == 128, "shm mpmc full");
+        int v = -1;
+        for (int i = 0; i < 128; ++i) check(b.try_dequeue(v) && v == i, "shm mpmc dequeue");
+
+        bool threw = false;
+        try { ring::ShmRingSPSC<int> wrong(ring::ShmMode::Attach, name); } catch (const std::runtime_error&) { threw = true; }
+        check(threw, "shm kind mismatch rejected");
+    }
+    ring::ShmRingMPMC<int>::unlink(name);
+
+    // A creator that died mid-init leaves its pid in the header; the next
+    // open_or_create takes over.
+    const pid_t dead = ::fork();
+    if (dead == 0) ::_exit(0);
+    ::waitpid(dead, nullptr, 0);
+    {
+        ring::detail::ShmRegion r(ring::ShmMode::Create, name, 4096, 10ms);
+        static_cast<ring::detail::ShmHeader*>(r.base())->state.store(
+            ring::detail::kShmInitTag | static_cast<std::uint64_t>(dead));
+    }
+    {
+        ring::ShmRingSPSC<std::uint64_t> q(ring::ShmMode::OpenOrCreate, name, 64);
+        check(q.capacity() == 64 && q.size() == 0, "shm stale init recovered");
+
+        // Producer in a child process, consumer here.
+        constexpr std::uint64_t N = 100000;
+        const pid_t child = ::fork();
+        if (child == 0) {
+            ring::ShmRingSPSC<std::uint64_t> p(ring::ShmMode::Attach, name);
+            for (std::uint64_t i = 0; i < N; ++i) p.enqueue(i);
+            ::_exit(0);
+        }
+        std::uint64_t v = 0;
+        for (std::uint64_t i = 0; i < N; ++i) {
+            q.dequeue(v);
+            check(v == i, "shm spsc cross-process order");
+        }
+        int status = 0;
+        ::waitpid(child, &status, 0);
+        check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "shm producer exited cleanly");
+    }
+    ring::ShmRingSPSC<std::uint64_t>::unlink(name);
+
+    // A creator that died between shm_open and ftruncate leaves a
+    // zero-length region; open_or_create sizes and initializes it.
+    {
+        const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        check(fd >= 0, "shm zero-length region created");
+        ::close(fd);
+        ring::ShmRingMPMC<int> q(ring::ShmMode::OpenOrCreate, name, 32, 100ms);
+        check(!q.created() && q.capacity() == 32 && q.try_enqueue(7), "shm zero-length region recovered");
+        int v = 0;
+        check(q.try_dequeue(v) && v == 7, "shm recovered region usable");
+    }
+    ring::ShmRingMPMC<int>::unlink(name);
+    std::cout << "shm smoke ran\n";
+#endif
+}
+
+void stats_smoke() {
+    using Q = ring::RingMPMC<int, ring::PaddedLayout, ring::DefaultBackoff, ring::RingStats<>>;
+    Q q(8);
+    for (int i = 0; i < 8; ++i) check(q.try_enqueue(i), "stats enqueue");
+    check(!q.try_enqueue(8), "stats full");
+    int out[8];
+    check(q.dequeue_many(out, 8) == 8 && !q.try_dequeue(out[0]), "stats drain");
+
+    ring::RingStatsSnapshot s = q.stats();
+    check(s.enqueued == 8 && s.dequeued == 8, "stats item counts");
+    check(s.full == 1 && s.empty == 1, "stats full/empty returns");
+    check(s.high_water == 8, "stats high water");
+    check(s.enqueue_batches[0] == 8 && s.dequeue_batches[3] == 1, "stats batch histograms");
+
+    std::size_t names = 0;
+    s.for_each([&](const std::string&, std::uint64_t) { ++names; });
+    check(names == 12 + 2 * ring::kBatchBuckets, "stats export covers every counter");
+
+    q.reset_stats();
+    check(q.stats().enqueued == 0, "stats reset");
+
+    // Under contention the per-thread shards still add up.
+    constexpr int P = 2, N = 20000;
+    std::atomic<int> got{0};
+    std::vector<std::thread> ts;
+    for (int p = 0; p < P; ++p) ts.emplace_back([&] { for (int i = 0; i < N; ++i) q.enqueue_until(i, std::chrono::steady_clock::now() + 10s); });
+    for (int c = 0; c < 2; ++c) ts.emplace_back([&] {
+        int buf[16];
+        while (got.load() < P * N) got.fetch_add(static_cast<int>(q.dequeue_many(buf, 16)));
+    });
+    for (auto& t : ts) t.join();
+    s = q.stats();
+    check(s.enqueued == P * N && s.dequeued == P * N, "stats totals under contention");
+    std::cout << "stats smoke ran (cas retries " << s.cas_retries << ", spins " << s.spins << ", yields " << s.yields
+              << ", high water " << s.high_water << ")\n";
+}
+
+// Fixed-capacity rings need no allocation, so one can live in static storage.
+static ring::FixedRingMPMC<int, 256> g_fixed_mpmc;
+
+template <class Q>
+void fixed_capacity_smoke(Q& q) {
+    static_assert(Q::fixed_capacity == 256, "fixed capacity is a compile-time constant");
+    check(q.capacity() == 256, "fixed capacity");
+    for (int round = 0; round < 3; ++round) { // wrap around a few times
+        for (int i = 0; i < 256; ++i) check(q.try_enqueue(i), "fixed enqueue");
+        check(!q.try_enqueue(-1), "fixed full");
+        int out[64];
+        for (int i = 0; i < 256; i += 64) {
+            check(q.dequeue_many(out, 64) == 64 && out[0] == i && out[63] == i + 63, "fixed dequeue_many");
+        }
+    }
+}
+
+void fixed_smoke() {
+    fixed_capacity_smoke(g_fixed_mpmc);
+    ring::FixedRingSPSC<int, 256, ring::PackedLayout> spsc;
+    fixed_capacity_smoke(spsc);
+    auto split = std::make_unique<ring::RingMPMC<int, ring::Fixed<256, ring::SplitLayout>>>();
+    fixed_capacity_smoke(*split);
+    static_assert(sizeof(ring::FixedRingMPMC<int, 256, ring::PackedLayout>) >= 256 * 16, "slots are inline");
+
+    // Stats and overflow policies pass through the alias.
+    ring::FixedRingMPMC<int, 4, ring::PaddedLayout, ring::DefaultBackoff, ring::RingStats<>, ring::OverwriteOldest> over;
+    for (int i = 0; i < 6; ++i) over.enqueue(i);
+    int v = -1;
+    check(over.stats().dropped == 2 && over.try_dequeue(v) && v == 2, "fixed ring with stats and overwrite");
+    std::cout << "fixed smoke ran\n";
+}
+
+void work_stealing_smoke() {
+    // Owner pushes (growing past the initial buffer) and takes LIFO while
+    // thieves steal FIFO; every item comes out exactly once.
+    constexpr int N = 100000;
+    ring::WorkStealingDeque<std::uintptr_t> dq(16);
+    std::vector<std::atomic<int>> seen(N + 1);
+    std::atomic<bool> done{false};
+    std::vector<std::thread> thieves;
+    for (int k = 0; k < 2; ++k) thieves.emplace_back([&] {
+        while (!done.load() || !dq.empty()) {
+            if (auto v = dq.steal()) seen[*v].fetch_add(1); else std::this_thread::yield();
+        }
+    });
+    for (int i = 1; i <= N; ++i) {
+        dq.push(static_cast<std::uintptr_t>(i));
+        if (i % 3 == 0) { if (auto v = dq.take()) seen[*v].fetch_add(1); }
+    }
+    while (auto v = dq.take()) seen[*v].fetch_add(1);
+    done.store(true);
+    for (auto& t : thieves) t.join();
+    for (int i = 1; i <= N; ++i) check(seen[i].load() == 1, "deque item taken exactly once");
+    check(dq.capacity() >= 16, "deque capacity");
+
+    // Scheduler: fork/join from inside tasks plus external submissions.
+    ring::Scheduler sched(3);
+    struct Fib {
+        static std::uint64_t run(ring::Scheduler& s, int n) {
+            if (n < 2) return static_cast<std::uint64_t>(n);
+            std::uint64_t a = 0;
+            ring::TaskGroup g;
+            s.spawn(g, [&] { a = run(s, n - 1); });
+            const std::uint64_t b = run(s, n - 2);
+            s.wait(g);
+            return a + b;
+        }
+    };
+    std::uint64_t f = 0;
+    ring::TaskGroup root;
+    sched.spawn(root, [&] { f = Fib::run(sched, 20); });
+    std::atomic<int> ext{0};
+    for (int i = 0; i < 10000; ++i) sched.spawn(root, [&] { ext.fetch_add(1); });
+    sched.wait(root);
+    check(f == 6765, "scheduler fib(20)");
+    check(ext.load() == 10000, "scheduler external submissions");
+    check(sched.current_worker() == -1, "main thread is not a worker");
+    std::cout << "work-stealing smoke ran\n";
+}
+
+void broadcast_smoke() {
+    // Non-trivial payloads: readers see every string, slots are destroyed on
+    // reuse and at ring destruction (ASan/LSan catch leaks here).
+    ring::BroadcastRing<std::string> b(4, 2);
+    check(b.capacity() == 4 && b.readers() == 2, "broadcast shape");
+    for (int i = 0; i < 4; ++i) check(b.try_publish(std::string(40, char('a' + i))), "broadcast publish");
+    check(!b.try_publish(std::string("x")), "broadcast gated by slowest reader");
+    std::string s;
+    check(b.try_read(0, s) && s == std::string(40, 'a'), "broadcast reader 0");
+    check(!b.try_publish(std::string("x")), "still gated by reader 1");
+    std::size_t n = b.poll(1, [](const std::string& v) { check(v.size() == 40, "broadcast in place"); }, 2);
+    check(n == 2 && b.backlog(1) == 2 && b.backlog(0) == 3, "broadcast backlog");
+    check(b.try_publish(std::string(40, 'e')), "broadcast slot freed");
+    bool threw = false;
+    try { ring::BroadcastRing<int> bad(8, 0); } catch (const std::invalid_argument&) { threw = true; }
+    check(threw, "broadcast needs a reader");
+    std::cout << "broadcast smoke ran\n";
+}
+
+void overflow_smoke() {
+    using Stats = ring::RingStats<>;
+    int out[8] = {};
+    {
+        ring::RingMPMC<int, ring::PaddedLayout, ring::DefaultBackoff, Stats, ring::FailOnFull> q(4);
+        const int in[6] = {0, 1, 2, 3, 4, 5};
+        check(q.enqueue_many(in, 6) == 4, "fail-fast places what fits");
+        check(!q.enqueue(9), "fail-fast enqueue returns at once");
+        check(q.stats().dropped == 0, "fail-fast drops nothing");
+    }
+    {
+        ring::RingMPMC<int, ring::PaddedLayout, ring::DefaultBackoff, Stats, ring::DropNewest> q(4);
+        const int in[6] = {0, 1, 2, 3, 4, 5};
+        check(q.enqueue_many(in, 6) == 4 && !q.enqueue(9), "drop-newest never waits");
+        check(q.stats().dropped == 3, "drop-newest counts dropped items");
+        check(q.dequeue_many(out, 8) == 4 && out[0] == 0 && out[3] == 3, "drop-newest keeps the oldest");
+    }
+    {
+        ring::RingMPMC<std::string, ring::PaddedLayout, ring::DefaultBackoff, Stats, ring::OverwriteOldest> q(4);
+        for (int i = 0; i < 10; ++i) check(q.enqueue(std::to_string(i)), "overwrite enqueue");
+        check(q.size() == 4 && q.stats().dropped == 6, "overwrite evicts the oldest");
+        std::string v;
+        for (int i = 6; i < 10; ++i) check(q.try_dequeue(v) && v == std::to_string(i), "overwrite keeps the newest");
+    }
+    {
+        ring::RingMPMC<int, ring::SplitLayout, ring::DefaultBackoff, Stats, ring::OverwriteOldest> q(8);
+        int in[20];
+        for (int i = 0; i < 20; ++i) in[i] = i;
+        check(q.enqueue_many(in, 20) == 20 && q.size() == 8, "overwrite batch");
+        check(q.dequeue_many(out, 8) == 8 && out[0] == 12 && out[7] == 19, "overwrite batch keeps the newest");
+        check(q.stats().dropped == 12, "overwrite batch dropped count");
+    }
+    {
+        // Producers evicting while others are mid-write: every item is
+        // either consumed or counted as dropped, and nobody livelocks.
+        constexpr int P = 3, N = 20000;
+        ring::RingMPMC<int, ring::PaddedLayout, ring::DefaultBackoff, Stats, ring::OverwriteOldest> q(4);
+        std::atomic<int> done{0};
+        std::vector<std::thread> producers;
+        for (int p = 0; p < P; ++p) {
+            producers.emplace_back([&, p] {
+                const int in[3] = {p, p, p};
+                for (int i = 0; i < N; i += 4) { q.enqueue(p); q.enqueue_many(in, 3); }
+                done.fetch_add(1);
+            });
+        }
+        std::uint64_t got = 0;
+        int v = 0;
+        while (done.load() < P) got += q.try_dequeue(v);
+        for (auto& t : producers) t.join();
+        while (q.try_dequeue(v)) ++got;
+        check(got + q.stats().dropped == static_cast<std::uint64_t>(P) * N, "contended overwrite accounts for every item");
+    }
+    {
+        ring::BroadcastRing<int, ring::DefaultBackoff, Stats, ring::DropNewest> b(4, 2);
+        for (int i = 0; i < 6; ++i) b.publish(i);
+        int v = -1;
+        check(b.try_read(0, v) && v == 0 && b.stats().dropped == 2, "broadcast drop-newest");
+    }
+
+    // Overwrite broadcast: a stalled reader is lapped, detects it through the
+    // slot generations and resumes at the oldest item still in the ring.
+    struct Tick { std::uint64_t seq, check; };
+    ring::BroadcastRing<Tick, ring::DefaultBackoff, Stats, ring::OverwriteOldest> b(8, 2);
+    for (std::uint64_t i = 0; i < 20; ++i) check(b.publish(Tick{ i, ~i }), "overwrite publish never waits");
+    Tick t{};
+    check(b.try_read(1, t) && t.seq == 12 && b.lost(1) == 12, "lapped reader skips ahead");
+    check(b.read_many(0, &t, 1) == 1 && t.seq == 12 && b.lost(0) == 12, "lapped reader (batch)");
+    check(b.stats().dropped == 24, "broadcast lost items counted as dropped");
+
+    // Same under concurrency: what a reader sees is increasing, untorn, and
+    // seen + lost covers every item.
+    constexpr std::uint64_t N = 200000;
+    ring::BroadcastRing<Tick, ring::DefaultBackoff, ring::NoStats, ring::OverwriteOldest> live(64, 1);
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        std::uint64_t seen = 0, last = 0;
+        for (;;) {
+            const bool finished = done.load();
+            live.poll(0, [&](const Tick& x) {
+                check(x.check == ~x.seq, "overwrite read not torn");
+                check(seen == 0 || x.seq > last, "overwrite reads increase");
+                last = x.seq; ++seen;
+            });
+            if (finished && live.backlog(0) == 0) break;
+        }
+        check(seen + live.lost(0) == N, "seen + lost covers every item");
+    });
+    for (std::uint64_t i = 0; i < N; ++i) live.publish(Tick{ i, ~i });
+    done.store(true);
+    reader.join();
+    std::cout << "overflow smoke ran (reader lost " << live.lost(0) << " of " << N << ")\n";
+}
+
+void linked_smoke() {
+    // A burst spills into linked segments; draining hands them back to the
+    // pool and the queue shrinks to one segment. FIFO holds throughout.
+    ring::LinkedRingMPMC<std::string> q(8, 2);
+    for (int i = 0; i < 100; ++i) q.enqueue(std::to_string(i));
+    check(q.segment_count() == 13 && q.size() >= 100, "burst links segments");
+    std::string v;
+    for (int i = 0; i < 100; ++i) check(q.try_dequeue(v) && v == std::to_string(i), "linked FIFO across segments");
+    check(!q.try_dequeue(v) && q.segment_count() == 1 && q.empty(), "drained back to one segment");
+    check(q.pooled() == 2, "recycling pool capped at max_pooled");
+    for (int i = 0; i < 20; ++i) q.enqueue(std::string(32, 'x')); // left for the destructor
+
+    // Concurrent producers and consumers on small segments: exactly once,
+    // per-producer FIFO, no producer ever waits.
+    constexpr int P = 3, C = 3;
+    constexpr std::uint64_t N = 60000;
+    ring::LinkedRingMPMC<std::uint64_t, ring::SplitLayout> lq(64);
+    std::vector<std::atomic<int>> seen(P * N);
+    std::atomic<std::uint64_t> consumed{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < P; ++p) threads.emplace_back([&, p] {
+        std::uint64_t buf[16];
+        for (std::uint64_t i = 0; i < N; i += 16) {
+            for (std::uint64_t k = 0; k < 16; ++k) buf[k] = static_cast<std::uint64_t>(p) * N + i + k;
+            if (i % 32 == 0) lq.enqueue_many(buf, 16);
+            else for (std::uint64_t k = 0; k < 16; ++k) lq.enqueue(buf[k]);
+        }
+    });
+    for (int c = 0; c < C; ++c) threads.emplace_back([&] {
+        std::uint64_t last[P];
+        for (auto& l : last) l = ~std::uint64_t{0};
+        std::uint64_t out[32];
+        while (consumed.load() < P * N) {
+            const std::size_t got = lq.dequeue_many(out, 32);
+            if (got == 0) { std::this_thread::yield(); continue; }
+            for (std::size_t k = 0; k < got; ++k) {
+                const std::uint64_t p = out[k] / N;
+                check(last[p] == ~std::uint64_t{0} || out[k] > last[p], "linked per-producer FIFO");
+                last[p] = out[k];
+                seen[out[k]].fetch_add(1);
+            }
+            consumed.fetch_add(got);
+        }
+    });
+    for (auto& t : threads) t.join();
+    for (std::uint64_t i = 0; i < P * N; ++i) check(seen[i].load() == 1, "linked exactly once");
+    std::cout << "linked smoke ran (" << lq.segment_count() << " segment(s) linked, "
+              << lq.pooled() << " pooled)\n";
+}
+
+void fan_in_smoke() {
+    // Plain sweep: exactly once, FIFO per producer.
+    constexpr int P = 4;
+    constexpr std::uint64_t N = 50000;
+    {
+        ring::FanInRing<std::uint64_t> q(P, 256);
+        check(q.producers() == P && q.capacity_per_producer() == 256, "fan-in shape");
+        static_assert(std::is_const_v<std::remove_reference_t<decltype(q.producer(0).lane())>>, "lanes are read-only from outside");
+        std::vector<std::thread> producers;
+        for (int p = 0; p < P; ++p) producers.emplace_back([&, p] {
+            auto& tx = q.producer(static_cast<std::size_t>(p));
+            for (std::uint64_t i = 0; i < N; ++i) {
+                if (i % 2) tx.enqueue(static_cast<std::uint64_t>(p) * N + i);
+                else while (!tx.try_enqueue(static_cast<std::uint64_t>(p) * N + i)) std::this_thread::yield();
+            }
+        });
+        std::vector<std::uint64_t> next(P, 0);
+        std::uint64_t out[64], total = 0;
+        while (total < P * N) {
+            const std::size_t got = q.dequeue_many(out, 64);
+            if (got == 0) { std::uint64_t one; q.dequeue(one); out[0] = one; }
+            for (std::size_t k = 0; k < (got ? got : 1); ++k) {
+                const std::uint64_t p = out[k] / N;
+                check(out[k] % N == next[p]++, "fan-in per-producer FIFO");
+            }
+            total += got ? got : 1;
+        }
+        for (auto& t : producers) t.join();
+        check(q.size() == 0, "fan-in drained");
+    }
+
+    // Timestamp merge: producer p sends stamps p, p + P, p + 2P, ... so the
+    // merged stream must be exactly 0, 1, 2, ...
+    {
+        struct Msg { std::uint64_t ts; };
+        ring::FanInRing<Msg> q(P, 64);
+        std::atomic<int> done{0};
+        std::vector<std::thread> producers;
+        for (int p = 0; p < P; ++p) producers.emplace_back([&, p] {
+            for (std::uint64_t i = 0; i < N; ++i) q.producer(static_cast<std::size_t>(p)).enqueue(Msg{ i * P + static_cast<std::uint64_t>(p) });
+            done.fetch_add(1);
+        });
+        auto ts = [](const Msg& m) { return m.ts; };
+        Msg out[32];
+        std::uint64_t expect = 0;
+        while (expect < P * N) {
+            const bool flush = done.load() == P;
+            const std::size_t got = q.dequeue_ordered(out, 32, ts, !flush);
+            for (std::size_t k = 0; k < got; ++k) check(out[k].ts == expect++, "fan-in timestamp merge order");
+            if (got == 0) std::this_thread::yield();
+        }
+        for (auto& t : producers) t.join();
+    }
+
+    // Sweep calls between merges must not leave a stale cached head key.
+    {
+        struct Msg { std::uint64_t ts; };
+        ring::FanInRing<Msg> q(2, 8);
+        auto ts = [](const Msg& m) { return m.ts; };
+        q.producer(0).enqueue(Msg{1});
+        q.producer(0).enqueue(Msg{5});
+        q.producer(1).enqueue(Msg{3});
+        Msg out[2];
+        check(q.dequeue_ordered(out, 1, ts) == 1 && out[0].ts == 1, "merge takes the smallest head");
+        check(q.try_dequeue(out[0]) && q.try_dequeue(out[1]) && q.size() == 0, "sweep drains both lanes");
+        q.producer(0).enqueue(Msg{7});
+        q.producer(1).enqueue(Msg{10});
+        check(q.dequeue_ordered(out, 2, ts, false) == 2 && out[0].ts == 7 && out[1].ts == 10, "merge after sweep re-reads heads");
+    }
+    std::cout << "fan-in smoke ran\n";
+}
+
+void priority_smoke() {
+    using Q = ring::PriorityRing<int, 3>;
+    int out[16];
+
+    // Strict: a control item overtakes queued bulk; empty lanes drop out
+    // of the occupancy mask.
+    {
+        Q q(64);
+        check(q.occupancy() == 0 && !q.try_dequeue(out[0]), "priority ring starts empty");
+        for (int i = 0; i < 20; ++i) q.try_enqueue(2, 200 + i);
+        check(q.occupancy() == 0b100, "bulk lane occupied");
+        check(q.dequeue_many(out, 4) == 4 && out[0] == 200 && out[3] == 203, "bulk drains FIFO");
+        static_assert(std::is_const_v<std::remove_reference_t<decltype(q.lane(2))>>, "lanes are read-only from outside");
+        check(q.lane(2).size() == 16, "lane view reads a lane's size");
+        q.try_enqueue(0, 1);
+        q.try_enqueue(1, 10);
+        q.try_enqueue(0, 2);
+        check(q.occupancy() == 0b111, "all lanes occupied");
+        check(q.dequeue_many(out, 5) == 5, "strict batch");
+        check(out[0] == 1 && out[1] == 2 && out[2] == 10 && out[3] == 204 && out[4] == 205, "strict priority order");
+        check(q.occupancy() == 0b100, "drained lanes leave the mask");
+        while (q.dequeue_many(out, 16)) {}
+        check(q.occupancy() == 0 && q.size() == 0, "priority ring drained");
+    }
+
+    // Weighted round robin 3:1, carried across calls of any size.
+    for (std::size_t batch : {8u, 1u}) {
+        Q q(64, {3, 1, 1});
+        for (int i = 0; i < 40; ++i) { q.try_enqueue(0, i); q.try_enqueue(1, 100 + i); }
+        std::vector<int> got;
+        while (got.size() < 16) {
+            const std::size_t k = q.dequeue_many(out, batch, ring::DrainOrder::WeightedRoundRobin);
+            got.insert(got.end(), out, out + k);
+        }
+        const std::vector<int> expect = {0, 1, 2, 100, 3, 4, 5, 101, 6, 7, 8, 102, 9, 10, 11, 103};
+        check(got == expect, "weighted round robin proportions");
+    }
+
+    // Concurrent: producers on every lane, strict and weighted consumers;
+    // exactly once and FIFO per producer.
+    constexpr int P = 3, N = 30000;
+    Q q(128, {4, 2, 1});
+    std::vector<std::atomic<int>> seen(P * N);
+    std::atomic<int> consumed{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < P; ++p) threads.emplace_back([&, p] {
+        for (int i = 0; i < N; ++i) q.enqueue(static_cast<std::size_t>(p), p * N + i);
+    });
+    for (int c = 0; c < 2; ++c) threads.emplace_back([&, c] {
+        const ring::DrainOrder order = c ? ring::DrainOrder::WeightedRoundRobin : ring::DrainOrder::Strict;
+        std::vector<int> last(P, -1);
+        int buf[32];
+        while (consumed.load() < P * N) {
+            const std::size_t k = q.dequeue_many(buf, 32, order);
+            if (k == 0) { std::this_thread::yield(); continue; }
+            for (std::size_t j = 0; j < k; ++j) {
+                check(seen[buf[j]].fetch_add(1) == 0, "priority item seen once");
+                check(buf[j] % N > last[buf[j] / N], "priority per-lane FIFO");
+                last[buf[j] / N] = buf[j] % N;
+            }
+            consumed.fetch_add(static_cast<int>(k));
+        }
+    });
+    for (auto& t : threads) t.join();
+    check(q.dequeue_many(out, 16) == 0 && q.occupancy() == 0, "priority mask clear after drain");
+    std::cout << "priority smoke ran\n";
+}
+
+void ticket_block_smoke() {
+    using Q = ring::RingMPMC<int>;
+    int v = 0;
+    std::vector<int> got;
+    auto take_all = [&](Q& q) { got.clear(); while (q.try_dequeue(v)) got.push_back(v); };
+
+    // Unused producer tickets go back by rewinding tail_ or as skips.
+    {
+        Q q(16);
+        {
+            Q::ProducerBlock a(q, 8);
+            for (int i = 0; i < 3; ++i) check(a.try_enqueue(i), "block enqueue");
+            check(a.reserved() == 5, "block keeps unused tickets");
+            a.flush();
+            check(q.size() == 3, "flush rewinds tail");
+            take_all(q);
+            check(got == std::vector<int>({0, 1, 2}), "block items in order");
+        }
+        Q::ProducerBlock a(q, 4), b(q, 4);
+        check(a.try_enqueue(100) && b.try_enqueue(200), "two blocks enqueue");
+        a.flush(); // b claimed after a: a's rest become skips
+        take_all(q);
+        check(got == std::vector<int>({100, 200}), "consumers step over skips");
+        b.flush();
+        check(q.try_enqueue(300) && q.try_dequeue(v) && v == 300 && q.size() == 0, "ring usable after flushes");
+
+        Q::ProducerBlock c(q, 16);
+        for (int i = 0; i < 16; ++i) check(c.try_enqueue(i), "fill ring through block");
+        check(!c.try_enqueue(16), "block reports full");
+    }
+
+    // Claimed consumer items go back by rewinding head_ or re-enqueueing.
+    {
+        Q q(16);
+        for (int i = 0; i < 10; ++i) q.try_enqueue(i);
+        Q::ConsumerBlock c(q, 4);
+        check(c.try_dequeue(v) && v == 0 && c.try_dequeue(v) && v == 1 && c.reserved() == 2, "consumer block serves claim");
+        c.flush();
+        take_all(q);
+        check(got == std::vector<int>({2, 3, 4, 5, 6, 7, 8, 9}), "flush rewinds head");
+
+        for (int i = 0; i < 10; ++i) q.try_enqueue(i);
+        check(c.try_dequeue(v) && v == 0, "consumer block claim");
+        check(q.try_dequeue(v) && v == 4, "plain consumer skips claimed run");
+        c.flush();
+        take_all(q);
+        check(got == std::vector<int>({5, 6, 7, 8, 9, 1, 2, 3}), "flush re-enqueues the rest");
+    }
+
+    // Concurrent: blocks mixed with plain producers / consumers, frequent
+    // producer flushes; exactly once and per-producer FIFO per consumer.
+    constexpr int P = 3, C = 3, N = 20000;
+    Q q(64);
+    std::vector<std::atomic<int>> seen(P * N);
+    std::atomic<int> consumed{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < P; ++p) threads.emplace_back([&, p] {
+        Q::ProducerBlock tx(q, 16);
+        for (int i = 0; i < N; ++i) {
+            const int x = p * N + i;
+            if (p == P - 1) { while (!q.try_enqueue(x)) std::this_thread::yield(); continue; }
+            while (!tx.try_enqueue(x)) std::this_thread::yield();
+            if (i % (37 + p) == 0) tx.flush();
+        }
+    });
+    for (int c = 0; c < C; ++c) threads.emplace_back([&, c] {
+        Q::ConsumerBlock rx(q, 16);
+        std::vector<int> last(P, -1);
+        int buf[8];
+        while (consumed.load() < P * N) {
+            std::size_t n = 0;
+            if (c == 0) n = rx.try_dequeue(buf[0]) ? 1 : 0;
+            else if (c == 1) n = q.try_dequeue(buf[0]) ? 1 : 0;
+            else n = q.dequeue_many(buf, 8);
+            if (n == 0) { std::this_thread::yield(); continue; }
+            for (std::size_t k = 0; k < n; ++k) {
+                const int x = buf[k];
+                check(seen[x].fetch_add(1) == 0, "ticket block item seen once");
+                check(x % N > last[x / N], "ticket block per-producer order");
+                last[x / N] = x % N;
+            }
+            consumed.fetch_add(static_cast<int>(n));
+        }
+    });
+    for (auto& t : threads) t.join();
+    check(consumed.load() == P * N, "ticket block exactly once");
+    std::cout << "ticket block smoke ran\n";
+}
+
+#if defined(__cpp_impl_coroutine)
+// Fire-and-forget coroutine: runs until its first suspension on creation,
+// frees itself at the end.
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::abort(); }
+    };
+};
+
+void async_smoke() {
+    using Q = ring::RingMPMC<int>;
+
+    // Inline resumption: the publishing thread runs the woken coroutine.
+    {
+        Q q(4);
+        int last = -1, done = 0;
+        auto consumer = [&](Q& in) -> Detached {
+            for (int i = 0; i < 100; ++i) last = co_await in.async_dequeue();
+            ++done;
+        };
+        consumer(q);
+        check(last == -1, "async_dequeue suspends on an empty ring");
+        for (int i = 0; i < 100; ++i) {
+            check(q.try_enqueue(i) && last == i, "publish resumes the waiting coroutine inline");
+        }
+        check(done == 1 && q.size() == 0, "async consumer finished");
+
+        int sent = 0;
+        auto producer = [&](Q& out) -> Detached {
+            for (int i = 0; i < 10; ++i) { co_await out.async_enqueue(i); sent = i + 1; }
+        };
+        producer(q);
+        check(sent == 4, "async_enqueue suspends on a full ring");
+        int v = 0, expect = 0;
+        while (expect < 10) { check(q.try_dequeue(v) && v == expect++, "async enqueue order"); }
+        check(sent == 10, "freed slots resume the producer");
+    }
+
+    // Thousands of stages over a few threads: coroutine producers and
+    // consumers, batch and single-item forms, resumed through a Scheduler.
+    {
+        constexpr int P = 64, C = 256, N = 500;
+        Q q(64);
+        ring::Scheduler sched(2);
+        std::vector<std::atomic<int>> seen(P * N);
+        std::atomic<int> consumed{0}, finished{0};
+        auto producer = [&](int p) -> Detached {
+            std::vector<int> batch;
+            for (int i = 0; i < N; ++i) {
+                if (p % 2) { co_await q.async_enqueue(p * N + i, sched); continue; }
+                batch.push_back(p * N + i);
+                if (batch.size() == 20) { check(co_await q.async_enqueue_many(batch.data(), batch.size(), sched) == 20, "async enqueue_many places all"); batch.clear(); }
+            }
+            finished.fetch_add(1);
+        };
+        auto consumer = [&](int c) -> Detached {
+            int buf[16];
+            const int share = P * N / C;
+            for (int got = 0; got < share;) {
+                std::size_t n = 1;
+                if (c % 2) buf[0] = co_await q.async_dequeue(sched);
+                else n = co_await q.async_dequeue_many(buf, std::min<std::size_t>(16, static_cast<std::size_t>(share - got)), sched);
+                for (std::size_t k = 0; k < n; ++k) check(seen[buf[k]].fetch_add(1) == 0, "async item seen once");
+                got += static_cast<int>(n);
+                consumed.fetch_add(static_cast<int>(n));
+            }
+            finished.fetch_add(1);
+        };
+        ring::TaskGroup g;
+        for (int c = 0; c < C; ++c) sched.spawn(g, [&, c] { consumer(c); });
+        for (int p = 0; p < P; ++p) sched.spawn(g, [&, p] { producer(p); });
+        sched.wait(g);
+        const auto deadline = std::chrono::steady_clock::now() + 30s;
+        while (finished.load() < P + C && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(1ms);
+        check(finished.load() == P + C && consumed.load() == P * N, "async pipeline drained");
+    }
+    std::cout << "async smoke ran\n";
+}
+
+// Same handshakes with heavy_fence() forced onto its plain-fence fallback:
+// notify() must then pay the full fence itself, or waiters that register
+// while a publisher checks waiters_ sleep through the wakeup.
+void fence_fallback_smoke() {
+    using Q = ring::RingMPMC<int>;
+    ring::detail::no_os_barrier.store(true);
+    check(!ring::heavy_fence_supported() && !ring::heavy_fence(), "forced fallback reports no OS barrier");
+    {
+        constexpr int P = 2, C = 4, N = 20000;
+        Q q(8);
+        ring::Scheduler sched(2);
+        std::vector<std::atomic<int>> seen(P * N);
+        std::atomic<int> consumed{0}, finished{0};
+        auto consumer = [&]() -> Detached {
+            for (int i = 0; i < P * N / C; ++i) {
+                const int v = co_await q.async_dequeue(sched);
+                check(seen[v].fetch_add(1) == 0, "fallback item seen once");
+                consumed.fetch_add(1);
+            }
+            finished.fetch_add(1);
+        };
+        for (int c = 0; c < C; ++c) consumer();
+        std::vector<std::thread> producers;
+        for (int p = 0; p < P; ++p) {
+            producers.emplace_back([&, p] {
+                for (int i = 0; i < N; ++i) q.enqueue(p * N + i);
+            });
+        }
+        for (auto& t : producers) t.join();
+        const auto deadline = std::chrono::steady_clock::now() + 30s;
+        while (finished.load() < C && std::chrono::steady_clock::now() < deadline) std::this_thread::sleep_for(1ms);
+        check(finished.load() == C && consumed.load() == P * N, "async waiters get every wakeup on the fallback path");
+    }
+    {
+        constexpr int N = 20000;
+        Q ping(1), pong(1);
+        std::thread echo([&] {
+            int v = 0;
+            for (int i = 0; i < N; ++i) { ping.dequeue(v); pong.enqueue(v); }
+        });
+        int v = 0;
+        bool ordered = true;
+        for (int i = 0; i < N; ++i) { ping.enqueue(i); pong.dequeue(v); ordered &= (v == i); }
+        echo.join();
+        check(ordered, "blocking ping-pong on the fallback path");
+    }
+    ring::detail::no_os_barrier.store(false);
+    std::cout << "fence fallback smoke ran\n";
+}
+#endif
+
+// Counts live instances so leaks / double destroys show up as a non-zero
+// balance.
+struct Tracked {
+    static inline std::atomic<int> live{0};
+    std::vector<int> buf;
+    explicit Tracked(int v = 0) : buf(4, v) { ++live; }
+    Tracked(const Tracked& o) : buf(o.buf) { ++live; }
+    Tracked(Tracked&& o) noexcept : buf(std::move(o.buf)) { ++live; }
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) noexcept = default;
+    ~Tracked() { --live; }
+};
+
+template <class Q>
+void drain_smoke() {
+    // Items left in the ring are destroyed with it, including after wrap.
+    {
+        Q q(16);
+        for (int i = 0; i < 40; ++i) {
+            check(q.try_enqueue(Tracked(i)), "drain enqueue");
+            if (i % 4 != 3) { Tracked t; check(q.try_dequeue(t), "drain dequeue"); }
+        }
+        check(Tracked::live.load() == 10, "live items in ring");
+    }
+    check(Tracked::live.load() == 0, "ring destructor destroys queued items");
+
+    // drain() hands each item over once, in order, and leaves the ring empty.
+    {
+        Q q(16);
+        for (int i = 0; i < 12; ++i) check(q.try_enqueue(Tracked(i)), "drain enqueue");
+        std::vector<Tracked> pool;
+        check(q.drain([&](Tracked&& t) { pool.push_back(std::move(t)); }) == 12, "drain count");
+        check(q.size() == 0 && q.drain([](Tracked&&) {}) == 0, "drained ring is empty");
+        for (int i = 0; i < 12; ++i) check(pool[i].buf.size() == 4 && pool[i].buf[0] == i, "drain order");
+        check(Tracked::live.load() == 12, "drain moved items out");
+    }
+    check(Tracked::live.load() == 0, "drain leaves nothing behind");
+    std::cout << "drain smoke ran\n";
+}
+
+// Batch runs on split storage go through the vector ticket scan and block
+// copies (simd.hpp); runs straddle the wrap and end on every lane offset.
+template <class Q>
+void split_batch_run(Q& q) {
+    std::vector<std::uint64_t> in(q.capacity()), out(q.capacity());
+    std::uint64_t next_in = 0, next_out = 0;
+    for (std::size_t round = 0; round < 400; ++round) {
+        const std::size_t want = 1 + (round * 7) % (q.capacity() - 1);
+        for (std::size_t i = 0; i < want; ++i) in[i] = next_in + i;
+        const std::size_t put = q.try_enqueue_many(in.data(), want);
+        next_in += put;
+        const std::size_t got = q.dequeue_many(out.data(), 1 + (round * 5) % q.capacity());
+        for (std::size_t i = 0; i < got; ++i) check(out[i] == next_out + i, "split batch order");
+        next_out += got;
+    }
+    while (std::size_t got = q.dequeue_many(out.data(), out.size())) {
+        for (std::size_t i = 0; i < got; ++i) check(out[i] == next_out + i, "split batch tail order");
+        next_out += got;
+    }
+    check(next_out == next_in, "split batch count");
+}
+
+void simd_smoke() {
+    // ticket_run matches the scalar scan for every length and mismatch spot.
+    std::vector<std::atomic<std::uint64_t>> seqs(40);
+    for (std::size_t miss = 0; miss <= seqs.size(); ++miss) {
+        for (std::size_t i = 0; i < seqs.size(); ++i) seqs[i].store(100 + i + (i == miss ? 7 : 0));
+        for (std::size_t n = 0; n <= seqs.size(); ++n) {
+            const std::size_t k = ring::simd::ticket_run(seqs.data(), 100, n);
+            check(k == std::min(n, miss), "ticket_run length");
+            check(k == ring::simd::detail::ticket_run_scalar(seqs.data(), 100, n), "ticket_run vs scalar");
+        }
+    }
+
+    { ring::RingMPMC<std::uint64_t, ring::SplitLayout> q(64); split_batch_run(q); }
+    { ring::RingSPSC<std::uint64_t, ring::SplitLayout> q(64); split_batch_run(q); }
+    { static ring::FixedRingMPMC<std::uint64_t, 32, ring::SplitLayout> q; split_batch_run(q); }
+
+    // Batches past RING_STREAM_COPY_BYTES take the streaming copy; start
+    // off 32-byte alignment and wrap on the second pass.
+    ring::RingMPMC<std::uint64_t, ring::SplitLayout> q(std::size_t{1} << 18);
+    const std::size_t big = std::size_t{3} << 16; // 1.5 MiB of payload
+    std::vector<std::uint64_t> in(big), out(big);
+    for (std::uint64_t i = 0; i < 3; ++i) { q.try_enqueue(i); std::uint64_t x; q.try_dequeue(x); }
+    for (int pass = 0; pass < 2; ++pass) {
+        for (std::size_t i = 0; i < big; ++i) in[i] = i * 3 + pass;
+        check(q.try_enqueue_many(in.data(), big) == big, "streaming enqueue");
+        check(q.dequeue_many(out.data(), big) == big, "streaming dequeue");
+        check(out == in, "streaming copy round trip");
+    }
+    std::cout << "simd smoke ran (" << ring::simd::isa() << ")\n";
+}
+
+// Message k of the byte ring tests: (k * 37) % 201 bytes of k + i.
+static std::size_t byte_msg_len(std::uint64_t k) { return static_cast<std::size_t>((k * 37) % 201); }
+
+static bool byte_msg_ok(const ring::ByteRecord& r, std::uint64_t k) {
+    if (r.size != byte_msg_len(k)) return false;
+    for (std::size_t i = 0; i < r.size; ++i) {
+        if (r.data[i] != static_cast<std::byte>(k + i)) return false;
+    }
+    return true;
+}
+
+struct Quote {
+    std::uint32_t id;
+    std::uint32_t qty;
+    double        px;
+};
+
+template <class Q>
+void byte_ring_smoke() {
+    Q q(1024);
+    check(q.capacity() == 1024 && q.max_message() == 504, "byte ring limits");
+    const std::vector<unsigned char> big(505);
+    check(!q.reserve(505) && !q.try_write(big.data(), big.size()), "oversized message rejected");
+    std::size_t empty_len = 1;
+    check(q.try_write(nullptr, 0) && q.try_read([&](const ring::ByteRecord& r) { empty_len = r.size; }) && empty_len == 0,
+          "empty record from a null source");
+
+    // Many laps of mixed lengths (0..200), so records keep hitting the wrap.
+    std::vector<unsigned char> buf(256);
+    std::uint64_t wrote = 0, read = 0;
+    while (read < 5000) {
+        for (;;) {
+            const std::size_t len = byte_msg_len(wrote);
+            for (std::size_t i = 0; i < len; ++i) buf[i] = static_cast<unsigned char>(wrote + i);
+            if (!q.try_write(buf.data(), len)) break;
+            ++wrote;
+        }
+        check(q.size_bytes() > 1024 - 416, "byte ring fills up");
+        if (read % 2) {
+            check(q.try_read([&](const ring::ByteRecord& r) { check(byte_msg_ok(r, read++), "byte record"); }), "byte read");
+        } else {
+            q.consume([&](const ring::ByteRecord& r) { check(byte_msg_ok(r, read++), "byte record batch"); }, 3);
+        }
+    }
+    q.consume([&](const ring::ByteRecord& r) { check(byte_msg_ok(r, read++), "byte record tail"); });
+    check(read == wrote && q.empty() && !q.peek(), "byte ring drained");
+
+    // Typed records, constructed and read in place.
+    check(q.template try_emplace<Quote>(7u, 100u, 1.5), "emplace");
+    const ring::ByteRecord r = q.peek();
+    check(r && r.size == sizeof(Quote) && r.template as<Quote>().id == 7 && r.template as<Quote>().px == 1.5, "typed record");
+    q.release(r);
+    check(q.empty(), "typed record released");
+}
+
+void byte_ring_mpmc_threads() {
+    // Producer p sends (p << 32 | k) for k = 0..N-1 as the first 8 bytes of
+    // message k. Every consumer sees each producer's messages in order.
+    constexpr int P = 3, C = 2;
+    constexpr std::uint64_t N = 20000;
+    ring::ByteRingMPMC<> q(4096);
+    std::atomic<std::uint64_t> got{0}, sum{0};
+    std::vector<std::thread> ts;
+    for (int p = 0; p < P; ++p) {
+        ts.emplace_back([&, p] {
+            std::vector<unsigned char> buf(8 + 200);
+            for (std::uint64_t k = 0; k < N; ++k) {
+                const std::uint64_t tag = (static_cast<std::uint64_t>(p) << 32) | k;
+                std::memcpy(buf.data(), &tag, 8);
+                const std::size_t len = 8 + byte_msg_len(k);
+                for (std::size_t i = 8; i < len; ++i) buf[i] = static_cast<unsigned char>(tag + i);
+                q.write(buf.data(), len);
+            }
+        });
+    }
+    for (int c = 0; c < C; ++c) {
+        ts.emplace_back([&] {
+            std::vector<std::int64_t> last(P, -1);
+            while (got.load() < P * N) {
+                q.consume([&](const ring::ByteRecord& r) {
+                    std::uint64_t tag;
+                    std::memcpy(&tag, r.data, 8);
+                    const std::uint64_t p = tag >> 32, k = tag & 0xFFFFFFFFu;
+                    check(p < P && r.size == 8 + byte_msg_len(k), "mpmc byte record size");
+                    for (std::size_t i = 8; i < r.size; ++i) check(r.data[i] == static_cast<std::byte>(tag + i), "mpmc byte payload");
+                    check(static_cast<std::int64_t>(k) > last[p], "mpmc byte per-producer order");
+                    last[p] = static_cast<std::int64_t>(k);
+                    sum.fetch_add(k);
+                    got.fetch_add(1);
+                }, 16);
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& t : ts) t.join();
+    check(got.load() == P * N && sum.load() == P * (N * (N - 1) / 2), "mpmc byte exactly once");
+    check(q.empty() && q.size_bytes() == 0, "mpmc byte ring drained");
+    std::cout << "byte ring smoke ran\n";
+}
+
+void pool_smoke() {
+    struct Big {
+        std::vector<int> v;
+        std::uint64_t    words[10];
+    };
+    ring::Pool<Big> pool(5);
+    check(pool.capacity() == 5 && pool.available() == 5, "pool size");
+
+    std::vector<Big*> taken;
+    while (Big* p = pool.try_acquire()) taken.push_back(p);
+    check(taken.size() == 5 && pool.available() == 0, "pool exhausts");
+    for (Big* p : taken) {
+        check(pool.owns(p) && reinterpret_cast<std::uintptr_t>(p) % 64 == 0, "pool object placement");
+        p->v.assign(100, 1);
+    }
+    check(!pool.owns(reinterpret_cast<Big*>(reinterpret_cast<std::byte*>(taken[0]) + 8)), "pool owns() rejects interior pointers");
+    for (Big* p : taken) pool.release(p);
+
+    // Objects are reused as left: no reallocation of the vector.
+    {
+        ring::Pool<Big>::Ptr p = pool.acquire_ptr();
+        check(p && p->v.capacity() >= 100, "pool object keeps its state");
+    }
+    check(pool.available() == 5, "Ptr returns its object");
+
+    // Pointer passing: acquire -> fill -> enqueue -> consume -> release,
+    // with per-thread caches on both ends.
+    constexpr int P = 2, C = 2, N = 20000;
+    ring::Pool<Big> shared(256);
+    ring::RingMPMC<Big*> q(64);
+    std::atomic<int> got{0};
+    std::atomic<std::uint64_t> sum{0};
+    std::vector<std::thread> ts;
+    for (int t = 0; t < P; ++t) {
+        ts.emplace_back([&, t] {
+            ring::Pool<Big>::Cache cache(shared, 8);
+            for (int i = 0; i < N; ++i) {
+                Big* b = cache.acquire();
+                b->words[0] = static_cast<std::uint64_t>(t) * N + i;
+                q.enqueue(b);
+            }
+        });
+    }
+    for (int t = 0; t < C; ++t) {
+        ts.emplace_back([&] {
+            ring::Pool<Big>::Cache cache(shared, 8);
+            Big* b = nullptr;
+            while (got.load() < P * N) {
+                if (!q.dequeue_for(b, std::chrono::milliseconds(1))) continue;
+                check(shared.owns(b), "pool pointer through ring");
+                sum.fetch_add(b->words[0]);
+                cache.release(b);
+                got.fetch_add(1);
+            }
+        });
+    }
+    for (auto& t : ts) t.join();
+    const std::uint64_t total = std::uint64_t{P} * N;
+    check(sum.load() == total * (total - 1) / 2, "pool items exactly once");
+    check(shared.available() == 256, "every pooled object came back");
+    std::cout << "pool smoke ran\n";
+}
+
 int main() {
     spsc_smoke<ring::RingSPSC<int>>();
     mpmc_smoke<ring::RingMPMC<int>>();
+    spsc_smoke<ring::RingSPSC<int, ring::PackedLayout>>();
+    mpmc_smoke<ring::RingMPMC<int, ring::PackedLayout>>();
+    spsc_smoke<ring::RingSPSC<int, ring::SplitLayout>>();
+    mpmc_smoke<ring::RingMPMC<int, ring::SplitLayout>>();
+    try_enqueue_many_smoke<ring::RingMPMC<int>>();
+    try_enqueue_many_smoke<ring::RingMPMC<int, ring::SplitLayout>>();
+    try_enqueue_many_smoke<ring::RingSPSC<int>>();
+    spsc_batch_order<ring::RingSPSC<std::uint64_t>>();
+    spsc_batch_order<ring::RingSPSC<std::uint64_t, ring::PackedLayout>>();
+    zero_copy_smoke<ring::RingMPMC<std::string>>();
+    zero_copy_smoke<ring::RingMPMC<std::string, ring::SplitLayout>>();
+    zero_copy_smoke<ring::RingSPSC<std::string>>();
+    zero_copy_smoke<ring::RingSPSC<std::string, ring::PackedLayout>>();
+    backoff_smoke<ring::RingMPMC<int, ring::PaddedLayout, ring::SpinBackoff>>();
+    backoff_smoke<ring::RingMPMC<int, ring::PaddedLayout, ring::ExponentialBackoff<>>>();
+    backoff_smoke<ring::RingMPMC<int, ring::PaddedLayout, ring::SpinYieldBackoff<>>>();
+    backoff_smoke<ring::RingMPMC<int, ring::PaddedLayout, ring::SpinParkBackoff<>>>();
+    backoff_smoke<ring::RingSPSC<int, ring::PaddedLayout, ring::SpinYieldBackoff<>>>();
+    backoff_smoke<ring::RingSPSC<int, ring::PaddedLayout, ring::SpinParkBackoff<>>>();
+    blocking_smoke<ring::RingMPMC<int>>(3, 2);
+    blocking_smoke<ring::RingSPSC<int>>(1, 1);
+    affinity_smoke();
+    numa_smoke();
+    page_storage_smoke();
+    shm_smoke();
+    stats_smoke();
+    fixed_smoke();
+    work_stealing_smoke();
+    broadcast_smoke();
+    overflow_smoke();
+    linked_smoke();
+    fan_in_smoke();
+    ticket_block_smoke();
+    priority_smoke();
+#if defined(__cpp_impl_coroutine)
+    async_smoke();
+    fence_fallback_smoke();
+#endif
+    drain_smoke<ring::RingMPMC<Tracked>>();
+    drain_smoke<ring::RingMPMC<Tracked, ring::SplitLayout>>();
+    drain_smoke<ring::RingSPSC<Tracked>>();
+    drain_smoke<ring::RingSPSC<Tracked, ring::PackedLayout>>();
+    simd_smoke();
+    byte_ring_smoke<ring::ByteRingSPSC<>>();
+    byte_ring_smoke<ring::ByteRingMPMC<>>();
+    byte_ring_mpmc_threads();
+    pool_smoke();
     std::cout << "Correctness skeleton OK\n";
     return 0;
 }
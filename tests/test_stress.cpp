@@ -0,0 +1,846 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "ring/broadcast_ring.hpp"
+#include "ring/byte_ring.hpp"
+#include "ring/fan_in.hpp"
+#include "ring/linked_ring.hpp"
+#include "ring/priority_ring.hpp"
+#include "ring/ring_mpmc.hpp"
+#include "ring/ring_spsc.hpp"
+#include "ring/sharded_ring.hpp"
+#include "ring/stats.hpp"
+
+using u64 = std::uint64_t;
+using SteadyClock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+// Stress / linearizability harness for every queue variant.
+//
+// Producer p sends (p << 48) | seq for seq = 0, 1, ... . Each consumer keeps,
+// per producer, the next sequence number it may still see, a count and a
+// sum of mix(seq):
+//   - FIFO: a consumer's dequeues are ordered, so each producer's items
+//     must reach it in strictly increasing seq order;
+//   - exactly-once: per producer, the counts summed over consumers equal
+//     what the ring accepted and the mix sums match the producer's own, so
+//     a lost item cannot be masked by a duplicate.
+// State is O(producers x consumers) whatever the item count, so soak runs
+// can push billions of items. Threads mix single, blocking, timed and
+// batch calls and inject random spins / yields / sleeps, all drawn from a
+// per-thread generator seeded from (seed, round, thread): a failure prints
+// the seed that replays the same schedule of calls. Non-trivial payloads
+// count constructions and destructions; the balance must be zero once the
+// queue (with items left in it on purpose) is destroyed.
+//
+// Some variants add call paths on top of that mix: reserve/commit and
+// peek/release, RingMPMC ticket blocks opened, flushed early and dropped
+// at random, and the Overflow policies (DropNewest only owes the items it
+// accepted; under OverwriteOldest delivered + dropped must equal sent).
+// BroadcastRing readers must each see the writer's whole stream, byte
+// rings carry records whose bytes are checked against the item, and
+// ShardedRing spills across shards, so only exactly-once is checked there.
+
+struct Cfg {
+    u64 items_per_producer = 200'000;
+    int producers = 4;
+    int consumers = 4;
+    std::size_t capacity = 1u << 10;
+    u64 seed = 1;
+    u64 minutes = 0;        // 0 = one round per variant; else repeat rounds until the time is up
+    std::string only;       // run variants whose name contains this
+};
+
+static u64 parse_u64(const char* s, u64 def) {
+    if (!s) return def;
+    char* end = nullptr;
+    unsigned long long v = std::strtoull(s, &end, 10);
+    return (end && *end == '\0') ? static_cast<u64>(v) : def;
+}
+
+static u64 mix(u64 x) { // splitmix64 finalizer
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+struct Rng {
+    u64 s;
+    u64 operator()() { s ^= s << 13; s ^= s >> 7; s ^= s << 17; return s; }
+};
+
+static constexpr int kSeqBits = 48;
+static constexpr u64 kSeqMask = (u64{1} << kSeqBits) - 1;
+static constexpr std::size_t kMaxBatch = 64;
+
+// Non-trivially copyable payload: live instances are counted and a
+// destroyed one is poisoned, so a read of a dead slot decodes as an
+// out-of-range producer.
+struct Counted {
+    static inline std::atomic<long long> live{0};
+    u64 v = 0;
+    Counted() noexcept { live.fetch_add(1, std::memory_order_relaxed); }
+    explicit Counted(u64 x) noexcept : v(x) { live.fetch_add(1, std::memory_order_relaxed); }
+    Counted(const Counted& o) noexcept : v(o.v) { live.fetch_add(1, std::memory_order_relaxed); }
+    Counted& operator=(const Counted& o) noexcept { v = o.v; return *this; }
+    ~Counted() { v = ~u64{0}; live.fetch_sub(1, std::memory_order_relaxed); }
+};
+static_assert(!std::is_trivially_copyable_v<Counted>);
+
+static u64 value_of(u64 v) { return v; }
+static u64 value_of(const Counted& c) { return c.v; }
+
+static std::string g_variant;
+static u64 g_seed = 0;
+
+[[noreturn]] static void fail(const std::string& what) {
+    std::cerr << "ERROR [" << g_variant << ", seed " << g_seed << "]: " << what << "\n";
+    std::abort();
+}
+
+// Rare random stalls widen the windows between a claim and its publish.
+static void jitter(Rng& rng) {
+    const u64 r = rng();
+    if ((r & 63) == 0) {
+        for (u64 i = (r >> 8) & 1023; i > 0; --i) std::atomic_signal_fence(std::memory_order_seq_cst);
+    } else if ((r & 4095) == 1) {
+        std::this_thread::yield();
+    } else if ((r & 0xFFFFF) == 2) {
+        std::this_thread::sleep_for(50us);
+    }
+}
+
+static void relax(int& spins) {
+    if (++spins > 64) { std::this_thread::yield(); spins = 0; }
+}
+
+static u64 seed_of(const Cfg& cfg, u64 round, u64 thread) { return mix(cfg.seed ^ mix(round * 1024 + thread)) | 1; }
+
+// Extra call paths a variant drives on top of the single / blocking /
+// timed / batch mix.
+enum Ops : unsigned {
+    kZeroCopy       = 1, // reserve/commit and peek/release
+    kProducerBlocks = 2, // RingMPMC::ProducerBlock per producer, flushed early at random
+    kConsumerBlock  = 4, // RingMPMC::ConsumerBlock on consumer 0, flushed early at random
+    kNoFifo         = 8, // the ring does not keep per-producer order
+};
+
+// The ticket-block handle types, or placeholders where a variant does not use them.
+template <class Q, bool On> struct ProducerBlockOf { struct type {}; };
+template <class Q> struct ProducerBlockOf<Q, true> { using type = typename Q::ProducerBlock; };
+template <class Q, bool On> struct ConsumerBlockOf { struct type {}; };
+template <class Q> struct ConsumerBlockOf<Q, true> { using type = typename Q::ConsumerBlock; };
+
+// Rings without an Overflow parameter block when full.
+template <class Q> struct OverflowOf { using type = ring::BlockOnFull; };
+template <class Q> requires requires { typename Q::overflow_type; }
+struct OverflowOf<Q> { using type = typename Q::overflow_type; };
+
+// enqueue() returns void on the rings that cannot turn an item away.
+template <class Tx, class V>
+static bool enqueue_one(Tx& tx, V&& v) {
+    if constexpr (std::is_void_v<decltype(tx.enqueue(std::forward<V>(v)))>) {
+        tx.enqueue(std::forward<V>(v));
+        return true;
+    } else {
+        return tx.enqueue(std::forward<V>(v));
+    }
+}
+
+template <class Q>
+std::unique_ptr<Q> make_queue(const Cfg& cfg) {
+    if constexpr (requires { Q::per_producer_lanes; }) return std::make_unique<Q>(static_cast<std::size_t>(cfg.producers), cfg.capacity);
+    else return std::make_unique<Q>(cfg.capacity);
+}
+
+template <class Q>
+decltype(auto) producer_side(Q& q, int p) {
+    if constexpr (requires { q.producer(std::size_t{0}); }) return q.producer(static_cast<std::size_t>(p));
+    else return (q);
+}
+
+template <class Q>
+decltype(auto) consumer_side(Q& q, int c) {
+    if constexpr (requires { q.consumer(std::size_t{0}); }) return q.consumer(static_cast<std::size_t>(c));
+    else return (q);
+}
+
+// What a producer got into the ring (all it sent unless an Overflow
+// policy turned items away).
+struct Sent {
+    u64 count = 0, sum = 0;
+    void add(u64 seq) { ++count; sum += mix(seq); }
+};
+
+struct ConsumerLog {
+    std::vector<u64> next, count, sum; // per producer
+
+    void reset(int producers) {
+        next.assign(static_cast<std::size_t>(producers), 0);
+        count.assign(static_cast<std::size_t>(producers), 0);
+        sum.assign(static_cast<std::size_t>(producers), 0);
+    }
+
+    void take(const Cfg& cfg, int c, u64 v, bool fifo) {
+        const u64 p = v >> kSeqBits, seq = v & kSeqMask;
+        if (p >= next.size() || seq >= cfg.items_per_producer) fail("out-of-range item " + std::to_string(v));
+        if (fifo && seq < next[p]) {
+            fail("consumer " + std::to_string(c) + " got producer " + std::to_string(p) + " seq " + std::to_string(seq) +
+                 " after seq " + std::to_string(next[p] - 1) + " (FIFO or duplicate)");
+        }
+        next[p] = seq + 1;
+        ++count[p];
+        sum[p] += mix(seq);
+    }
+};
+
+// Per producer, the counts and mix sums over all logs equal what it sent.
+static void check_exactly_once(const std::vector<ConsumerLog>& logs, const std::vector<Sent>& sent) {
+    for (std::size_t p = 0; p < sent.size(); ++p) {
+        u64 count = 0, sum = 0;
+        for (const ConsumerLog& log : logs) { count += log.count[p]; sum += log.sum[p]; }
+        if (count != sent[p].count) fail("producer " + std::to_string(p) + ": " + std::to_string(count) + " of " + std::to_string(sent[p].count) + " items delivered");
+        if (sum != sent[p].sum) fail("producer " + std::to_string(p) + ": delivered items differ from sent ones (lost + duplicated)");
+    }
+}
+
+static void check_live(long long live0) {
+    if (Counted::live.load() != live0) fail("live payload balance " + std::to_string(Counted::live.load() - live0) + " after the queue was destroyed");
+}
+
+// One round: every producer sends items_per_producer items, consumers
+// drain them, then a few items are left queued for the destructor.
+// Returns the items delivered.
+template <class T, class Q, unsigned Ops = 0>
+static u64 run_round(Cfg cfg, u64 round) {
+    constexpr ring::OverflowAction kPolicy = OverflowOf<Q>::type::action;
+    constexpr bool kDrops = kPolicy == ring::OverflowAction::DropNewest || kPolicy == ring::OverflowAction::OverwriteOldest;
+    using PBlock = typename ProducerBlockOf<Q, (Ops & kProducerBlocks) != 0>::type;
+    using CBlock = typename ConsumerBlockOf<Q, (Ops & kConsumerBlock) != 0>::type;
+    if constexpr ((Ops & (kProducerBlocks | kConsumerBlock)) != 0) cfg.capacity = std::max<std::size_t>(cfg.capacity, 4);
+
+    const int P = cfg.producers, C = cfg.consumers;
+    // ConsumerBlock::flush re-enqueues at the tail once others took past its run.
+    const bool fifo = (Ops & kNoFifo) == 0 && ((Ops & kConsumerBlock) == 0 || C == 1);
+    const u64 total = cfg.items_per_producer * static_cast<u64>(P);
+    const long long live0 = Counted::live.load();
+    std::vector<Sent> sent(static_cast<std::size_t>(P));
+    std::vector<ConsumerLog> logs(static_cast<std::size_t>(C));
+    u64 delivered = 0, dropped = 0;
+    {
+        const std::unique_ptr<Q> queue = make_queue<Q>(cfg);
+        Q& q = *queue;
+        std::atomic<bool> go{false};
+        std::atomic<u64> consumed{0};
+        std::atomic<int> producers_done{0};
+
+        std::vector<std::thread> ts;
+        for (int p = 0; p < P; ++p) {
+            ts.emplace_back([&, p] {
+                auto&& tx = producer_side(q, p);
+                Rng rng{seed_of(cfg, round, static_cast<u64>(p))};
+                std::vector<T> buf(kMaxBatch);
+                const u64 tag = static_cast<u64>(p) << kSeqBits;
+                u64 seq = 0;
+                Sent s;
+                int spins = 0;
+                std::optional<PBlock> blk;
+                while (!go.load(std::memory_order_acquire)) {}
+                while (seq < cfg.items_per_producer) {
+                    jitter(rng);
+                    const u64 r = rng();
+                    if constexpr ((Ops & kProducerBlocks) != 0) {
+                        // Plain calls only while no block is open: they would pass its unfilled tickets.
+                        if (!blk && (r >> 32) % 8 == 0) blk.emplace(q, static_cast<std::size_t>(1 + (r >> 40) % kMaxBatch));
+                        if (blk) {
+                            while (!blk->try_enqueue(T(tag | seq))) relax(spins);
+                            s.add(seq++);
+                            if ((r >> 48) % 16 == 0) blk->flush();     // rewinds tail_ or leaves skip tickets
+                            else if ((r >> 52) % 32 == 0) blk.reset(); // the destructor flushes
+                            continue;
+                        }
+                    }
+                    const std::size_t n = static_cast<std::size_t>(std::min<u64>(1 + (r >> 8) % kMaxBatch, cfg.items_per_producer - seq));
+                    if constexpr ((Ops & kZeroCopy) != 0) {
+                        if ((r >> 32) % 4 == 0) {
+                            std::size_t placed = 0;
+                            while (placed < n) {
+                                const auto span = tx.reserve(n - placed);
+                                for (std::size_t k = 0; k < span.size(); ++k) new (span[k]) T(tag | (seq + placed + k));
+                                tx.commit(span);
+                                placed += span.size();
+                                if (placed < n) relax(spins);
+                            }
+                            for (std::size_t k = 0; k < n; ++k) s.add(seq + k);
+                            seq += n;
+                            continue;
+                        }
+                    }
+                    if ((r & 3) == 0) {
+                        while (!tx.try_enqueue(T(tag | seq))) relax(spins);
+                        s.add(seq++);
+                        continue;
+                    }
+                    if ((r & 3) == 1) {
+                        bool ok = enqueue_one(tx, T(tag | seq));
+                        if constexpr (kPolicy == ring::OverflowAction::Fail) {
+                            while (!ok) { relax(spins); ok = enqueue_one(tx, T(tag | seq)); }
+                        }
+                        if (ok) s.add(seq); // else DropNewest turned it away
+                        ++seq;
+                        continue;
+                    }
+                    for (std::size_t k = 0; k < n; ++k) buf[k] = T(tag | (seq + k));
+                    std::size_t placed = 0;
+                    for (;;) {
+                        placed += (r & 3) == 2 ? tx.try_enqueue_many(buf.data() + placed, n - placed)
+                                               : tx.enqueue_many(buf.data() + placed, n - placed);
+                        if (placed == n) break;
+                        if ((r & 3) == 3 && kPolicy == ring::OverflowAction::DropNewest) break; // the rest was dropped
+                        relax(spins);
+                    }
+                    for (std::size_t k = 0; k < placed; ++k) s.add(seq + k);
+                    seq += n;
+                }
+                blk.reset();
+                sent[static_cast<std::size_t>(p)] = s;
+                producers_done.fetch_add(1, std::memory_order_release);
+            });
+        }
+        for (int c = 0; c < C; ++c) {
+            ts.emplace_back([&, c] {
+                auto&& rx = consumer_side(q, c);
+                Rng rng{seed_of(cfg, round, static_cast<u64>(P + c))};
+                ConsumerLog& log = logs[static_cast<std::size_t>(c)];
+                log.reset(P);
+                std::vector<T> out(kMaxBatch);
+                int spins = 0;
+                std::optional<CBlock> blk;
+                auto take = [&](const T& x) { log.take(cfg, c, value_of(x), fifo); };
+                while (!go.load(std::memory_order_acquire)) {}
+                for (;;) {
+                    // A lossy ring is drained once a call finds nothing after the last producer finished.
+                    const bool last = kDrops && producers_done.load(std::memory_order_acquire) == P;
+                    if (!kDrops && consumed.load(std::memory_order_relaxed) >= total) break;
+                    jitter(rng);
+                    const u64 r = rng();
+                    std::size_t got = 0;
+                    bool done = false;
+                    if constexpr ((Ops & kConsumerBlock) != 0) {
+                        if (c == 0 && !blk && (r >> 32) % 8 == 0) blk.emplace(q, static_cast<std::size_t>(1 + (r >> 40) % kMaxBatch));
+                        if (blk) {
+                            T x;
+                            if (blk->try_dequeue(x)) { take(x); got = 1; }
+                            if ((r >> 48) % 16 == 0) blk->flush();     // rewinds head_ or re-enqueues the rest
+                            else if ((r >> 52) % 32 == 0) blk.reset(); // the destructor flushes
+                            done = true;
+                        }
+                    }
+                    if constexpr ((Ops & kZeroCopy) != 0) {
+                        if (!done && (r >> 32) % 4 == 0) {
+                            const auto span = rx.peek(static_cast<std::size_t>(1 + (r >> 8) % kMaxBatch));
+                            for (std::size_t k = 0; k < span.size(); ++k) take(*span[k]);
+                            rx.release(span);
+                            got = span.size();
+                            done = true;
+                        }
+                    }
+                    if (!done) {
+                        if (r % 3 == 0) {
+                            T x;
+                            if (rx.try_dequeue(x)) { take(x); got = 1; }
+                        } else if (r % 3 == 1) {
+                            T x;
+                            if (rx.dequeue_for(x, 1ms)) { take(x); got = 1; }
+                        } else {
+                            got = rx.dequeue_many(out.data(), static_cast<std::size_t>(1 + (r >> 8) % kMaxBatch));
+                            for (std::size_t k = 0; k < got; ++k) take(out[k]);
+                        }
+                    }
+                    if (got) consumed.fetch_add(got, std::memory_order_relaxed);
+                    else if (last) break;
+                    else relax(spins);
+                }
+                blk.reset();
+            });
+        }
+
+        go.store(true, std::memory_order_release);
+        for (auto& t : ts) t.join();
+
+        T x;
+        if (q.try_dequeue(x)) fail("item dequeued after all were consumed");
+        delivered = consumed.load();
+        if constexpr (kDrops) dropped = q.stats().dropped;
+        // Leave items behind: the queue destructor must destroy them.
+        auto&& tx = producer_side(q, 0);
+        for (std::size_t k = 0; k < std::min<std::size_t>(cfg.capacity / 2, 100); ++k) {
+            if (!tx.try_enqueue(T(k))) fail("leftover enqueue into an empty queue failed");
+        }
+    }
+
+    if constexpr (kPolicy == ring::OverflowAction::OverwriteOldest) {
+        // Evictions hit any producer; only the totals must add up.
+        u64 sent_total = 0;
+        for (const Sent& s : sent) sent_total += s.count;
+        if (delivered + dropped != sent_total) {
+            fail(std::to_string(delivered) + " delivered + " + std::to_string(dropped) + " overwritten != " + std::to_string(sent_total) + " sent");
+        }
+    } else {
+        check_exactly_once(logs, sent);
+        if constexpr (kPolicy == ring::OverflowAction::DropNewest) {
+            if (delivered + dropped != total) fail(std::to_string(delivered) + " delivered + " + std::to_string(dropped) + " dropped != " + std::to_string(total) + " sent");
+        }
+    }
+    check_live(live0);
+    return delivered;
+}
+
+// One writer, every consumer a reader that must see the whole stream in
+// order (under OverwriteOldest: all of it but what lost(r) reports).
+template <class T, class Overflow>
+static u64 run_broadcast(Cfg cfg, u64 round) {
+    constexpr ring::OverflowAction kPolicy = Overflow::action;
+    constexpr bool kLapped = kPolicy == ring::OverflowAction::OverwriteOldest;
+    const int R = cfg.consumers;
+    const long long live0 = Counted::live.load();
+    std::vector<Sent> sent(1);
+    std::vector<ConsumerLog> logs(static_cast<std::size_t>(R));
+    std::vector<u64> lost(static_cast<std::size_t>(R), 0);
+    u64 dropped = 0;
+    {
+        ring::BroadcastRing<T, ring::DefaultBackoff, ring::RingStats<>, Overflow> q(cfg.capacity, static_cast<std::size_t>(R));
+        std::atomic<bool> go{false}, written{false};
+
+        std::vector<std::thread> ts;
+        ts.emplace_back([&] {
+            Rng rng{seed_of(cfg, round, 0)};
+            std::vector<T> buf(kMaxBatch);
+            u64 seq = 0;
+            Sent s;
+            int spins = 0;
+            while (!go.load(std::memory_order_acquire)) {}
+            while (seq < cfg.items_per_producer) {
+                jitter(rng);
+                const u64 r = rng();
+                if ((r & 3) == 0) {
+                    while (!q.try_publish(T(seq))) relax(spins);
+                    s.add(seq++);
+                    continue;
+                }
+                if ((r & 3) == 1) {
+                    bool ok = q.publish(T(seq));
+                    if constexpr (kPolicy == ring::OverflowAction::Fail) {
+                        while (!ok) { relax(spins); ok = q.publish(T(seq)); }
+                    }
+                    if (ok) s.add(seq);
+                    ++seq;
+                    continue;
+                }
+                const std::size_t n = static_cast<std::size_t>(std::min<u64>(1 + (r >> 8) % kMaxBatch, cfg.items_per_producer - seq));
+                for (std::size_t k = 0; k < n; ++k) buf[k] = T(seq + k);
+                std::size_t placed = 0;
+                for (;;) {
+                    placed += (r & 3) == 2 ? q.try_publish_many(buf.data() + placed, n - placed)
+                                           : q.publish_many(buf.data() + placed, n - placed);
+                    if (placed == n) break;
+                    if ((r & 3) == 3 && kPolicy == ring::OverflowAction::DropNewest) break;
+                    relax(spins);
+                }
+                for (std::size_t k = 0; k < placed; ++k) s.add(seq + k);
+                seq += n;
+            }
+            sent[0] = s;
+            written.store(true, std::memory_order_release);
+        });
+        for (int c = 0; c < R; ++c) {
+            ts.emplace_back([&, c] {
+                const std::size_t rd = static_cast<std::size_t>(c);
+                Rng rng{seed_of(cfg, round, static_cast<u64>(1 + c))};
+                ConsumerLog& log = logs[rd];
+                log.reset(1);
+                std::vector<T> out(kMaxBatch);
+                int spins = 0;
+                auto take = [&](const T& x) { log.take(cfg, c, value_of(x), true); };
+                while (!go.load(std::memory_order_acquire)) {}
+                for (;;) {
+                    const bool last = written.load(std::memory_order_acquire);
+                    jitter(rng);
+                    const u64 r = rng();
+                    const std::size_t n = static_cast<std::size_t>(1 + (r >> 8) % kMaxBatch);
+                    std::size_t got = 0;
+                    if ((r & 3) == 0) {
+                        T x;
+                        if (q.try_read(rd, x)) { take(x); got = 1; }
+                    } else if ((r & 3) == 1) {
+                        // Blocking only while the writer still owes this reader an item.
+                        T x;
+                        if (!last && kPolicy == ring::OverflowAction::Block && log.count[0] < cfg.items_per_producer) {
+                            q.read(rd, x);
+                            take(x);
+                            got = 1;
+                        } else if (q.try_read(rd, x)) {
+                            take(x);
+                            got = 1;
+                        }
+                    } else if ((r & 3) == 2) {
+                        got = q.read_many(rd, out.data(), n);
+                        for (std::size_t k = 0; k < got; ++k) take(out[k]);
+                    } else {
+                        got = q.poll(rd, take, n);
+                    }
+                    if (got) continue;
+                    if (last) break;
+                    relax(spins);
+                }
+                lost[rd] = q.lost(rd);
+            });
+        }
+
+        go.store(true, std::memory_order_release);
+        for (auto& t : ts) t.join();
+
+        for (std::size_t rd = 0; rd < static_cast<std::size_t>(R); ++rd) {
+            if (q.backlog(rd)) fail("reader " + std::to_string(rd) + " left " + std::to_string(q.backlog(rd)) + " items unread");
+        }
+        dropped = q.stats().dropped;
+        // Leave items behind: the ring destructor must destroy them.
+        for (std::size_t k = 0; k < std::min<std::size_t>(cfg.capacity / 2, 100); ++k) {
+            if (!q.try_publish(T(k))) fail("leftover publish into a drained ring failed");
+        }
+    }
+
+    u64 lost_total = 0;
+    for (int c = 0; c < R; ++c) {
+        const std::size_t rd = static_cast<std::size_t>(c);
+        const std::vector<ConsumerLog> one{ logs[rd] };
+        if constexpr (kLapped) {
+            if (logs[rd].count[0] + lost[rd] != sent[0].count) {
+                fail("reader " + std::to_string(c) + ": " + std::to_string(logs[rd].count[0]) + " read + " + std::to_string(lost[rd]) +
+                     " lost != " + std::to_string(sent[0].count) + " published");
+            }
+        } else {
+            check_exactly_once(one, sent);
+        }
+        lost_total += lost[rd];
+    }
+    if constexpr (kLapped) {
+        if (dropped != lost_total) fail("dropped counter " + std::to_string(dropped) + " != " + std::to_string(lost_total) + " items lost by readers");
+    } else if constexpr (kPolicy == ring::OverflowAction::DropNewest) {
+        if (dropped + sent[0].count != cfg.items_per_producer) fail(std::to_string(dropped) + " dropped + " + std::to_string(sent[0].count) + " published != " + std::to_string(cfg.items_per_producer) + " sent");
+    }
+    check_live(live0);
+    return sent[0].count * static_cast<u64>(R) - lost_total;
+}
+
+// Byte-ring records: the item, then filler bytes derived from it, so a
+// torn or misplaced record fails the content check.
+static constexpr std::size_t kMaxFiller = 40;
+
+static std::size_t filler_of(u64 v) { return static_cast<std::size_t>(mix(v) % (kMaxFiller + 1)); }
+static std::byte filler_byte(u64 v, std::size_t k) { return static_cast<std::byte>((mix(v) >> (8 * (k & 7))) ^ k); }
+
+static std::size_t record_size(u64 v) { return sizeof(u64) + filler_of(v); }
+
+static void encode(u64 v, std::byte* out) {
+    std::memcpy(out, &v, sizeof v);
+    for (std::size_t k = 0; k < filler_of(v); ++k) out[sizeof v + k] = filler_byte(v, k);
+}
+
+static u64 decode(const ring::ByteRecord& rec) {
+    u64 v = 0;
+    if (rec.size < sizeof v) fail("record of " + std::to_string(rec.size) + " bytes");
+    std::memcpy(&v, rec.data, sizeof v);
+    if (rec.size != record_size(v)) fail("record of " + std::to_string(rec.size) + " bytes for item " + std::to_string(v));
+    for (std::size_t k = 0; k < filler_of(v); ++k) {
+        if (rec.data[sizeof v + k] != filler_byte(v, k)) fail("record of item " + std::to_string(v) + " corrupted at byte " + std::to_string(sizeof v + k));
+    }
+    return v;
+}
+
+template <class Q>
+static u64 run_bytes(Cfg cfg, u64 round) {
+    const int P = cfg.producers, C = cfg.consumers;
+    const u64 total = cfg.items_per_producer * static_cast<u64>(P);
+    std::vector<Sent> sent(static_cast<std::size_t>(P));
+    std::vector<ConsumerLog> logs(static_cast<std::size_t>(C));
+    {
+        Q q(std::max<std::size_t>(cfg.capacity * 16, 256));
+        std::atomic<bool> go{false};
+        std::atomic<u64> consumed{0};
+
+        std::vector<std::thread> ts;
+        for (int p = 0; p < P; ++p) {
+            ts.emplace_back([&, p] {
+                Rng rng{seed_of(cfg, round, static_cast<u64>(p))};
+                std::byte rec[sizeof(u64) + kMaxFiller];
+                const u64 tag = static_cast<u64>(p) << kSeqBits;
+                u64 seq = 0;
+                Sent s;
+                int spins = 0;
+                while (!go.load(std::memory_order_acquire)) {}
+                while (seq < cfg.items_per_producer) {
+                    jitter(rng);
+                    const u64 r = rng(), v = tag | seq;
+                    const std::size_t size = record_size(v);
+                    if (r % 3 == 0) {
+                        encode(v, rec);
+                        while (!q.try_write(rec, size)) relax(spins);
+                    } else if (r % 3 == 1) {
+                        encode(v, rec);
+                        if (!q.write(rec, size)) fail("write refused a " + std::to_string(size) + "-byte record");
+                    } else {
+                        ring::ByteReservation res;
+                        while (!(res = q.reserve(size))) relax(spins);
+                        encode(v, res.data);
+                        q.commit(res);
+                    }
+                    s.add(seq++);
+                }
+                sent[static_cast<std::size_t>(p)] = s;
+            });
+        }
+        for (int c = 0; c < C; ++c) {
+            ts.emplace_back([&, c] {
+                Rng rng{seed_of(cfg, round, static_cast<u64>(P + c))};
+                ConsumerLog& log = logs[static_cast<std::size_t>(c)];
+                log.reset(P);
+                int spins = 0;
+                auto take = [&](const ring::ByteRecord& rec) { log.take(cfg, c, decode(rec), true); };
+                while (!go.load(std::memory_order_acquire)) {}
+                while (consumed.load(std::memory_order_relaxed) < total) {
+                    jitter(rng);
+                    const u64 r = rng();
+                    std::size_t got = 0;
+                    if ((r & 3) == 0) {
+                        got = q.try_read(take) ? 1 : 0;
+                    } else if ((r & 3) == 1) {
+                        got = q.consume(take, static_cast<std::size_t>(1 + (r >> 8) % kMaxBatch));
+                    } else if ((r & 3) == 2) {
+                        if (const ring::ByteRecord rec = q.peek()) { take(rec); q.release(rec); got = 1; }
+                    } else if (C == 1) { // a lone consumer is owed every record still unread
+                        q.read(take);
+                        got = 1;
+                    } else {
+                        got = q.try_read(take) ? 1 : 0;
+                    }
+                    if (got) consumed.fetch_add(got, std::memory_order_relaxed);
+                    else relax(spins);
+                }
+            });
+        }
+
+        go.store(true, std::memory_order_release);
+        for (auto& t : ts) t.join();
+
+        if (q.peek()) fail("record read after all were consumed");
+    }
+    check_exactly_once(logs, sent);
+    return total;
+}
+
+struct Variant {
+    const char* name;
+    int producers, consumers; // fixed thread counts; 0 = as configured
+    u64 (*run)(Cfg, u64);
+};
+
+template <class T, template <class, class> class Ring, class Layout, unsigned Ops = 0>
+static u64 run_variant(Cfg cfg, u64 round) { return run_round<T, Ring<T, Layout>, Ops>(cfg, round); }
+
+template <class T, class L> using SPSC   = ring::RingSPSC<T, L>;
+template <class T, class L> using MPMC   = ring::RingMPMC<T, L>;
+template <class T, class L> using Linked = ring::LinkedRingMPMC<T, L>;
+template <class T, class L> using FanIn  = ring::FanInRing<T, L>;
+
+template <class T, class L> using MPMCFail      = ring::RingMPMC<T, L, ring::DefaultBackoff, ring::RingStats<>, ring::FailOnFull>;
+template <class T, class L> using MPMCDrop      = ring::RingMPMC<T, L, ring::DefaultBackoff, ring::RingStats<>, ring::DropNewest>;
+template <class T, class L> using MPMCOverwrite = ring::RingMPMC<T, L, ring::DefaultBackoff, ring::RingStats<>, ring::OverwriteOldest>;
+
+// PriorityRing with producer p pinned to lane p % lanes (FIFO holds per
+// lane); even consumers drain Strict, odd ones weighted round robin.
+template <class T, class L>
+class Priority : public ring::PriorityRing<T, 4, L> {
+    using base = ring::PriorityRing<T, 4, L>;
+
+public:
+    explicit Priority(std::size_t capacity) : base(capacity, {4, 3, 2, 1}) {}
+
+    struct Producer {
+        base& q;
+        std::size_t lane;
+        bool try_enqueue(const T& v) noexcept { return q.try_enqueue(lane, v); }
+        bool enqueue(const T& v) noexcept { return q.enqueue(lane, v); }
+        std::size_t try_enqueue_many(const T* data, std::size_t n) noexcept { return q.try_enqueue_many(lane, data, n); }
+        std::size_t enqueue_many(const T* data, std::size_t n) noexcept { return q.enqueue_many(lane, data, n); }
+    };
+
+    struct Consumer {
+        base& q;
+        ring::DrainOrder order;
+        bool try_dequeue(T& out) noexcept { return q.try_dequeue(out, order); }
+        template <class Rep, class Period>
+        bool dequeue_for(T& out, const std::chrono::duration<Rep, Period>& timeout) noexcept { return q.dequeue_for(out, timeout, order); }
+        std::size_t dequeue_many(T* out, std::size_t n) noexcept { return q.dequeue_many(out, n, order); }
+    };
+
+    Producer producer(std::size_t p) noexcept { return { *this, p % base::lanes }; }
+    Consumer consumer(std::size_t c) noexcept { return { *this, c % 2 ? ring::DrainOrder::WeightedRoundRobin : ring::DrainOrder::Strict }; }
+};
+
+// ShardedRing over two shards of half the capacity; producers and
+// consumers start at shard p % 2 / c % 2. It has no waiting calls, so the
+// blocking and timed ones are spun here.
+template <class T, class L>
+class Sharded : public ring::ShardedRing<T, L> {
+    using base = ring::ShardedRing<T, L>;
+
+public:
+    explicit Sharded(std::size_t capacity) : base(std::max<std::size_t>(capacity / 2, 2), std::vector<int>(2, 0)) {}
+
+    struct Producer {
+        base& q;
+        std::size_t home;
+        bool try_enqueue(const T& v) noexcept { return q.try_enqueue(home, v); }
+        bool enqueue(const T& v) noexcept {
+            while (!q.try_enqueue(home, v)) std::this_thread::yield();
+            return true;
+        }
+        std::size_t try_enqueue_many(const T* data, std::size_t n) noexcept { return q.try_enqueue_many(home, data, n); }
+        std::size_t enqueue_many(const T* data, std::size_t n) noexcept {
+            std::size_t done = q.try_enqueue_many(home, data, n);
+            while (done < n) { std::this_thread::yield(); done += q.try_enqueue_many(home, data + done, n - done); }
+            return done;
+        }
+    };
+
+    struct Consumer {
+        base& q;
+        std::size_t home;
+        bool try_dequeue(T& out) noexcept { return q.try_dequeue(home, out); }
+        template <class Rep, class Period>
+        bool dequeue_for(T& out, const std::chrono::duration<Rep, Period>& timeout) noexcept {
+            const auto deadline = SteadyClock::now() + timeout;
+            while (!q.try_dequeue(home, out)) {
+                if (SteadyClock::now() >= deadline) return false;
+                std::this_thread::yield();
+            }
+            return true;
+        }
+        std::size_t dequeue_many(T* out, std::size_t n) noexcept { return q.dequeue_many(home, out, n); }
+    };
+
+    Producer producer(std::size_t p) noexcept { return { *this, p % this->shard_count() }; }
+    Consumer consumer(std::size_t c) noexcept { return { *this, c % this->shard_count() }; }
+};
+
+static const Variant kVariants[] = {
+    { "spsc/padded/u64",             1, 1, run_variant<u64, SPSC, ring::PaddedLayout> },
+    { "spsc/split/u64",              1, 1, run_variant<u64, SPSC, ring::SplitLayout> },
+    { "spsc/packed/counted",         1, 1, run_variant<Counted, SPSC, ring::PackedLayout> },
+    { "spsc/split/u64/zero-copy",    1, 1, run_variant<u64, SPSC, ring::SplitLayout, kZeroCopy> },
+    { "spsc/padded/counted/zero-copy", 1, 1, run_variant<Counted, SPSC, ring::PaddedLayout, kZeroCopy> },
+    { "mpmc/padded/u64",             0, 0, run_variant<u64, MPMC, ring::PaddedLayout> },
+    { "mpmc/packed/u64",             0, 0, run_variant<u64, MPMC, ring::PackedLayout> },
+    { "mpmc/split/u64",              0, 0, run_variant<u64, MPMC, ring::SplitLayout> },
+    { "mpmc/padded/counted",         0, 0, run_variant<Counted, MPMC, ring::PaddedLayout> },
+    { "mpmc/split/counted",          0, 0, run_variant<Counted, MPMC, ring::SplitLayout> },
+    { "mpmc/split/u64/zero-copy",    0, 0, run_variant<u64, MPMC, ring::SplitLayout, kZeroCopy> },
+    { "mpmc/padded/counted/zero-copy", 0, 0, run_variant<Counted, MPMC, ring::PaddedLayout, kZeroCopy> },
+    { "mpmc/padded/u64/pblocks",     0, 0, run_variant<u64, MPMC, ring::PaddedLayout, kProducerBlocks> },
+    { "mpmc/split/counted/pblocks",  0, 0, run_variant<Counted, MPMC, ring::SplitLayout, kProducerBlocks> },
+    { "mpmc/packed/u64/blocks",      0, 0, run_variant<u64, MPMC, ring::PackedLayout, kProducerBlocks | kConsumerBlock> },
+    { "mpmc/padded/counted/blocks",  0, 0, run_variant<Counted, MPMC, ring::PaddedLayout, kProducerBlocks | kConsumerBlock | kZeroCopy> },
+    { "mpmc/split/u64/blocks-1c",    0, 1, run_variant<u64, MPMC, ring::SplitLayout, kProducerBlocks | kConsumerBlock> },
+    { "mpmc/padded/u64/fail",        0, 0, run_variant<u64, MPMCFail, ring::PaddedLayout, kZeroCopy> },
+    { "mpmc/split/counted/drop",     0, 0, run_variant<Counted, MPMCDrop, ring::SplitLayout> },
+    { "mpmc/padded/u64/overwrite",   0, 0, run_variant<u64, MPMCOverwrite, ring::PaddedLayout> },
+    { "mpmc/split/counted/overwrite", 0, 0, run_variant<Counted, MPMCOverwrite, ring::SplitLayout> },
+    { "linked/padded/u64",           0, 0, run_variant<u64, Linked, ring::PaddedLayout> },
+    { "linked/split/counted",        0, 0, run_variant<Counted, Linked, ring::SplitLayout> },
+    { "fanin/padded/u64",            0, 1, run_variant<u64, FanIn, ring::PaddedLayout> },
+    { "fanin/split/counted",         0, 1, run_variant<Counted, FanIn, ring::SplitLayout> },
+    { "priority/padded/u64",         0, 0, run_variant<u64, Priority, ring::PaddedLayout> },
+    { "priority/split/counted",      0, 0, run_variant<Counted, Priority, ring::SplitLayout> },
+    { "sharded/padded/u64",          0, 0, run_variant<u64, Sharded, ring::PaddedLayout, kNoFifo> },
+    { "sharded/split/counted",       0, 0, run_variant<Counted, Sharded, ring::SplitLayout, kNoFifo> },
+    { "broadcast/u64",               1, 0, run_broadcast<u64, ring::BlockOnFull> },
+    { "broadcast/counted",           1, 0, run_broadcast<Counted, ring::BlockOnFull> },
+    { "broadcast/u64/fail",          1, 0, run_broadcast<u64, ring::FailOnFull> },
+    { "broadcast/counted/drop",      1, 0, run_broadcast<Counted, ring::DropNewest> },
+    { "broadcast/u64/overwrite",     1, 0, run_broadcast<u64, ring::OverwriteOldest> },
+    { "bytes/spsc",                  1, 1, run_bytes<ring::ByteRingSPSC<>> },
+    { "bytes/mpmc",                  0, 0, run_bytes<ring::ByteRingMPMC<>> },
+};
+
+int main(int argc, char** argv) {
+    // Args: [items_per_producer] [producers] [consumers] [capacity] [seed] [minutes] [variant]
+    Cfg cfg;
+    if (argc > 1) cfg.items_per_producer = parse_u64(argv[1], cfg.items_per_producer);
+    if (argc > 2) cfg.producers          = (int)parse_u64(argv[2], cfg.producers);
+    if (argc > 3) cfg.consumers          = (int)parse_u64(argv[3], cfg.consumers);
+    if (argc > 4) cfg.capacity           = (std::size_t)parse_u64(argv[4], cfg.capacity);
+    if (argc > 5) cfg.seed               = parse_u64(argv[5], cfg.seed);
+    if (argc > 6) cfg.minutes            = parse_u64(argv[6], cfg.minutes);
+    if (argc > 7) cfg.only               = argv[7];
+    cfg.producers = std::clamp(cfg.producers, 1, 1 << 15);
+    cfg.consumers = std::max(cfg.consumers, 1);
+    cfg.capacity  = std::max<std::size_t>(cfg.capacity, 2);
+    cfg.items_per_producer = std::clamp<u64>(cfg.items_per_producer, 1, kSeqMask);
+
+    std::cout << "Stress test config:\n"
+              << "  items_per_producer = " << cfg.items_per_producer << "\n"
+              << "  producers          = " << cfg.producers << "\n"
+              << "  consumers          = " << cfg.consumers << "\n"
+              << "  queue_capacity     = " << cfg.capacity << "\n"
+              << "  seed               = " << cfg.seed << "\n"
+              << "  minutes (0=once)   = " << cfg.minutes << "\n"
+              << "  variants           = " << (cfg.only.empty() ? "all" : cfg.only) << "\n";
+
+    const auto t0 = SteadyClock::now();
+    const auto deadline = t0 + std::chrono::minutes(cfg.minutes);
+    u64 rounds = 0, items = 0;
+    bool ran = false;
+    do {
+        for (const Variant& v : kVariants) {
+            if (!cfg.only.empty() && std::string(v.name).find(cfg.only) == std::string::npos) continue;
+            Cfg c = cfg;
+            if (v.producers) c.producers = v.producers;
+            if (v.consumers) c.consumers = v.consumers;
+            g_variant = v.name;
+            g_seed = cfg.seed;
+            const auto r0 = SteadyClock::now();
+            const u64 n = v.run(c, rounds);
+            const double secs = std::chrono::duration<double>(SteadyClock::now() - r0).count();
+            items += n;
+            ran = true;
+            if (cfg.minutes == 0 || rounds == 0) {
+                std::cout << "  " << std::left << std::setw(30) << v.name << std::right << c.producers << "P/" << c.consumers << "C "
+                          << std::setw(10) << n << " items  " << std::fixed << std::setprecision(3) << secs << " s\n";
+            }
+        }
+        ++rounds;
+        if (cfg.minutes > 0) {
+            std::cout << "  round " << rounds << " ok (" << items << " items, "
+                      << std::chrono::duration_cast<std::chrono::seconds>(SteadyClock::now() - t0).count() << " s)\n";
+        }
+    } while (ran && cfg.minutes > 0 && SteadyClock::now() < deadline);
+
+    if (!ran) { std::cerr << "no variant matches '" << cfg.only << "'\n"; return 2; }
+    std::cout << "PASS: FIFO per producer, exactly-once and payload lifetimes over " << rounds << " round(s), " << items << " items.\n";
+    return 0;
+}